@@ -0,0 +1,84 @@
+/**
+ * @file bench_batch.c
+ * @brief Бенчмарк пропускної здатності пакетної публікації при різних розмірах пачки.
+ *
+ * Пачка розміру 1 публікується через eventbus_publish, більші – через eventbus_publish_batch.
+ */
+
+#include "eventbus.h"
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_EVENTS_TOTAL (2u * 1024u * 1024u)
+#define BENCH_MAX_BATCH 512
+
+static EVENTBUS_ATOMIC(size_t) received;
+
+static void count_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add_explicit(&received, 1, memory_order_relaxed);
+}
+
+static double now_sec(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double run(size_t batch)
+{
+  static Event events[BENCH_MAX_BATCH];
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.queue_size = 2048;
+  EventBus *bus = eventbus_create(cfg);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, count_callback);
+  atomic_store(&received, 0);
+
+  for (size_t i = 0; i < batch; i++)
+  {
+    events[i].type = event_type(1, 1);
+    events[i].priority = event_priority_normal;
+    events[i].input = create_event_input_data(NULL, 0);
+    events[i].result = create_event_result();
+  }
+
+  double start = now_sec();
+  for (size_t sent = 0; sent < BENCH_EVENTS_TOTAL; sent += batch)
+  {
+    if (batch == 1)
+    {
+      while (eventbus_publish(bus, events[0].type, events[0].input, events[0].result) != 0)
+        sched_yield();
+      continue;
+    }
+    size_t done = 0;
+    while (done < batch)
+    {
+      size_t n = eventbus_publish_batch(bus, events + done, batch - done);
+      if (n == 0)
+        sched_yield();
+      done += n;
+    }
+  }
+  while (atomic_load(&received) < BENCH_EVENTS_TOTAL)
+    sched_yield();
+  double elapsed = now_sec() - start;
+
+  eventbus_stop(bus);
+  free(bus);
+  return BENCH_EVENTS_TOTAL / elapsed;
+}
+
+int main(void)
+{
+  static const size_t batches[] = {1, 8, 32, 128, BENCH_MAX_BATCH};
+
+  printf("%-8s %12s\n", "batch", "events/s");
+  for (size_t i = 0; i < sizeof(batches) / sizeof(batches[0]); i++)
+    printf("%-8zu %12.0f\n", batches[i], run(batches[i]));
+  return 0;
+}
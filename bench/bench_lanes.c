@@ -0,0 +1,109 @@
+/**
+ * @file bench_lanes.c
+ * @brief Бенчмарк затримки подій високого пріоритету, коли черга заповнена масовими подіями.
+ *
+ * Окремий потік тримає чергу заповненою подіями event_priority_low (політика event_overflow_block),
+ * а основний потік періодично публікує подію event_priority_high і вимірює час до входу в її callback.
+ * Порівнюються одна смуга (високий пріоритет стоїть у загальній черзі) та три смуги.
+ */
+
+#include "eventbus.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_SAMPLES 2000
+#define BENCH_QUEUE_SIZE 4096
+
+static EVENTBUS_ATOMIC(uint64_t) callback_ns;
+static EVENTBUS_ATOMIC(bool) flooding;
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void bulk_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  // Імітація невеликої роботи над масовою подією
+  uint64_t until = now_ns() + 2000;
+  while (now_ns() < until)
+    ;
+}
+
+static void control_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_store_explicit(&callback_ns, now_ns(), memory_order_release);
+}
+
+static void *flood_thread(void *arg)
+{
+  EventBus *bus = (EventBus *)arg;
+  EventInputData input = create_event_input_data(NULL, 0);
+  EventResultData result = create_event_result();
+  while (atomic_load(&flooding))
+    eventbus_publish_priority(bus, event_type(1, 1), event_priority_low, input, result);
+  return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static void run(uint8_t lane_count)
+{
+  static uint64_t samples[BENCH_SAMPLES];
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.queue_size = BENCH_QUEUE_SIZE;
+  cfg.lane_count = lane_count;
+  cfg.overflow_policy = event_overflow_block;
+  EventBus *bus = eventbus_create(cfg);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, bulk_callback);
+  eventbus_subscribe(bus, event_type(1, 2), 0, NULL, control_callback);
+  EventInputData input = create_event_input_data(NULL, 0);
+  EventResultData result = create_event_result();
+
+  atomic_store(&flooding, true);
+  pthread_t flood;
+  pthread_create(&flood, NULL, flood_thread, bus);
+  struct timespec pause = {0, 200000};
+  nanosleep(&pause, NULL);
+
+  for (size_t i = 0; i < BENCH_SAMPLES; i++)
+  {
+    atomic_store(&callback_ns, 0);
+    uint64_t start = now_ns();
+    eventbus_publish_priority(bus, event_type(1, 2), event_priority_high, input, result);
+    uint64_t stamp;
+    while ((stamp = atomic_load_explicit(&callback_ns, memory_order_acquire)) == 0)
+      nanosleep(&pause, NULL);
+    samples[i] = stamp - start;
+  }
+
+  atomic_store(&flooding, false);
+  pthread_join(flood, NULL);
+  eventbus_stop(bus);
+  free(bus);
+
+  qsort(samples, BENCH_SAMPLES, sizeof(uint64_t), cmp_u64);
+  printf("%5u %12llu %12llu %12llu\n", lane_count,
+         (unsigned long long)samples[BENCH_SAMPLES / 2] / 1000,
+         (unsigned long long)samples[BENCH_SAMPLES * 99 / 100] / 1000,
+         (unsigned long long)samples[BENCH_SAMPLES - 1] / 1000);
+}
+
+int main(void)
+{
+  printf("%5s %12s %12s %12s\n", "lanes", "p50 us", "p99 us", "max us");
+  run(1);
+  run(3);
+  return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file bench_payload.c
+ * @brief Бенчмарк виділень пам’яті на подію: strdup/free, пул даних EventBus та дані в самій події.
+ *
+ * Рахує виклики malloc/free (через підміну символів glibc) під час публікації та обробки
+ * подій з 32-байтними даними і виводить їх кількість на подію разом з пропускною здатністю.
+ */
+
+#include "eventbus.h"
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_EVENTS_TOTAL 1000000u
+#define BENCH_PAYLOAD "0123456789abcdef0123456789abcde"
+
+static EVENTBUS_ATOMIC(size_t) malloc_calls;
+static EVENTBUS_ATOMIC(size_t) free_calls;
+static EVENTBUS_ATOMIC(size_t) received;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t size);
+extern void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+  atomic_fetch_add_explicit(&malloc_calls, 1, memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void free(void *ptr)
+{
+  if (ptr)
+    atomic_fetch_add_explicit(&free_calls, 1, memory_order_relaxed);
+  __libc_free(ptr);
+}
+#endif
+
+static void read_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  volatile char first = ((const char *)evt->input.direct_data)[0];
+  (void)first;
+  atomic_fetch_add_explicit(&received, 1, memory_order_relaxed);
+}
+
+static double now_sec(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef enum
+{
+  BENCH_STRDUP,
+  BENCH_POOL,
+  BENCH_INLINE
+} BenchMode;
+
+static void run(const char *name, BenchMode mode)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.queue_size = 1024;
+  cfg.payload_block_size = sizeof(BENCH_PAYLOAD);
+  cfg.payload_block_count = 2048;
+  EventBus *bus = eventbus_create(cfg);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, read_callback);
+  EventResultData result = create_event_result();
+  atomic_store(&received, 0);
+
+  size_t mallocs = atomic_load(&malloc_calls);
+  size_t frees = atomic_load(&free_calls);
+  double start = now_sec();
+  for (size_t i = 0; i < BENCH_EVENTS_TOTAL; i++)
+  {
+    EventInputData input;
+    if (mode == BENCH_POOL)
+    {
+      void *payload;
+      while ((payload = eventbus_payload_reserve(bus, sizeof(BENCH_PAYLOAD))) == NULL)
+        sched_yield();
+      memcpy(payload, BENCH_PAYLOAD, sizeof(BENCH_PAYLOAD));
+      input = create_event_input_payload(payload, sizeof(BENCH_PAYLOAD));
+    }
+    else if (mode == BENCH_INLINE)
+      input = create_event_input_copy(BENCH_PAYLOAD, sizeof(BENCH_PAYLOAD));
+    else
+      input = create_event_input_data(strdup(BENCH_PAYLOAD), sizeof(BENCH_PAYLOAD));
+    while (eventbus_publish(bus, event_type(1, 1), input, result) != 0)
+      sched_yield();
+  }
+  while (atomic_load(&received) < BENCH_EVENTS_TOTAL)
+    sched_yield();
+  double elapsed = now_sec() - start;
+  mallocs = atomic_load(&malloc_calls) - mallocs;
+  frees = atomic_load(&free_calls) - frees;
+
+  eventbus_stop(bus);
+  free(bus);
+  printf("%-8s %12.0f %12.3f %12.3f\n", name, BENCH_EVENTS_TOTAL / elapsed,
+         (double)mallocs / BENCH_EVENTS_TOTAL, (double)frees / BENCH_EVENTS_TOTAL);
+}
+
+int main(void)
+{
+  printf("%-8s %12s %12s %12s\n", "payload", "events/s", "malloc/evt", "free/evt");
+  run("strdup", BENCH_STRDUP);
+  run("pool", BENCH_POOL);
+  run("inline", BENCH_INLINE);
+  return 0;
+}
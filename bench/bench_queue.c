@@ -0,0 +1,143 @@
+/**
+ * @file bench_queue.c
+ * @brief Бенчмарк конкуренції продюсерів за чергу подій.
+ *
+ * Порівнює lock-free чергу EventBus з попередньою реалізацією (кільцевий буфер під м’ютексом)
+ * при 1, 4 та 16 продюсерах і одному споживачі. Продюсери при переповненні черги поступаються
+ * процесором і повторюють спробу, споживач забирає події, доки не отримає всі.
+ */
+
+#include "eventbus.h"
+#include "eventbus_queue.h"
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_QUEUE_SIZE 1024
+#define BENCH_EVENTS_TOTAL (4u * 1000u * 1000u)
+
+// ==================== Черга під м’ютексом (еталон) ====================
+
+typedef struct
+{
+  Event *queue;
+  size_t size, head, tail;
+  eventbus_mutex_t mutex;
+} MutexQueue;
+
+static int mutex_queue_push(MutexQueue *q, const Event *evt)
+{
+  EVENTBUS_MUTEX_LOCK(&q->mutex);
+  size_t next = (q->tail + 1) % q->size;
+  if (next == q->head)
+  {
+    EVENTBUS_MUTEX_UNLOCK(&q->mutex);
+    return -1;
+  }
+  q->queue[q->tail] = *evt;
+  q->tail = next;
+  EVENTBUS_MUTEX_UNLOCK(&q->mutex);
+  return 0;
+}
+
+static int mutex_queue_pop(MutexQueue *q, Event *evt)
+{
+  EVENTBUS_MUTEX_LOCK(&q->mutex);
+  if (q->head == q->tail)
+  {
+    EVENTBUS_MUTEX_UNLOCK(&q->mutex);
+    return -1;
+  }
+  *evt = q->queue[q->head];
+  q->head = (q->head + 1) % q->size;
+  EVENTBUS_MUTEX_UNLOCK(&q->mutex);
+  return 0;
+}
+
+// ==================== Спільна обв’язка ====================
+
+typedef struct
+{
+  int (*push)(void *q, const Event *evt);
+  int (*pop)(void *q, Event *evt);
+  void *q;
+  size_t events;
+} BenchArgs;
+
+static int lockfree_push(void *q, const Event *evt) { return eventbus_queue_push((EventQueue *)q, evt); }
+static int lockfree_pop(void *q, Event *evt) { return eventbus_queue_pop((EventQueue *)q, evt); }
+static int locked_push(void *q, const Event *evt) { return mutex_queue_push((MutexQueue *)q, evt); }
+static int locked_pop(void *q, Event *evt) { return mutex_queue_pop((MutexQueue *)q, evt); }
+
+static void *producer_func(void *arg)
+{
+  BenchArgs *a = (BenchArgs *)arg;
+  Event evt;
+  evt.type = event_type(1, 1);
+  evt.input = create_event_input_data(NULL, 0);
+  evt.result = create_event_result();
+  for (size_t i = 0; i < a->events; i++)
+  {
+    while (a->push(a->q, &evt) != 0)
+      sched_yield();
+  }
+  return NULL;
+}
+
+static double now_sec(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double run(int (*push)(void *, const Event *), int (*pop)(void *, Event *), void *q, int producers)
+{
+  pthread_t threads[16];
+  BenchArgs args = {push, pop, q, BENCH_EVENTS_TOTAL / producers};
+  size_t total = args.events * producers;
+
+  double start = now_sec();
+  for (int i = 0; i < producers; i++)
+    pthread_create(&threads[i], NULL, producer_func, &args);
+
+  Event evt;
+  for (size_t received = 0; received < total;)
+  {
+    if (pop(q, &evt) == 0)
+      received++;
+    else
+      sched_yield();
+  }
+  for (int i = 0; i < producers; i++)
+    pthread_join(threads[i], NULL);
+  return total / (now_sec() - start);
+}
+
+int main(void)
+{
+  static const int producer_counts[] = {1, 4, 16};
+
+  printf("%-10s %12s %12s %8s\n", "producers", "mutex ev/s", "lockfree ev/s", "speedup");
+  for (size_t i = 0; i < sizeof(producer_counts) / sizeof(producer_counts[0]); i++)
+  {
+    int producers = producer_counts[i];
+
+    MutexQueue mq;
+    mq.size = BENCH_QUEUE_SIZE;
+    mq.head = mq.tail = 0;
+    mq.queue = (Event *)malloc(sizeof(Event) * mq.size);
+    EVENTBUS_MUTEX_INIT(&mq.mutex);
+    double locked = run(locked_push, locked_pop, &mq, producers);
+    EVENTBUS_MUTEX_DESTROY(&mq.mutex);
+    free(mq.queue);
+
+    EventQueue lq;
+    eventbus_queue_init(&lq, BENCH_QUEUE_SIZE, 0, NULL, NULL);
+    double lockfree = run(lockfree_push, lockfree_pop, &lq, producers);
+    eventbus_queue_free(&lq);
+
+    printf("%-10d %12.0f %12.0f %7.2fx\n", producers, locked, lockfree, lockfree / locked);
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file bench_slots.c
+ * @brief Бенчмарк компактних дескрипторів у слотах черги: пам’ять смуги та пропускна здатність.
+ *
+ * Порівнює розмір слоту з повною подією (як до переходу на EventDescriptor) з розміром слоту
+ * з дескриптором і рахує пам’ять смуги з бічною таблицею різного розміру. Пропускна здатність
+ * вимірюється окремо для звичайних подій, що цілком вміщуються в дескриптор, і для подій
+ * з done_fn, які йдуть через бічну таблицю, тобто копіюються цілком, як у слоті з повною подією.
+ */
+
+#include "eventbus.h"
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_EVENTS_TOTAL 2000000u
+#define BENCH_QUEUE_SIZE 1024
+
+static EVENTBUS_ATOMIC(size_t) received;
+
+static void count_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add_explicit(&received, 1, memory_order_relaxed);
+}
+
+static int done_callback(void *context)
+{
+  (void)context;
+  return 0;
+}
+
+static double now_sec(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double run(uint16_t ext_size, bool with_result)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.queue_size = BENCH_QUEUE_SIZE;
+  cfg.queue_ext_size = ext_size;
+  EventBus *bus = eventbus_create(cfg);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, count_callback);
+  atomic_store(&received, 0);
+
+  uint32_t value = 0;
+  double start = now_sec();
+  for (size_t i = 0; i < BENCH_EVENTS_TOTAL; i++)
+  {
+    EventResultData result = create_event_result();
+    if (with_result)
+      result.done_fn = done_callback;
+    value++;
+    while (eventbus_publish(bus, event_type(1, 1), create_event_input_copy(&value, sizeof(value)), result) != 0)
+      sched_yield();
+  }
+  while (atomic_load(&received) < BENCH_EVENTS_TOTAL)
+    sched_yield();
+  double elapsed = now_sec() - start;
+
+  eventbus_stop(bus);
+  free(bus);
+  return BENCH_EVENTS_TOTAL / elapsed;
+}
+
+int main(void)
+{
+  size_t full_slot = sizeof(size_t) + sizeof(Event);
+  printf("slot: full event %zu B, descriptor %zu B\n\n", full_slot, sizeof(EventQueueSlot));
+
+  printf("%-12s %12s %14s %14s\n", "ext entries", "lane KiB", "plain ev/s", "callback ev/s");
+  printf("%-12s %12.1f %14s %14s\n", "full event", full_slot * BENCH_QUEUE_SIZE / 1024.0, "-", "-");
+  const uint16_t ext_sizes[] = {BENCH_QUEUE_SIZE, 64, 8};
+  for (size_t i = 0; i < sizeof(ext_sizes) / sizeof(ext_sizes[0]); i++)
+  {
+    size_t lane = sizeof(EventQueueSlot) * BENCH_QUEUE_SIZE + sizeof(Event) * ext_sizes[i];
+    double plain = run(ext_sizes[i], false);
+    double callback = run(ext_sizes[i], true);
+    printf("%-12u %12.1f %14.0f %14.0f\n", ext_sizes[i], lane / 1024.0, plain, callback);
+  }
+  return 0;
+}
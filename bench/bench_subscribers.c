@@ -0,0 +1,91 @@
+/**
+ * @file bench_subscribers.c
+ * @brief Бенчмарк таблиці підписників на 256, 1024 та 4096 підписниках.
+ *
+ * Вимірюється вартість підписки всіх підписників, відписки з повторною підпискою випадкового
+ * підписника (кожна з них перебудовує таблицю диспетчеризації) та синхронної обробки події.
+ * Підписники: 90 % на точний тип, 9 % на категорію, 1 % на всі події.
+ */
+
+#include "eventbus.h"
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_CHURN 2000
+#define BENCH_EVENTS 200000
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t rng_state = 12345;
+
+static uint32_t rng(void)
+{
+  rng_state = rng_state * 1103515245u + 12345u;
+  return rng_state >> 8;
+}
+
+static void noop_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+}
+
+static EventType random_sub_type(void)
+{
+  uint32_t kind = rng() % 100;
+  if (kind == 0)
+    return event_type(0, 0);
+  if (kind < 10)
+    return event_type((uint8_t)(1 + rng() % 255), 0);
+  return event_type((uint8_t)(1 + rng() % 255), (uint8_t)(1 + rng() % 255));
+}
+
+static void run(uint16_t subs)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.subs_array_size = subs;
+  EventBus *bus = eventbus_create(cfg);
+  EventSubscriber **handles = (EventSubscriber **)malloc(sizeof(EventSubscriber *) * subs);
+
+  uint64_t start = now_ns();
+  for (uint16_t i = 0; i < subs; i++)
+    handles[i] = eventbus_subscribe(bus, random_sub_type(), (uint8_t)(rng() % 16), NULL, noop_callback);
+  uint64_t subscribe_ns = (now_ns() - start) / subs;
+
+  start = now_ns();
+  for (int i = 0; i < BENCH_CHURN; i++)
+  {
+    uint16_t idx = (uint16_t)(rng() % subs);
+    eventbus_unsubscribe(bus, handles[idx]);
+    handles[idx] = eventbus_subscribe(bus, random_sub_type(), (uint8_t)(rng() % 16), NULL, noop_callback);
+  }
+  uint64_t churn_ns = (now_ns() - start) / (2 * BENCH_CHURN);
+
+  EventInputData input = create_event_input_data(NULL, 0);
+  EventResultData result = create_event_result();
+  start = now_ns();
+  for (int i = 0; i < BENCH_EVENTS; i++)
+    eventbus_publish_sync(bus, event_type((uint8_t)(1 + rng() % 255), (uint8_t)(1 + rng() % 255)), input, result);
+  uint64_t dispatch_ns = (now_ns() - start) / BENCH_EVENTS;
+
+  printf("%6u %14llu %14llu %14llu\n", subs, (unsigned long long)subscribe_ns,
+         (unsigned long long)churn_ns, (unsigned long long)dispatch_ns);
+
+  eventbus_stop(bus);
+  free(bus);
+  free(handles);
+}
+
+int main(void)
+{
+  printf("%6s %14s %14s %14s\n", "subs", "subscribe ns", "churn ns/op", "dispatch ns");
+  run(256);
+  run(1024);
+  run(4096);
+  return 0;
+}
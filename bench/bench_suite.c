@@ -0,0 +1,259 @@
+/**
+ * @file bench_suite.c
+ * @brief Зведений бенчмарк EventBus з машинозчитуваним виводом.
+ *
+ * Сценарії:
+ * - throughput: пропускна здатність одного продюсера;
+ * - contention: пропускна здатність при 1, 2, 4 та 8 продюсерах;
+ * - latency: перцентилі затримки від eventbus_publish до входу в callback;
+ * - fanout: вартість обробки залежно від кількості підписників та частки wildcard‑підписників;
+ * - payload: публікація з копією даних розміром від 0 байтів до 64 КіБ.
+ *
+ * Кожен результат – окремий рядок JSON у stdout. Аргумент --quick зменшує кількість подій.
+ */
+
+#include "eventbus.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_QUEUE_SIZE 1024
+#define BENCH_LATENCY_SAMPLES 20000
+
+static size_t bench_events = 1000000;
+
+static EVENTBUS_ATOMIC(uint64_t) received;
+static EVENTBUS_ATOMIC(uint64_t) callback_ns;
+static EVENTBUS_ATOMIC(uint64_t) checksum;
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void wait_received(uint64_t expected)
+{
+  while (atomic_load_explicit(&received, memory_order_acquire) < expected)
+    sched_yield();
+}
+
+static EventBus *bench_bus(void)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.queue_size = BENCH_QUEUE_SIZE;
+  cfg.overflow_policy = event_overflow_block;
+  return eventbus_create(cfg);
+}
+
+static void bench_stop(EventBus *bus)
+{
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static void count_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add_explicit(&received, 1, memory_order_release);
+}
+
+// ==================== throughput / contention ====================
+
+typedef struct
+{
+  EventBus *bus;
+  size_t events;
+} Producer;
+
+static void *producer_thread(void *arg)
+{
+  Producer *p = (Producer *)arg;
+  EventInputData input = create_event_input_data(NULL, 0);
+  EventResultData result = create_event_result();
+  for (size_t i = 0; i < p->events; i++)
+    eventbus_publish(p->bus, event_type(1, 1), input, result);
+  return NULL;
+}
+
+static void bench_contention(const char *name, int producers)
+{
+  EventBus *bus = bench_bus();
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, count_callback);
+  atomic_store(&received, 0);
+
+  pthread_t threads[8];
+  Producer p = {bus, bench_events / producers};
+  uint64_t start = now_ns();
+  for (int i = 0; i < producers; i++)
+    pthread_create(&threads[i], NULL, producer_thread, &p);
+  for (int i = 0; i < producers; i++)
+    pthread_join(threads[i], NULL);
+  wait_received(p.events * producers);
+  uint64_t elapsed = now_ns() - start;
+
+  printf("{\"bench\":\"%s\",\"producers\":%d,\"events\":%zu,\"ns\":%llu,\"events_per_sec\":%.0f}\n",
+         name, producers, p.events * producers, (unsigned long long)elapsed,
+         (double)(p.events * producers) * 1e9 / (double)elapsed);
+  bench_stop(bus);
+}
+
+// ==================== latency ====================
+
+static void stamp_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_store_explicit(&callback_ns, now_ns(), memory_order_release);
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static void bench_latency(void)
+{
+  static uint64_t samples[BENCH_LATENCY_SAMPLES];
+  EventBus *bus = bench_bus();
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, stamp_callback);
+  EventInputData input = create_event_input_data(NULL, 0);
+  EventResultData result = create_event_result();
+
+  for (size_t i = 0; i < BENCH_LATENCY_SAMPLES; i++)
+  {
+    atomic_store(&callback_ns, 0);
+    uint64_t start = now_ns();
+    eventbus_publish(bus, event_type(1, 1), input, result);
+    uint64_t stamp;
+    while ((stamp = atomic_load_explicit(&callback_ns, memory_order_acquire)) == 0)
+      sched_yield();
+    samples[i] = stamp - start;
+  }
+  qsort(samples, BENCH_LATENCY_SAMPLES, sizeof(uint64_t), cmp_u64);
+
+  printf("{\"bench\":\"latency\",\"samples\":%d,\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}\n",
+         BENCH_LATENCY_SAMPLES,
+         (unsigned long long)samples[BENCH_LATENCY_SAMPLES / 2],
+         (unsigned long long)samples[BENCH_LATENCY_SAMPLES * 9 / 10],
+         (unsigned long long)samples[BENCH_LATENCY_SAMPLES * 99 / 100],
+         (unsigned long long)samples[BENCH_LATENCY_SAMPLES * 999 / 1000],
+         (unsigned long long)samples[BENCH_LATENCY_SAMPLES - 1]);
+  bench_stop(bus);
+}
+
+// ==================== fanout ====================
+
+/**
+ * @brief Обробка події subs підписниками, з яких частка wildcard_pct – wildcard.
+ *
+ * Wildcard‑підписники по черзі підписуються на категорію та на всі події.
+ */
+static void bench_fanout(int subs, int wildcard_pct)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.queue_size = BENCH_QUEUE_SIZE;
+  cfg.overflow_policy = event_overflow_block;
+  cfg.subs_array_size = (uint16_t)subs;
+  EventBus *bus = eventbus_create(cfg);
+
+  int wildcards = subs * wildcard_pct / 100;
+  for (int i = 0; i < subs; i++)
+  {
+    EventType type = event_type(1, 1);
+    if (i < wildcards)
+      type = (i % 2) ? event_type(0, 0) : event_type(1, 0);
+    eventbus_subscribe(bus, type, (uint8_t)(i % 8), NULL, count_callback);
+  }
+  atomic_store(&received, 0);
+
+  size_t events = bench_events / subs;
+  EventInputData input = create_event_input_data(NULL, 0);
+  EventResultData result = create_event_result();
+  uint64_t start = now_ns();
+  for (size_t i = 0; i < events; i++)
+    eventbus_publish(bus, event_type(1, 1), input, result);
+  wait_received((uint64_t)events * subs);
+  uint64_t elapsed = now_ns() - start;
+
+  printf("{\"bench\":\"fanout\",\"subscribers\":%d,\"wildcard_pct\":%d,\"events\":%zu,\"events_per_sec\":%.0f,\"ns_per_callback\":%.1f}\n",
+         subs, wildcard_pct, events, (double)events * 1e9 / (double)elapsed,
+         (double)elapsed / ((double)events * subs));
+  bench_stop(bus);
+}
+
+// ==================== payload ====================
+
+static void payload_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  // Читаємо по байту з кожної кеш-лінії, як підписник, що обробляє дані
+  const uint8_t *data = (const uint8_t *)evt->input.direct_data;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < evt->input.data_size; i += 64)
+    sum += data[i];
+  atomic_fetch_add_explicit(&checksum, sum, memory_order_relaxed);
+  atomic_fetch_add_explicit(&received, 1, memory_order_release);
+}
+
+static void bench_payload(size_t size)
+{
+  EventBus *bus = bench_bus();
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, payload_callback);
+  atomic_store(&received, 0);
+
+  uint8_t *source = (uint8_t *)malloc(size ? size : 1);
+  for (size_t i = 0; i < size; i++)
+    source[i] = (uint8_t)i;
+
+  // Великі дані копіюються довше, тож кількість подій зменшується, щоб сценарій тривав порівнянний час
+  size_t events = bench_events / (1 + size / 1024);
+  EventResultData result = create_event_result();
+  uint64_t start = now_ns();
+  for (size_t i = 0; i < events; i++)
+  {
+    void *data = NULL;
+    if (size)
+    {
+      data = malloc(size);
+      memcpy(data, source, size);
+    }
+    eventbus_publish(bus, event_type(1, 1), create_event_input_data(data, size), result);
+  }
+  wait_received(events);
+  uint64_t elapsed = now_ns() - start;
+
+  printf("{\"bench\":\"payload\",\"bytes\":%zu,\"events\":%zu,\"events_per_sec\":%.0f,\"mib_per_sec\":%.1f}\n",
+         size, events, (double)events * 1e9 / (double)elapsed,
+         (double)events * size * 1e9 / (double)elapsed / (1024.0 * 1024.0));
+  free(source);
+  bench_stop(bus);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && strcmp(argv[1], "--quick") == 0)
+    bench_events = 100000;
+
+  bench_contention("throughput", 1);
+  for (int producers = 1; producers <= 8; producers *= 2)
+    bench_contention("contention", producers);
+
+  bench_latency();
+
+  static const int fanout_subs[] = {1, 4, 16, 64};
+  static const int fanout_wildcards[] = {0, 50, 100};
+  for (size_t s = 0; s < sizeof(fanout_subs) / sizeof(fanout_subs[0]); s++)
+    for (size_t w = 0; w < sizeof(fanout_wildcards) / sizeof(fanout_wildcards[0]); w++)
+      bench_fanout(fanout_subs[s], fanout_wildcards[w]);
+
+  static const size_t payload_sizes[] = {0, 64, 1024, 16384, 65536};
+  for (size_t i = 0; i < sizeof(payload_sizes) / sizeof(payload_sizes[0]); i++)
+    bench_payload(payload_sizes[i]);
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file bench_sync.c
+ * @brief Бенчмарк затримки від публікації до виклику callback: асинхронна та синхронна публікація.
+ *
+ * Для кожної події фіксується час до виклику eventbus_publish / eventbus_publish_sync
+ * та час входу в callback підписника. Виводяться перцентилі затримки в наносекундах.
+ */
+
+#include "eventbus.h"
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_SAMPLES 100000
+
+static EVENTBUS_ATOMIC(uint64_t) callback_ns;
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void stamp_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_store_explicit(&callback_ns, now_ns(), memory_order_release);
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static void report(const char *name, uint64_t *samples)
+{
+  qsort(samples, BENCH_SAMPLES, sizeof(uint64_t), cmp_u64);
+  printf("%-6s %10llu %10llu %10llu %10llu\n", name,
+         (unsigned long long)samples[BENCH_SAMPLES / 2],
+         (unsigned long long)samples[BENCH_SAMPLES * 99 / 100],
+         (unsigned long long)samples[BENCH_SAMPLES * 999 / 1000],
+         (unsigned long long)samples[BENCH_SAMPLES - 1]);
+}
+
+int main(void)
+{
+  static uint64_t samples[BENCH_SAMPLES];
+  EventBus *bus = eventbus_create(eventbus_default_config());
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, stamp_callback);
+  EventInputData input = create_event_input_data(NULL, 0);
+  EventResultData result = create_event_result();
+
+  printf("%-6s %10s %10s %10s %10s\n", "mode", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+
+  for (size_t i = 0; i < BENCH_SAMPLES; i++)
+  {
+    atomic_store(&callback_ns, 0);
+    uint64_t start = now_ns();
+    eventbus_publish(bus, event_type(1, 1), input, result);
+    uint64_t stamp;
+    while ((stamp = atomic_load_explicit(&callback_ns, memory_order_acquire)) == 0)
+      sched_yield();
+    samples[i] = stamp - start;
+  }
+  report("async", samples);
+
+  for (size_t i = 0; i < BENCH_SAMPLES; i++)
+  {
+    uint64_t start = now_ns();
+    eventbus_publish_sync(bus, event_type(1, 1), input, result);
+    samples[i] = atomic_load_explicit(&callback_ns, memory_order_relaxed) - start;
+  }
+  report("sync", samples);
+
+  eventbus_stop(bus);
+  free(bus);
+  return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file bench_workers.c
+ * @brief Бенчмарк масштабування пулу потоків обробки подій.
+ *
+ * Публікує події 64 незалежних категорій, кожен callback імітує кілька мікросекунд роботи.
+ * Вимірює пропускну здатність EventBus при 1, 2, 4 та 8 потоках обробки.
+ */
+
+#include "eventbus.h"
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_CATEGORIES 64
+#define BENCH_EVENTS_TOTAL 200000u
+#define BENCH_WORK_ITERATIONS 2000
+
+static EVENTBUS_ATOMIC(size_t) received;
+
+static void busy_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  volatile unsigned acc = 0;
+  for (unsigned i = 0; i < BENCH_WORK_ITERATIONS; i++)
+    acc += i;
+  atomic_fetch_add_explicit(&received, 1, memory_order_relaxed);
+}
+
+static double now_sec(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double run(uint8_t workers)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.queue_size = 1024;
+  cfg.worker_count = workers;
+  cfg.shard_count = (uint16_t)(workers * 4);
+  EventBus *bus = eventbus_create(cfg);
+  eventbus_subscribe(bus, event_type(0, 0), 0, NULL, busy_callback);
+  atomic_store(&received, 0);
+
+  EventInputData input = create_event_input_data(NULL, 0);
+  EventResultData result = create_event_result();
+  double start = now_sec();
+  for (size_t i = 0; i < BENCH_EVENTS_TOTAL; i++)
+  {
+    while (eventbus_publish(bus, event_type(1 + i % BENCH_CATEGORIES, 1), input, result) != 0)
+      sched_yield();
+  }
+  while (atomic_load(&received) < BENCH_EVENTS_TOTAL)
+    sched_yield();
+  double elapsed = now_sec() - start;
+
+  eventbus_stop(bus);
+  free(bus);
+  return BENCH_EVENTS_TOTAL / elapsed;
+}
+
+int main(void)
+{
+  static const uint8_t worker_counts[] = {1, 2, 4, 8};
+
+  double base = 0;
+  printf("%-8s %12s %8s\n", "workers", "events/s", "scaling");
+  for (size_t i = 0; i < sizeof(worker_counts) / sizeof(worker_counts[0]); i++)
+  {
+    double rate = run(worker_counts[i]);
+    if (i == 0)
+      base = rate;
+    printf("%-8u %12.0f %7.2fx\n", worker_counts[i], rate, rate / base);
+  }
+  return 0;
+}
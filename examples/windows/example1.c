@@ -29,7 +29,10 @@ void my_event_callback(Event *evt, void *ctx)
   if (evt->input.read_fn)
     n = evt->input.read_fn(evt->input.context, buf, sizeof(buf) - 1);
   else if (evt->input.direct_data)
+  {
     n = (evt->input.data_size < sizeof(buf) - 1) ? evt->input.data_size : sizeof(buf) - 1;
+    memcpy(buf, evt->input.direct_data, n);
+  }
   buf[n] = '\0';
   printf("Subscriber [%s] received an event: %s (total size: %d)\n", (char *)ctx, buf, total_size);
 }
@@ -2,8 +2,11 @@
  * @file eventbus.h
  * @brief Заголовочний файл для бібліотеки EventBus.
  *
- * Бібліотека реалізує асинхронну обробку подій з використанням окремого потоку,
- * двох м’ютексів для синхронізації роботи з чергою подій та списком підписників.
+ * Бібліотека реалізує асинхронну обробку подій пулом потоків. Продюсери публікують події
+ * в lock-free черги шардів без м’ютекса, а потоки обробки читають підписників із незмінних
+ * знімків таблиці диспетчеризації, які звільняються через RCU. М’ютексом серіалізуються лише
+ * підписка та відписка, що публікують новий знімок, а потоки обробки засинають на умовній
+ * змінній, лише коли подій немає.
  */
 
 #ifndef EVENTBUS_H
@@ -16,34 +19,6 @@
 #include <stdlib.h>
 #include "eventbus_def.h"
 
-/**
- * @brief Конфігурація EventBus.
- */
-typedef struct
-{
-  uint16_t queue_size;      /**< Розмір черги подій */
-  uint16_t subs_array_size; /**< Максимальна кількість підписників */
-  uint32_t task_stackSize;  /**< Розмір стеку для потоку */
-
-#if defined(CONFIG_IDF_TARGET)
-  // esp-idf specific
-
-  char *task_name;
-  UBaseType_t task_priority;
-  BaseType_t task_xCoreId;
-
-#elif defined(_WIN32)
-  // Windows-specific
-
-#else
-  // Unix-specific
-
-#endif
-
-} EventBusConfig;
-
-EventBusConfig eventbus_default_config(void);
-
 /**
  * @brief Функція, що повертає розмір даних.
  *
@@ -73,13 +48,37 @@ typedef int (*EventDataReadFn)(void *context, void *buffer, size_t size);
 typedef int (*EventDataWriteFn)(void *context, void *buffer, size_t size);
 typedef int (*EventDataWriteDoneFn)(void *context);
 
+/**
+ * @brief Де розміщені дані direct_data, а отже як їх звільнити після обробки.
+ */
+EVENTBUS_ENUM(EventDataStorage)
+{
+  event_data_heap, /**< Виділені через malloc, звільняються через free */
+  event_data_pool, /**< Блок пулу даних EventBus, повертається в пул */
+  event_data_stream, /**< Потік: EventBus сам читає дані шматками через read_fn під час обробки */
+  event_data_shm,    /**< Дані в сегменті спільної пам’яті EventShm; context – запис читача, дані повертаються в сегмент */
+  event_data_inline  /**< Дані в самій події (inline_data), нічого не звільняється */
+};
+EVENTBUS_ENUM_TYPEDEF(EventDataStorage);
+
+#ifndef EVENTBUS_INLINE_SIZE
+// Скільки байтів даних подія може нести в собі, без окремого блоку пам’яті (event_data_inline); 0 – вимкнено.
+#define EVENTBUS_INLINE_SIZE 32
+#endif
+
 /**
  * @brief Структура для введення даних події.
  *
  * Можна передавати дані через callback‑функції:
  * - size_fn: повертає загальний розмір даних,
  * - read_fn: зчитує дані у буфер,
- * або напряму через direct_data.
+ * або напряму через direct_data. При storage == event_data_stream підписники отримують дані
+ * шматками: direct_data та data_size вказують на поточний шматок (див. EventStreamChunk).
+ *
+ * Невеликі дані (до EVENTBUS_INLINE_SIZE байтів) копіюються прямо в структуру, в inline_data
+ * (event_data_inline): до 8 байтів таких даних лежать прямо в дескрипторі слоту черги, більші – в записі
+ * бічної таблиці. Callback‑функції такої події дорівнюють NULL. Підписник читає дані так само через direct_data,
+ * який EventBus перед обробкою спрямовує на inline_data копії події, що її отримує підписник.
  */
 typedef struct
 {
@@ -88,16 +87,28 @@ typedef struct
   void *context;           /**< Контекст для callback‑функцій */
   void *direct_data;       /**< Прямий вказівник на дані */
   size_t data_size;        /**< Розмір даних у direct_data */
+  EventDataStorage storage; /**< Де розміщені дані direct_data */
+#if EVENTBUS_INLINE_SIZE > 0
+  // Вирівняно як вказівник, щоб у inline_data можна було класти вирівняні дані
+  union
+  {
+    uint8_t inline_data[EVENTBUS_INLINE_SIZE]; /**< Дані при storage == event_data_inline */
+    void *inline_align;
+  };
+#endif
 } EventInputData;
 
+struct EventRequest;
+
 /**
  * @brief Структура для виведення результату події.
  */
 typedef struct
 {
   EventDataWriteFn write_fn;    /**< Callback для запису даних (результат) */
-  EventDataWriteDoneFn done_fn; /**< Callback для запису даних (результат) Викликаєтся коли всі підписники уже відпрацювали */
-  void *context;                /**< Контекст для write_fn */
+  EventDataWriteDoneFn done_fn; /**< Викликається один раз, коли всі підписники події відпрацювали; NULL – не викликається */
+  void *context;                /**< Контекст для write_fn та done_fn */
+  struct EventRequest *request; /**< Запит eventbus_request, що завершується разом з обробкою події; NULL – немає */
 } EventResultData;
 
 /**
@@ -129,18 +140,193 @@ EventInputData create_event_input_data(void *data, size_t data_size);
 
 EventInputData create_event_input_callback(EventDataReadFn read_fn, EventDataSizeFn size_fn);
 
+/**
+ * @brief Формує вхідні дані події з копії data.
+ *
+ * Дані до EVENTBUS_INLINE_SIZE байтів копіюються в саму подію (event_data_inline), тож ні публікація,
+ * ні обробка не звертаються до malloc/free; більші копіюються в блок malloc (event_data_heap).
+ * Якщо malloc не вдався, повертаються дані без вказівника з ненульовим data_size: eventbus_publish*
+ * та eventbus_request таку подію відхиляють, тож помилка не маскується під порожню подію.
+ * create_event_input_str працює так само.
+ *
+ * @param data Дані; після виклику можуть бути змінені чи звільнені.
+ * @param data_size Розмір даних.
+ * @return Вхідні дані події.
+ */
+EventInputData create_event_input_copy(const void *data, size_t data_size);
+
+/**
+ * @brief Формує вхідні дані події з буфера пулу.
+ *
+ * @param payload Вказівник на буфер з eventbus_payload_reserve.
+ * @param data_size Розмір записаних даних.
+ * @return Вхідні дані події.
+ */
+EventInputData create_event_input_payload(void *payload, size_t data_size);
+
+/**
+ * @brief Формує вхідні дані потокової події.
+ *
+ * Дані не буферизуються цілком: під час обробки EventBus читає їх через read_fn шматками
+ * по config.stream_chunk_size байтів, доки read_fn не поверне 0 (кінець) або від’ємне
+ * значення (помилка), і передає кожен шматок усім підписникам події.
+ *
+ * @param read_fn Callback для зчитування даних.
+ * @param context Контекст для read_fn.
+ * @return Вхідні дані події.
+ */
+EventInputData create_event_input_stream(EventDataReadFn read_fn, void *context);
+
 EventResultData create_event_result();
 
+/**
+ * @brief Клас пріоритету події.
+ *
+ * Кожен клас потрапляє в окрему чергу-смугу шарда; потік обробки спершу забирає події
+ * зі смуг вищого пріоритету (менше значення – вищий пріоритет).
+ */
+EVENTBUS_ENUM(EventPriority)
+{
+  event_priority_high,   /**< Керуючі події, аварії */
+  event_priority_normal, /**< Звичайні події, eventbus_publish */
+  event_priority_low     /**< Масові події, телеметрія */
+};
+EVENTBUS_ENUM_TYPEDEF(EventPriority);
+
+/**
+ * @brief Максимальна кількість смуг пріоритету в шарді.
+ */
+#define EVENTBUS_LANE_MAX 3
+
+/**
+ * @brief Шматок потокових даних події (event_data_stream).
+ *
+ * EventBus бере шматок з пулу, один раз заповнює його через read_fn і викликає з ним усіх
+ * підписників події по черзі, після чого читає наступний. Після останнього шматка з даними
+ * підписники отримують порожній шматок з last; якщо потік обірвано, у ньому ж виставлено failed.
+ * Шматок живе до повернення з callback; підписник, якому дані потрібні довше (наприклад, щоб
+ * віддати їх іншому потоку), утримує шматок через eventbus_stream_retain.
+ */
+typedef struct EventStreamChunk
+{
+  EVENTBUS_ATOMIC(uint16_t) refs; /**< Кількість власників шматка */
+  bool last;                      /**< Останній шматок потоку */
+  bool failed;                    /**< Потік обірвано: read_fn або write_fn повернула помилку */
+  size_t offset;                  /**< Зсув шматка від початку потоку */
+  size_t size;                    /**< Кількість байтів у data */
+  uint8_t *data;                  /**< Дані шматка */
+} EventStreamChunk;
+
 /**
  * @brief Структура події.
  */
 typedef struct
 {
   EventType type;         /**< Тип події */
+  EventPriority priority; /**< Клас пріоритету події */
+  bool stream_failed;     /**< Запис результату потоку через eventbus_stream_write не вдався */
   EventInputData input;   /**< Вхідні дані події */
   EventResultData result; /**< Дані для повернення результату */
+  EventStreamChunk *chunk; /**< Поточний шматок потоку під час обробки; NULL – подія не потокова */
+#if defined(EVENTBUS_STATS)
+  uint64_t enqueue_ns; /**< Момент EVENTBUS_TIME_NS() постановки в чергу */
+#endif
 } Event;
 
+/**
+ * @brief Функція, що повертає ключ шарда для події.
+ *
+ * Події з однаковим ключем потрапляють в один шард і обробляються в порядку публікації.
+ *
+ * @param evt Вказівник на подію.
+ * @return Ключ шарда.
+ */
+typedef uint32_t (*EventShardKeyFn)(const Event *evt);
+
+/**
+ * @brief Що робити з подією, для якої немає місця в черзі шарда.
+ *
+ * Події, які потік обробки вже взяв у поточну пачку, не викидаються й не замінюються. Поки шард
+ * обробляє потік (зокрема коли підписник публікує у власний шард), event_overflow_drop_oldest
+ * викидає замість найстарішої саму нову подію, а event_overflow_coalesce повертає -1: жодна
+ * з цих політик не чекає на місце. event_overflow_block у підписнику, що публікує у власний
+ * переповнений шард, чекав би на самого себе, тож для таких підписників він не підходить.
+ *
+ * Слоти черги та записи її бічної таблиці (queue_ext_size) закінчуються незалежно: подія без
+ * callback‑функцій, результату та запиту потребує лише слота, тож їй не заважають зайняті записи,
+ * а очікування event_overflow_block та event_overflow_timeout триває лише доти, доки з’явиться
+ * потрібний події ресурс.
+ */
+EVENTBUS_ENUM(EventOverflowPolicy)
+{
+  event_overflow_reject,      /**< Повернути -1, дані залишаються за викликачем */
+  event_overflow_block,       /**< Чекати, поки потік обробки звільнить місце */
+  event_overflow_timeout,     /**< Чекати не довше overflow_timeout_ms, потім повернути -1 */
+  event_overflow_drop_oldest, /**< Викинути найстарішу необроблену подію шарда (її дані звільняються); -1 – лише якщо події потрібен запис бічної таблиці, а вільних немає */
+  event_overflow_coalesce     /**< Замінити дані новішої необробленої події того ж типу; якщо такої немає – повернути -1 */
+};
+EVENTBUS_ENUM_TYPEDEF(EventOverflowPolicy);
+
+/**
+ * @brief Таймаут очікування без обмеження для eventbus_publish_timeout.
+ */
+#define EVENTBUS_WAIT_FOREVER UINT32_MAX
+
+/**
+ * @brief Кількість тем (topic_count) та запитів (request_count) у eventbus_default_config;
+ *        з цих же значень рахує пам’ять EVENTBUS_STATIC_SIZE.
+ */
+#define EVENTBUS_DEFAULT_TOPICS 8
+#define EVENTBUS_DEFAULT_REQUESTS 8
+
+/**
+ * @brief Конфігурація EventBus.
+ */
+typedef struct
+{
+  uint16_t queue_size;          /**< Розмір черги подій кожної смуги шарда (округлюється вгору до степеня двійки); при growable – розмір першого сегмента */
+  uint16_t queue_ext_size;      /**< Розмір бічної таблиці кожної смуги: скільки подій з callback‑функціями, результатом чи запитом вміщує черга; 0 – як queue_size */
+  uint8_t lane_count;           /**< Кількість смуг пріоритету (1..EVENTBUS_LANE_MAX); класи, для яких смуги немає, потрапляють в останню */
+  uint16_t subs_array_size;     /**< Максимальна кількість підписників; при growable – розмір першого блоку таблиці */
+  uint32_t task_stackSize;      /**< Розмір стеку для потоку (на POSIX 0 – розмір за замовчуванням) */
+  uint8_t worker_count;         /**< Кількість потоків обробки подій */
+  uint16_t shard_count;         /**< Кількість шардів черги (округлюється вгору до степеня двійки, не менше worker_count) */
+  EventShardKeyFn shard_key_fn; /**< Ключ шарда для події; NULL – категорія події */
+  uint16_t payload_block_size;  /**< Розмір блоку пулу даних подій */
+  uint16_t payload_block_count; /**< Кількість блоків пулу даних подій; 0 – пул вимкнений */
+  EventOverflowPolicy overflow_policy; /**< Поведінка eventbus_publish при переповненій черзі */
+  uint32_t overflow_timeout_ms;        /**< Максимальне очікування для event_overflow_timeout, мс */
+  uint16_t request_count;              /**< Кількість об’єктів запитів eventbus_request у пулі; 0 – запити вимкнені */
+  uint16_t stream_chunk_size;          /**< Розмір шматка потокових даних, байт */
+  uint8_t stream_chunk_count;          /**< Кількість шматків у пулі потокових даних; 0 – потокові події вимкнені */
+  uint16_t async_task_count;           /**< Скільки асинхронних підписників можуть одночасно обробляти події; 0 – вимкнені */
+  uint16_t topic_count;                /**< Максимальна кількість тем з останнім значенням (eventbus_conflate) */
+  uint16_t retain_type_count;          /**< Максимальна кількість типів з утримуваними подіями (eventbus_retain) */
+  uint16_t retain_block_size;          /**< Найбільший розмір даних утримуваної події, байт */
+  uint16_t retain_block_count;         /**< Кількість блоків пулу даних утримуваних подій; 0 – утримання вимкнене */
+  bool growable;                       /**< Таблиця підписників та черги ростуть при заповненні */
+  bool static_subscribers;             /**< Викликати підписників EVENTBUS_STATIC_SUBSCRIBER */
+  size_t memory_limit;                 /**< Межа пам’яті таблиці підписників та черг, байт; 0 – без обмеження */
+
+#if defined(CONFIG_IDF_TARGET)
+  // esp-idf specific
+
+  const char *task_name;
+  UBaseType_t task_priority;
+  BaseType_t task_xCoreId;
+
+#elif defined(_WIN32)
+  // Windows-specific
+
+#else
+  // Unix-specific
+
+#endif
+
+} EventBusConfig;
+
+EventBusConfig eventbus_default_config(void);
+
 /**
  * @brief Прототип callback‑функції підписника.
  *
@@ -149,129 +335,1206 @@ typedef struct
  */
 typedef void (*EventCallback)(Event *evt, void *subscriber_context);
 
-enum SubSlotStatus
+/**
+ * @brief Результат кроку асинхронного підписника.
+ */
+EVENTBUS_ENUM(EventAsyncStatus)
+{
+  event_async_done,   /**< Підписник завершив обробку події */
+  event_async_pending /**< Підписник чекає; його відновить eventbus_async_resume */
+};
+EVENTBUS_ENUM_TYPEDEF(EventAsyncStatus);
+
+struct EventAsyncTask;
+
+/**
+ * @brief Прототип callback‑функції асинхронного підписника.
+ *
+ * Функція – стекова машина без власного стеку: повернувши event_async_pending, вона віддає
+ * потік обробки іншим подіям, а після eventbus_async_resume викликається знову з тим самим task
+ * і продовжує з task->resume_point (див. EVENTBUS_ASYNC_BEGIN). Змінні, що мають пережити
+ * очікування, зберігаються через task->locals.
+ *
+ * @param evt Вказівник на копію події в task; дійсний до завершення підписника.
+ * @param task Стан підписника.
+ * @param subscriber_context Контекст підписника.
+ * @return event_async_done або event_async_pending.
+ */
+typedef EventAsyncStatus (*EventAsyncCallback)(Event *evt, struct EventAsyncTask *task, void *subscriber_context);
+
+/**
+ * @brief Callback підписника в таблиці підписників: звичайний або асинхронний.
+ *
+ * Яке поле дійсне, визначає прапорець async підписника, тож callback не приводиться між типами функцій.
+ */
+typedef union
+{
+  EventCallback sync;       /**< Callback eventbus_subscribe */
+  EventAsyncCallback async; /**< Callback eventbus_subscribe_async */
+} EventSubscriberFn;
+
+/**
+ * @brief Початок тіла асинхронного підписника: перехід до точки, де він зупинився.
+ *
+ * Між EVENTBUS_ASYNC_BEGIN та EVENTBUS_ASYNC_END не можна використовувати власний switch,
+ * що охоплює EVENTBUS_ASYNC_AWAIT, а локальні змінні функції не зберігаються між відновленнями.
+ */
+#define EVENTBUS_ASYNC_BEGIN(task) \
+  switch ((task)->resume_point)    \
+  {                                \
+  case 0:
+
+/**
+ * @brief Призупиняє асинхронного підписника до eventbus_async_resume.
+ *
+ * Операцію, після завершення якої треба викликати eventbus_async_resume, запускають до
+ * EVENTBUS_ASYNC_AWAIT: відновлення, що прийшло раніше за призупинення, не губиться.
+ */
+#define EVENTBUS_ASYNC_AWAIT(task)               \
+  do                                             \
+  {                                              \
+    (task)->resume_point = __LINE__;             \
+    return event_async_pending;                  \
+  case __LINE__:;                                \
+  } while (0)
+
+/**
+ * @brief Кінець тіла асинхронного підписника.
+ */
+#define EVENTBUS_ASYNC_END(task) \
+  }                              \
+  (task)->resume_point = 0;      \
+  return event_async_done
+
+EVENTBUS_ENUM(SubSlotStatus)
 {
   sub_slot_free,
-  sub_slot_used,
-  sub_slot_inWork
+  sub_slot_used
 };
-typedef uint8_t SubSlotStatus;
+EVENTBUS_ENUM_TYPEDEF(SubSlotStatus);
+
+/**
+ * @brief Максимальна кількість блоків дескрипторів підписників.
+ *
+ * Кожен наступний блок удвічі більший за попередній, тож 16 блоків покривають усі 16-бітні індекси.
+ */
+#define EVENTBUS_SUB_CHUNKS 16
+
+/**
+ * @brief Індекс, що позначає відсутність дескриптора (кінець списку вільних дескрипторів).
+ */
+#define EVENTBUS_SUB_NONE UINT16_MAX
 
 /**
- * @brief Структура підписника.
+ * @brief Підписник, зареєстрований на етапі компіляції через EVENTBUS_STATIC_SUBSCRIBER.
  *
- * Поле active вказує, чи слот використовується.
- * Двосторонній зв’язаний список забезпечується полями next та prev.
+ * Дескриптори лежать у секції лінкера eventbus_subs (у flash/rodata) і не змінюються;
+ * EventBus лише будує при старті відсортований індекс записів цієї секції.
  */
 typedef struct
 {
-  SubSlotStatus status;   /**< true, якщо підписник активний, інакше false */
-  EventType type;         /**< Тип події, на яку підписаний */
+  uint16_t key;           /**< Ключ типу підписки: (category << 8) | id */
   uint8_t priority;       /**< Пріоритет (менше значення – вищий пріоритет) */
-  void *context;          /**< Контекст для callback */
   EventCallback callback; /**< Callback для обробки події */
-  int next;               /**< Індекс наступного підписника в списку, -1 якщо кінець */
-  int prev;               /**< Індекс попереднього підписника, -1 якщо початок */
-} EventSubscriber;
+  void *context;          /**< Контекст для callback */
+} EventStaticSubscriber;
 
-enum EventBusThreadStatus
+#if defined(EVENTBUS_STATIC_SUBS_SECTION)
+
+#define EVENTBUS_STATIC_CONCAT_(a, b) a##b
+#define EVENTBUS_STATIC_CONCAT(a, b) EVENTBUS_STATIC_CONCAT_(a, b)
+
+/**
+ * @brief Підписує callback на тип подій на етапі компіляції.
+ *
+ * Записується поза функціями, в будь-якому файлі програми. Підписник отримує події кожного EventBus
+ * з static_subscribers у конфігурації, від запуску до зупинки, і не відписується. Як і при
+ * eventbus_subscribe, category == 0 або id == 0 підписує на всі події або на всі події категорії;
+ * серед підписників одного пріоритету статичні викликаються першими. context має бути константою
+ * адреси (наприклад, &state або NULL).
+ *
+ * @param category Категорія типу подій.
+ * @param id Id типу подій.
+ * @param priority Пріоритет підписника.
+ * @param callback EventCallback.
+ * @param context Контекст для callback.
+ */
+#define EVENTBUS_STATIC_SUBSCRIBER(category, id, priority, callback, context)                                \
+  static const EventStaticSubscriber EVENTBUS_STATIC_CONCAT(eventbus_static_sub_, __COUNTER__)               \
+      EVENTBUS_STATIC_SUBS_SECTION = {(uint16_t)(((category) << 8) | (id)), (uint8_t)(priority), (callback), \
+                                      (void *)(context)}
+
+#endif
+
+struct EventStatsHistogram;
+
+/**
+ * @brief Дескриптор підписника.
+ *
+ * Вказівник на дескриптор повертає eventbus_subscribe і приймає eventbus_unsubscribe; його адреса
+ * не змінюється, поки існує EventBus: дескриптори розміщені в блоках, які не переміщуються при рості таблиці.
+ * Самі дані підписки (тип, пріоритет, callback, контекст) зберігаються в упакованих масивах EventBus.
+ * Поле generation змінюється при кожній підписці та відписці через цей слот,
+ * тож обробник події відрізняє актуального підписника від застарілого запису в знімку.
+ */
+typedef struct
 {
-  bus_thread_noStarted,
-  bus_thread_working,
-  bus_thread_stopping,
-  bus_thread_stoped,
-};
-typedef uint8_t EventBusThreadStatus;
+  SubSlotStatus status;                 /**< sub_slot_used, якщо підписник активний, інакше sub_slot_free */
+  bool async;                           /**< Підписник зареєстрований через eventbus_subscribe_async */
+  uint16_t index;                       /**< Індекс дескриптора */
+  uint16_t next_free;                   /**< Наступний вільний дескриптор, поки цей вільний */
+  EVENTBUS_ATOMIC(uint32_t) generation; /**< Покоління слоту */
+#if defined(EVENTBUS_STATS)
+  struct EventStatsHistogram *stats; /**< Гістограма тривалості callback‑функції */
+#endif
+} EventSubscriber;
 
 /**
- * @brief Основна структура EventBus.
+ * @brief Пам’ять, надана викликачем eventbus_init_static.
  *
- * Бібліотека використовує окремий потік для обробки подій,
- * два м’ютекса для синхронізації роботи з чергою подій та списком підписників.
+ * Структури EventBus розміщуються в ній послідовно, кожна з вирівнюванням EVENTBUS_STATIC_ALIGN,
+ * і не звільняються окремо: вся пам’ять повертається викликачу після eventbus_stop.
  */
 typedef struct
 {
-  EventBusConfig config; /**< Налаштування EventBus */
+  uint8_t *base; /**< Початок пам’яті; NULL – пам’ять виділяється з купи */
+  size_t size;   /**< Розмір, байт */
+  size_t used;   /**< Вже розміщено, байт */
+} EventArena;
 
-  Event *queue;      /**< Черга подій (динамічно виділена) */
-  size_t head, tail; /**< Індекси для циклічного буфера подій */
+/**
+ * @brief Пул блоків фіксованого розміру.
+ *
+ * Вся пам’ять виділяється при ініціалізації; вільні блоки утримуються в lock-free стеку.
+ */
+typedef struct
+{
+  uint8_t *blocks;                 /**< Пам’ять блоків */
+  size_t block_size;               /**< Розмір блоку */
+  uint16_t block_count;            /**< Кількість блоків */
+  EVENTBUS_ATOMIC(uint16_t) *next; /**< Індекс наступного вільного блоку для кожного блоку */
+  EVENTBUS_ATOMIC(uint32_t) head;  /**< Вершина стеку вільних блоків: (лічильник змін << 16) | індекс */
+  EventArena *arena;               /**< Пам’ять, з якої виділено блоки; NULL – купа */
+} EventPool;
 
-  eventbus_mutex_t queue_mutex; /**< М’ютекс для роботи з чергою подій */
-  eventbus_mutex_t subs_mutex;  /**< М’ютекс для роботи зі списком підписників */
+/**
+ * @brief Компактний дескриптор події в слоті черги (16 байтів без EVENTBUS_STATS).
+ *
+ * Звичайна подія з даними (heap, пул або до 8 байтів у самій події) та результатом
+ * за замовчуванням цілком описується дескриптором. Подія з callback‑функціями даних,
+ * результатом, запитом, потоком чи більшими вбудованими даними копіюється в бічну таблицю
+ * черги (EventQueue::ext), а payload.data вказує на цей запис.
+ */
+typedef struct
+{
+  EventType type; /**< Тип події */
+  uint8_t flags;  /**< Клас пріоритету, EventDataStorage та ознака запису бічної таблиці */
+  uint8_t reserved;
+  uint32_t size; /**< Розмір даних */
+  union
+  {
+    void *data;       /**< Дані події або запис бічної таблиці */
+    uint8_t bytes[8]; /**< Дані при storage == event_data_inline */
+  } payload;
+#if defined(EVENTBUS_STATS)
+  uint64_t enqueue_ns; /**< Момент EVENTBUS_TIME_NS() постановки в чергу */
+#endif
+} EventDescriptor;
 
-  EventSubscriber *subs;       /**< Масив підписників (динамічно виділений) */
-  int sub_head;                /**< Індекс першого підписника (найвищий пріоритет) */
-  EventBusThreadStatus status; /**< Прапорець роботи потоку обробки подій */
+/**
+ * @brief Слот черги подій.
+ *
+ * Поле seq – номер послідовності слоту: дорівнює позиції запису, коли слот вільний,
+ * і позиції запису + 1, коли в ньому лежить готова до читання подія.
+ */
+typedef struct
+{
+  EVENTBUS_ATOMIC(size_t) seq; /**< Номер послідовності слоту */
+  EventDescriptor desc;        /**< Дескриптор події */
+} EventQueueSlot;
 
-  eventbus_thread_t thread; /**< Потік обробки подій */
+/**
+ * @brief Облік пам’яті, яку EventBus виділяє під таблицю підписників та черги.
+ */
+typedef struct
+{
+  EVENTBUS_ATOMIC(size_t) used; /**< Виділено байт */
+  size_t limit;                 /**< Межа, байт; 0 – без обмеження */
+} EventMemoryBudget;
 
-#if defined(CONFIG_IDF_TARGET)
-  // esp-idf specific
-#elif defined(_WIN32)
-  // Windows-specific
-  DWORD dwThreadId; /**< Умовна змінна для Windows */
-#else
-  pthread_cond_t cond; /**< Умовна змінна для POSIX */
-#endif
+/**
+ * @brief Сегмент черги подій.
+ *
+ * Кільцевий буфер розміром у степінь двійки: позиція переводиться в індекс слоту маскою,
+ * продюсери займають позиції атомарним CAS на tail, а готовність слоту визначається його seq.
+ * head змінює лише споживач, тому він винесений на окрему кеш-лінію від tail.
+ * Старший біт tail означає, що сегмент закритий: у нього вже нічого не пишеться,
+ * а нові події йдуть у сегмент next.
+ */
+typedef struct EventQueueSegment
+{
+  EventQueueSlot *slots;                           /**< Масив слотів */
+  size_t mask;                                     /**< Розмір буфера мінус 1 */
+  EVENTBUS_ATOMIC(size_t) tail;                    /**< Наступна позиція для запису */
+  uint8_t pad[EVENTBUS_CACHE_LINE];
+  EVENTBUS_ATOMIC(size_t) head;                    /**< Наступна позиція для читання */
+  EVENTBUS_ATOMIC(struct EventQueueSegment *) next; /**< Наступний сегмент */
+  struct EventQueueSegment *retired_next;          /**< Наступний сегмент у списку на звільнення */
+} EventQueueSegment;
 
-} EventBus;
+/**
+ * @brief Lock-free черга подій (багато продюсерів / один споживач).
+ *
+ * Звичайна черга – один сегмент first фіксованого розміру. Черга, що росте (budget != NULL),
+ * при заповненні сегмента закриває його і додає новий, удвічі більший; споживач дочитує
+ * закритий сегмент до кінця і переходить до наступного, тож порядок подій зберігається.
+ * Прочитаний сегмент звільняється за епохами, як знімки диспетчеризації: коли з’являється прочитаний
+ * сегмент, епоха перемикається, і він звільняється, щойно вийдуть продюсери двох попередніх епох,
+ * які ще могли тримати на нього вказівник. Нові продюсери реєструються вже в новій епосі, тож
+ * під постійним навантаженням сегменти звільняються без моменту, коли в черзі немає жодного продюсера.
+ * Бічна таблиця ext не росте: коли її записи закінчуються, черга вважається переповненою
+ * для подій, що потребують запису.
+ */
+typedef struct
+{
+  EventQueueSegment first;                      /**< Перший сегмент */
+  EVENTBUS_ATOMIC(EventQueueSegment *) head_seg; /**< Сегмент, з якого читає споживач */
+  EVENTBUS_ATOMIC(EventQueueSegment *) tail_seg; /**< Сегмент, у який пишуть продюсери */
+  EVENTBUS_ATOMIC(uint32_t) epoch;              /**< Поточна епоха відвідувачів */
+  EVENTBUS_ATOMIC(uint32_t) visitors[2];        /**< Потоки, що звертаються до сегментів не як споживач, у парних та непарних епохах */
+  EventQueueSegment *retired;                   /**< Прочитані сегменти, відкладені в поточній епосі */
+  EventQueueSegment *retired_waiting;           /**< Сегменти, що чекають виходу відвідувачів попередньої епохи */
+  EventMemoryBudget *budget;                    /**< Облік пам’яті; NULL – черга не росте */
+  EventPool ext;                                /**< Бічна таблиця подій, що не вміщуються в дескриптор */
+  EventArena *arena;                            /**< Пам’ять, з якої виділено перший сегмент; NULL – купа */
+} EventQueue;
 
 /**
- * @brief Ініціалізує EventBus згідно з переданою конфігурацією.
+ * @brief Запис таблиці диспетчеризації.
  *
- * Виділяє пам’ять для черги подій та масиву підписників, ініціалізує м’ютекси,
- * умовну змінну та створює потік обробки подій.
+ * Описує відсортований за пріоритетом список підписників з ключем підписки key.
+ * Подію отримують підписники трьох записів: її точного типу, її категорії та глобального запису;
+ * обробка зливає ці списки за рангом підписника.
+ */
+typedef struct
+{
+  uint16_t key;    /**< Ключ підписки: (category << 8) | id; id == 0 – підписники категорії, 0 – підписники всіх подій */
+  uint16_t count;  /**< Кількість підписників у записі */
+  uint32_t offset; /**< Індекс першого підписника запису в масиві items */
+} EventDispatchEntry;
+
+/**
+ * @brief Підписник у знімку диспетчеризації.
  *
- * @param bus Вказівник на EventBus.
- * @param cfg Вказівник на конфігурацію EventBus.
- * @return 0 при успішній ініціалізації, -1 при помилці.
+ * Callback і контекст скопійовані зі слоту підписника, тому обробка події не читає
+ * змінюваний масив підписників, окрім поля generation.
  */
-int eventbus_init(EventBus *bus, EventBusConfig *cfg);
+typedef struct
+{
+  EventSubscriberFn callback; /**< Callback для обробки події */
+  void *context;              /**< Контекст для callback */
+  EventSubscriber *sub;       /**< Слот підписника */
+  uint32_t generation;        /**< Покоління слоту на момент побудови знімка */
+  uint16_t rank;              /**< Порядковий номер підписника за пріоритетом у знімку */
+  bool async;                 /**< Дійсне поле callback.async, інакше callback.sync */
+  uint8_t priority;           /**< Пріоритет підписника, для злиття зі статичними підписниками */
+} EventDispatchItem;
 
-EventBus *eventbus_create(EventBusConfig cfg);
+/**
+ * @brief Незмінний знімок розрідженої таблиці диспетчеризації за EventType.
+ *
+ * Містить записи лише для типів і категорій, на які хтось підписаний, відсортовані за key.
+ * Ключі записів додатково упаковані в окремий масив keys: невелика таблиця переглядається
+ * послідовно (SSE2/NEON, якщо доступні), велика – двійковим пошуком, тож пошук підписників
+ * для події торкається кількох кеш-ліній плюс підписників, які дійсно її отримають.
+ * Підписка та відписка будують новий знімок і атомарно підміняють ним поточний; старий
+ * звільняється, коли з нього гарантовано вийшли всі читачі (RCU з епохами).
+ */
+typedef struct EventDispatchSnapshot
+{
+  struct EventDispatchSnapshot *retired_next; /**< Наступний знімок у списку на звільнення */
+  uint32_t version;                           /**< Номер знімка */
+  uint16_t entry_count;                       /**< Кількість записів */
+  uint16_t *keys;                             /**< Ключі записів, у тому ж порядку, що й entries */
+  EventDispatchEntry *entries;                /**< Записи, відсортовані за key */
+  EventDispatchItem *items;                   /**< Підписники всіх записів */
+} EventDispatchSnapshot;
 
 /**
- * @brief Зупиняє роботу EventBus та звільняє всі ресурси.
+ * @brief Таблиця диспетчеризації статичних підписників (див. EVENTBUS_STATIC_SUBSCRIBER).
  *
- * @param bus Вказівник на EventBus.
+ * Будується один раз при старті EventBus і далі не змінюється, тож читається без RCU.
+ * Записи, як і в знімку, відсортовані за key; підписники запису – індекси дескрипторів секції,
+ * впорядковані за пріоритетом, а при однаковому пріоритеті – за порядком у секції.
  */
-void eventbus_stop(EventBus *bus);
+typedef struct
+{
+  const EventStaticSubscriber *subs; /**< Початок секції eventbus_subs */
+  uint16_t entry_count;              /**< Кількість записів; 0 – статичних підписників немає */
+  uint16_t *keys;                    /**< Ключі записів */
+  EventDispatchEntry *entries;       /**< Записи: offset і count в масиві order */
+  uint16_t *order;                   /**< Індекси дескрипторів у subs */
+} EventStaticDispatch;
 
 /**
- * @brief Додає нового підписника до EventBus.
+ * @brief Шард черги подій.
  *
- * Функція повертає вказівник на структуру EventSubscriber, яка використовується для подальшої відписки.
- * Підписник вставляється у двосторонній зв’язаний список за зростанням priority (якщо priority співпадають, новий елемент вставляється після існуючих).
+ * Шард одночасно обробляє не більше одного потоку (його захоплює прапорець busy),
+ * тому події одного класу пріоритету в шарді обробляються строго в порядку публікації.
+ * Прапорець також захоплює продюсер, що викидає або замінює необроблені події при переповненні.
  *
- * @param bus Вказівник на EventBus.
- * @param type Тип події для підписки.
- * @param priority Пріоритет підписника.
- * @param context Контекст підписника.
- * @param callback Callback для обробки події.
- * @return Вказівник на EventSubscriber при успіху, або NULL при помилці.
+ * Кожен клас пріоритету має власну чергу-смугу. Потік обробки бере пачку з найвищої непорожньої
+ * смуги, але непорожня нижча смуга, яку оминули EVENTBUS_LANE_AGING разів поспіль, отримує
+ * свою пачку поза чергою, тож масові події не голодують.
  */
-EventSubscriber *eventbus_subscribe(EventBus *bus, EventType type, uint8_t priority, void *context, EventCallback callback);
+typedef struct
+{
+  EventQueue lanes[EVENTBUS_LANE_MAX];     /**< Черги подій шарда за класом пріоритету */
+  uint8_t lane_skipped[EVENTBUS_LANE_MAX]; /**< Скільки пачок поспіль непорожню смугу оминали */
+  EVENTBUS_ATOMIC(bool) busy;              /**< true, поки шард обробляє якийсь потік */
+  eventbus_cond_t space_cond;              /**< Умовна змінна, на якій продюсери чекають вільного місця */
+  EVENTBUS_ATOMIC(uint16_t) blocked;       /**< Кількість продюсерів, що чекають на space_cond */
+} EventShard;
 
 /**
- * @brief Видаляє підписника з EventBus.
- *
- * @param bus Вказівник на EventBus.
- * @param subscriber Вказівник на підписника, який потрібно видалити.
- * @return 0 при успіху, -1 якщо підписника не знайдено.
+ * @brief Стан запиту eventbus_request.
  */
-int eventbus_unsubscribe(EventBus *bus, EventSubscriber *subscriber);
+EVENTBUS_ENUM(EventRequestStatus)
+{
+  event_request_pending, /**< Подія ще не оброблена */
+  event_request_done,    /**< Всі підписники події відпрацювали */
+  event_request_dropped  /**< Подія викинута з черги, замінена новішою або EventBus зупинено до її обробки */
+};
+EVENTBUS_ENUM_TYPEDEF(EventRequestStatus);
+
+struct EventBus;
+struct EventStatsState;
 
 /**
- * @brief Публікує подію.
+ * @brief Продовження запиту: викликається один раз, коли запит завершився.
  *
- * Події з type.category==0 або type.id==0 заборонені.
+ * Викликається в потоці, що завершив запит (потоці обробки, продюсері, що викинув подію,
+ * або в eventbus_request_then, якщо запит уже завершений).
  *
  * @param bus Вказівник на EventBus.
- * @param type Тип події.
- * @param input Вхідні дані події.
- * @param result Дані для повернення результату.
- * @return 0 при успішній публікації, -1 при помилці.
+ * @param request Вказівник на запит; дійсний щонайменше до повернення з функції.
+ * @param context Контекст продовження.
  */
-int eventbus_publish(EventBus *bus, EventType type, EventInputData input, EventResultData result);
+typedef void (*EventRequestContinuation)(struct EventBus *bus, struct EventRequest *request, void *context);
+
+/**
+ * @brief Запит, що завершується разом з обробкою події.
+ *
+ * Об’єкти запитів беруться з пулу EventBus, тож запит не звертається до malloc/free.
+ * Запит утримують двоє: викликач (до eventbus_request_release) та подія (до завершення обробки);
+ * об’єкт повертається в пул, коли відпустять обидва.
+ */
+typedef struct EventRequest
+{
+  EVENTBUS_ATOMIC(uint8_t) state;   /**< EventRequestStatus у молодших бітах та прапорець встановленого продовження */
+  EVENTBUS_ATOMIC(uint8_t) refs;    /**< Кількість власників запиту */
+  EVENTBUS_ATOMIC(bool) waiting;    /**< true, поки викликач чекає на cond */
+  EventRequestContinuation then_fn; /**< Продовження */
+  void *then_context;               /**< Контекст продовження */
+  eventbus_cond_t cond;             /**< Умовна змінна, на якій чекає eventbus_request_wait */
+} EventRequest;
+
+/**
+ * @brief Спільний стан події, яку ще обробляють призупинені асинхронні підписники.
+ *
+ * Утримується потоком, що обробляє подію, та кожною задачею асинхронного підписника;
+ * коли відпускає останній, викликається result.done_fn, а дані події звільняються.
+ */
+typedef struct EventAsyncGroup
+{
+  Event event;                     /**< Подія після проходу по всіх підписниках */
+  EVENTBUS_ATOMIC(uint16_t) refs;  /**< Кількість власників */
+  EVENTBUS_ATOMIC(uint8_t) status; /**< EventRequestStatus, з яким завершиться подія */
+} EventAsyncGroup;
+
+/**
+ * @brief Стан асинхронного підписника, що обробляє одну подію.
+ *
+ * Береться з пулу перед викликом EventAsyncCallback і повертається в пул, коли підписник поверне
+ * event_async_done.
+ */
+typedef struct EventAsyncTask
+{
+  Event event;                         /**< Копія події, яку отримує callback */
+  EventAsyncCallback callback;         /**< Callback підписника; NULL – задача вільна */
+  void *context;                       /**< Контекст підписника */
+  EventAsyncGroup *group;              /**< Спільний стан події */
+  EventStreamChunk stream_end;         /**< Копія останнього шматка потокової події, який не береться з пулу */
+  uint16_t resume_point;               /**< Точка відновлення для EVENTBUS_ASYNC_*; 0 – початок */
+  void *locals;                        /**< Стан підписника між відновленнями; EventBus його не змінює */
+  bool cancelled;                      /**< EventBus зупиняється: підписник має звільнити ресурси та завершитись */
+  EVENTBUS_ATOMIC(uint8_t) state;      /**< Виконується, призупинена, відновлена чи в черзі готових */
+  struct EventAsyncTask *ready_next;   /**< Наступна задача в черзі готових */
+} EventAsyncTask;
+
+/**
+ * @brief Тема з останнім значенням (див. eventbus_conflate).
+ *
+ * Нова публікація замінює значення, яке підписники ще не отримали, а не займає слот черги, тож
+ * на тему припадає не більше одного необробленого значення. Поки тема в черзі готових або її
+ * обробляє потік, queued залишається виставленим, тож значення однієї теми обробляються по черзі.
+ */
+typedef struct EventTopic
+{
+  uint16_t key;                  /**< Тип події: (category << 8) | id */
+  bool pending;                  /**< event містить значення, яке підписники ще не отримали */
+  bool queued;                   /**< Тема в черзі готових або її обробляє потік */
+  Event event;                   /**< Останнє значення */
+  struct EventTopic *ready_next; /**< Наступна тема в черзі готових */
+} EventTopic;
+
+/**
+ * @brief Утримана подія (див. eventbus_retain).
+ */
+typedef struct
+{
+  uint32_t seq;           /**< Порядковий номер утримання серед подій усіх типів */
+  uint16_t size;          /**< Розмір даних */
+  EventPriority priority; /**< Клас пріоритету події */
+  uint8_t *data;          /**< Блок пулу даних утримуваних подій, закріплений за записом */
+} EventRetainedEntry;
+
+/**
+ * @brief Утримувані події одного типу: кільце з depth останніх оброблених подій.
+ *
+ * Блоки даних усіх записів беруться з пулу при реєстрації типу, тож пам’ять типу обмежена
+ * depth блоками, а утримання події лише копіює дані в блок найстарішого запису.
+ */
+typedef struct
+{
+  uint16_t key;                /**< Тип події: (category << 8) | id */
+  uint8_t depth;               /**< Кількість записів у кільці */
+  uint8_t used;                /**< Кількість заповнених записів */
+  uint8_t head;                /**< Запис, який заповнюється наступним */
+  EventRetainedEntry *entries; /**< Записи кільця (частина retain_entries) */
+} EventRetained;
+
+/**
+ * @brief Потік обробки подій.
+ */
+typedef struct
+{
+  struct EventBus *bus;     /**< EventBus, якому належить потік */
+  uint16_t index;           /**< Номер потоку, від нього залежить, з якого шарда починається обхід */
+  eventbus_thread_t thread; /**< Потік */
+} EventBusWorker;
+
+EVENTBUS_ENUM(EventBusThreadStatus)
+{
+  bus_thread_noStarted,
+  bus_thread_working,
+  bus_thread_stopping,
+  bus_thread_stoped,
+};
+EVENTBUS_ENUM_TYPEDEF(EventBusThreadStatus);
+
+/**
+ * @brief Основна структура EventBus.
+ *
+ * Бібліотека використовує один або кілька потоків для обробки подій, lock-free черги подій
+ * та м’ютекс для синхронізації змін таблиці підписників. Обробка подій м’ютекс підписників
+ * не бере: вона читає незмінний знімок таблиці диспетчеризації.
+ *
+ * Події розкладаються по шардах за ключем (за замовчуванням – категорією). Кожен потік починає
+ * обхід зі своїх шардів, а коли вони порожні або зайняті – забирає цілі шарди в інших потоків.
+ * Коли всі шарди порожні, потоки сплять на умовній змінній queue_cond і не споживають процесорний час;
+ * eventbus_publish будить один з них одразу після додавання події, якщо хтось спить.
+ */
+typedef struct EventBus
+{
+  EventBusConfig config; /**< Налаштування EventBus */
+
+  EventShard *shards;  /**< Шарди черги подій (динамічно виділені) */
+  uint16_t shard_mask; /**< Кількість шардів мінус 1 */
+
+  eventbus_mutex_t queue_mutex;               /**< М’ютекс для очікування на queue_cond */
+  eventbus_cond_t queue_cond;                 /**< Умовна змінна, на якій потоки обробки чекають нових подій */
+  eventbus_cond_t stop_cond;                  /**< Умовна змінна, на якій eventbus_stop чекає завершення потоків та очікувань */
+  EVENTBUS_ATOMIC(uint16_t) idle_workers;     /**< Кількість потоків обробки, що сплять на queue_cond */
+  EVENTBUS_ATOMIC(uint8_t) running_workers;   /**< Кількість потоків обробки, що ще не завершились */
+  eventbus_mutex_t subs_mutex;         /**< М’ютекс для роботи зі списком підписників */
+
+  EventSubscriber *sub_chunks[EVENTBUS_SUB_CHUNKS]; /**< Блоки дескрипторів підписників (динамічно виділені) */
+  uint8_t sub_chunk_count;                          /**< Кількість виділених блоків */
+  uint16_t sub_capacity;                            /**< Кількість дескрипторів у всіх блоках */
+  uint16_t sub_free;                                /**< Перший вільний дескриптор; EVENTBUS_SUB_NONE – вільних немає */
+  EVENTBUS_ATOMIC(EventBusThreadStatus) status;     /**< Прапорець роботи потоку обробки подій */
+
+  // Таблиця підписників: упаковані масиви, рядки яких впорядковані за пріоритетом
+  uint16_t sub_count;            /**< Кількість активних підписників (рядків) */
+  uint16_t *sub_keys;            /**< Ключ типу підписки: (category << 8) | id */
+  uint8_t *sub_priorities;       /**< Пріоритет (менше значення – вищий пріоритет) */
+  EventSubscriberFn *sub_callbacks; /**< Callback для обробки події */
+  void **sub_contexts;           /**< Контекст для callback */
+  uint16_t *sub_slots;           /**< Індекс дескриптора */
+
+  EVENTBUS_ATOMIC(EventDispatchSnapshot *) dispatch; /**< Поточний знімок таблиці диспетчеризації */
+  EventDispatchEntry *dispatch_keys;                 /**< Робочий буфер ключів для побудови знімка */
+  uint32_t dispatch_version;                         /**< Номер останнього побудованого знімка */
+  EVENTBUS_ATOMIC(uint32_t) rcu_epoch;               /**< Поточна епоха читачів знімків */
+  EVENTBUS_ATOMIC(uint32_t) rcu_readers[2];          /**< Кількість читачів у парних та непарних епохах */
+  EventDispatchSnapshot *rcu_pending;                /**< Знімки, замінені в поточній епосі */
+  EventDispatchSnapshot *rcu_waiting;                /**< Знімки, що чекають виходу читачів попередньої епохи */
+  EventStaticDispatch statics;                       /**< Статичні підписники */
+
+  EventBusWorker *workers; /**< Потоки обробки подій (динамічно виділені) */
+
+  EventPool payload_pool; /**< Пул блоків для даних подій */
+
+  EventMemoryBudget memory; /**< Облік пам’яті таблиці підписників та черг */
+
+  EventPool request_pool;                     /**< Пул об’єктів запитів */
+  eventbus_mutex_t request_mutex;             /**< М’ютекс для очікування на cond запитів */
+  EVENTBUS_ATOMIC(uint16_t) request_waiters;  /**< Кількість потоків у eventbus_request_wait */
+
+  EventPool stream_pool;                     /**< Пул шматків потокових даних */
+  eventbus_cond_t stream_cond;               /**< Умовна змінна, на якій обробка потоку чекає вільного шматка */
+  EVENTBUS_ATOMIC(uint16_t) stream_waiters;  /**< Кількість потоків, що чекають на stream_cond */
+
+  EventPool async_task_pool;                     /**< Пул задач асинхронних підписників */
+  EventPool async_group_pool;                    /**< Пул спільних станів подій з асинхронними підписниками */
+  EVENTBUS_ATOMIC(EventAsyncTask *) async_ready; /**< Стек відновлених задач, які чекають на потік обробки */
+  eventbus_cond_t async_cond;                    /**< Умовна змінна, на якій обробка чекає вільної задачі */
+  EVENTBUS_ATOMIC(uint16_t) async_waiters;       /**< Кількість потоків, що чекають на async_cond */
+
+  EventTopic *topics;                        /**< Теми з останнім значенням (динамічно виділені) */
+  EVENTBUS_ATOMIC(uint16_t) topic_count;     /**< Кількість зареєстрованих тем */
+  eventbus_mutex_t topic_mutex;              /**< М’ютекс для значень тем та черги готових */
+  EVENTBUS_ATOMIC(EventTopic *) topic_ready; /**< Перша тема в черзі готових */
+  EventTopic *topic_ready_tail;              /**< Остання тема в черзі готових */
+
+  EventRetained *retained;                  /**< Типи з утримуваними подіями (динамічно виділені) */
+  EVENTBUS_ATOMIC(uint16_t) retained_count; /**< Кількість зареєстрованих типів */
+  eventbus_mutex_t retain_mutex;            /**< М’ютекс для кілець утримуваних подій та повтору їх новим підписникам */
+  EventPool retain_pool;                    /**< Пул блоків даних утримуваних подій */
+  uint32_t retain_seq;                      /**< Номер останньої утриманої події; під retain_mutex */
+  EventRetainedEntry *retain_entries;       /**< Записи кілець усіх типів, по одному на блок retain_pool */
+  uint16_t retain_entries_used;             /**< Скільки записів уже роздано типам */
+
+  EventArena arena;                       /**< Пам’ять eventbus_init_static; base == NULL – купа */
+  EventDispatchSnapshot *dispatch_spare; /**< Вільні буфери знімків при розміщенні в arena */
+
+#if defined(EVENTBUS_STATS)
+  struct EventStatsState *stats; /**< Лічильники та гістограми (динамічно виділені) */
+#endif
+
+} EventBus;
+
+#if defined(EVENTBUS_STATS)
+
+/**
+ * @brief Кількість кошиків гістограми.
+ *
+ * Кошики логарифмічно-лінійні, як у HDR-гістограмі: кожен степінь двійки поділений на 4 рівні
+ * частини, тож похибка значення не перевищує 25 %. Покриваються тривалості до ~2^41 нс,
+ * більші потрапляють в останній кошик.
+ */
+#define EVENTBUS_HIST_BUCKETS 160
+
+/**
+ * @brief Знімок гістограми тривалостей у наносекундах.
+ */
+typedef struct
+{
+  uint64_t count;                          /**< Кількість вимірів */
+  uint64_t total_ns;                       /**< Сума вимірів */
+  uint64_t max_ns;                         /**< Найбільший вимір */
+  uint32_t buckets[EVENTBUS_HIST_BUCKETS]; /**< Кількість вимірів у кожному кошику */
+} EventBusHistogram;
+
+/**
+ * @brief Статистика типу події: сумарна тривалість callback‑функцій на одну подію.
+ *
+ * Тип {0, 0} збирає типи, яким не вистачило місця в таблиці статистики.
+ */
+typedef struct
+{
+  EventType type;             /**< Тип події */
+  EventBusHistogram callback; /**< Тривалість обробки події всіма підписниками */
+} EventBusTypeStats;
+
+/**
+ * @brief Статистика підписника: тривалість його callback‑функції.
+ */
+typedef struct
+{
+  EventSubscriber *subscriber; /**< Підписник */
+  EventType type;              /**< Тип події, на яку підписаний */
+  EventBusHistogram callback;  /**< Тривалість виклику callback */
+} EventBusSubscriberStats;
+
+/**
+ * @brief Знімок статистики EventBus.
+ *
+ * Лічильники читаються атомарно, але не в одну мить, тож між собою можуть трохи розходитись.
+ */
+typedef struct
+{
+  uint64_t published;                   /**< Події, додані до черги */
+  uint64_t rejected;                    /**< Публікації, відхилені через переповнену чергу або таймаут */
+  uint64_t evicted;                     /**< Необроблені події, викинуті event_overflow_drop_oldest */
+  uint64_t coalesced;                   /**< Публікації, що замінили дані необробленої події (event_overflow_coalesce) */
+  uint64_t dispatched;                  /**< Оброблені події, в тому числі eventbus_publish_sync */
+  uint32_t queue_depth;                 /**< Поточна кількість подій у всіх чергах */
+  uint32_t queue_high_water;            /**< Найбільша кількість подій в одній черзі після публікації */
+  EventBusHistogram queue_latency;      /**< Час від публікації до початку обробки */
+  uint16_t type_count;                  /**< Кількість записів у types */
+  EventBusTypeStats *types;             /**< Статистика за типами подій */
+  uint16_t subscriber_count;            /**< Кількість записів у subscribers */
+  EventBusSubscriberStats *subscribers; /**< Статистика активних підписників */
+} EventBusStats;
+
+/**
+ * @brief Повертає знімок статистики EventBus.
+ *
+ * Доступна, якщо бібліотека зібрана з EVENTBUS_STATS. Лічильники оновлюються атомарно
+ * без м’ютексів, тож збирання статистики майже не впливає на публікацію та обробку.
+ *
+ * @param bus Вказівник на EventBus.
+ * @return Знімок (одне виділення пам’яті, звільняється через free) або NULL при помилці.
+ */
+EventBusStats *eventbus_get_stats(EventBus *bus);
+
+/**
+ * @brief Оцінює перцентиль за гістограмою.
+ *
+ * @param h Вказівник на гістограму.
+ * @param percentile Перцентиль від 0 до 100.
+ * @return Верхня межа кошика, в який потрапляє перцентиль, нс (не більша за max_ns); 0 для порожньої гістограми.
+ */
+uint64_t eventbus_histogram_percentile(const EventBusHistogram *h, double percentile);
+
+#endif
+
+/**
+ * @brief Ініціалізує EventBus згідно з переданою конфігурацією.
+ *
+ * Виділяє пам’ять для черги подій та масиву підписників, ініціалізує м’ютекси,
+ * умовну змінну та створює потік обробки подій.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param cfg Вказівник на конфігурацію EventBus.
+ * @return 0 при успішній ініціалізації, -1 при помилці.
+ */
+int eventbus_init(EventBus *bus, EventBusConfig *cfg);
+
+// ==================== Розміщення в пам’яті викликача ====================
+
+/**
+ * @brief Вирівнювання структур, які eventbus_init_static розміщує в пам’яті викликача.
+ */
+#define EVENTBUS_STATIC_ALIGN 16
+
+#ifndef EVENTBUS_STATIC_SNAPSHOTS
+/**
+ * @brief Кількість буферів знімків таблиці диспетчеризації при eventbus_init_static.
+ *
+ * Один буфер – поточний знімок, решта чекають, поки з них вийдуть читачі. Якщо вільних буферів
+ * немає, підписка чи відписка повертає помилку, доки потоки обробки не відпустять старі знімки.
+ */
+#define EVENTBUS_STATIC_SNAPSHOTS 4
+#endif
+
+#define EVENTBUS_STATIC_ALIGN_UP(size) (((size_t)(size) + EVENTBUS_STATIC_ALIGN - 1) & ~(size_t)(EVENTBUS_STATIC_ALIGN - 1))
+
+// Степінь двійки, не менша за n (n до 65535) і не менша за 2, як розмір черги
+#define EVENTBUS_STATIC_SMEAR4(x) ((x) | (x) >> 1 | (x) >> 2 | (x) >> 3)
+#define EVENTBUS_STATIC_SMEAR16(x) \
+  (EVENTBUS_STATIC_SMEAR4(x) | EVENTBUS_STATIC_SMEAR4((x) >> 4) | EVENTBUS_STATIC_SMEAR4((x) >> 8) | EVENTBUS_STATIC_SMEAR4((x) >> 12))
+#define EVENTBUS_STATIC_POW2(n) ((size_t)(n) <= 2 ? (size_t)2 : (size_t)EVENTBUS_STATIC_SMEAR16((uint32_t)(n) - 1) + 1)
+
+/**
+ * @brief Пам’ять пулу з count блоків розміру block_size.
+ */
+#define EVENTBUS_STATIC_POOL_SIZE(block_size, count)                                                   \
+  ((block_size) == 0 || (count) == 0                                                                   \
+       ? (size_t)0                                                                                     \
+       : EVENTBUS_STATIC_ALIGN_UP((((size_t)(block_size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1)) * \
+                                  (size_t)(count)) +                                                   \
+             EVENTBUS_STATIC_ALIGN_UP(sizeof(uint16_t) * (size_t)(count)))
+
+/**
+ * @brief Пам’ять однієї смуги черги: слоти та бічна таблиця (див. queue_size та queue_ext_size).
+ */
+#define EVENTBUS_STATIC_QUEUE_SIZE(queue_size, queue_ext_size)                   \
+  (EVENTBUS_STATIC_ALIGN_UP(sizeof(EventQueueSlot) * EVENTBUS_STATIC_POW2(queue_size)) + \
+   EVENTBUS_STATIC_POOL_SIZE(sizeof(Event), (queue_ext_size) ? (size_t)(queue_ext_size) : EVENTBUS_STATIC_POW2(queue_size)))
+
+/**
+ * @brief Найбільший знімок таблиці диспетчеризації для subs підписників.
+ */
+#define EVENTBUS_STATIC_SNAPSHOT_SIZE(subs)                            \
+  (sizeof(EventDispatchSnapshot) + sizeof(EventDispatchItem) * (size_t)(subs) + \
+   (sizeof(EventDispatchEntry) + sizeof(uint16_t)) * ((size_t)(subs) + 1))
+
+/**
+ * @brief Пам’ять таблиці підписників на subs рядків разом з буферами знімків.
+ */
+#define EVENTBUS_STATIC_SUBS_SIZE(subs)                                                                   \
+  (EVENTBUS_STATIC_ALIGN_UP(sizeof(EventSubscriber) * (size_t)(subs)) +                                   \
+   2 * EVENTBUS_STATIC_ALIGN_UP(sizeof(uint16_t) * (size_t)(subs)) + EVENTBUS_STATIC_ALIGN_UP((size_t)(subs)) + \
+   EVENTBUS_STATIC_ALIGN_UP(sizeof(EventSubscriberFn) * (size_t)(subs)) +                                      \
+   EVENTBUS_STATIC_ALIGN_UP(sizeof(void *) * (size_t)(subs)) +                                             \
+   EVENTBUS_STATIC_ALIGN_UP(sizeof(EventDispatchEntry) * ((size_t)(subs) + 1)) +                           \
+   EVENTBUS_STATIC_SNAPSHOTS * EVENTBUS_STATIC_ALIGN_UP(EVENTBUS_STATIC_SNAPSHOT_SIZE(subs)))
+
+// Кількість шардів: степінь двійки, не менша за shard_count та worker_count
+#define EVENTBUS_STATIC_SHARDS(shard_count, worker_count)                                        \
+  ((size_t)((shard_count) > (worker_count) ? (shard_count) : (worker_count)) <= 1                 \
+       ? (size_t)1                                                                               \
+       : EVENTBUS_STATIC_POW2((shard_count) > (worker_count) ? (shard_count) : (worker_count)))
+
+/**
+ * @brief Пам’ять таблиці диспетчеризації для count статичних підписників (EVENTBUS_STATIC_SUBSCRIBER).
+ */
+#define EVENTBUS_STATIC_SUBSCRIBERS_SIZE(count)                                        \
+  (2 * EVENTBUS_STATIC_ALIGN_UP(sizeof(uint16_t) * (size_t)(count)) +                  \
+   EVENTBUS_STATIC_ALIGN_UP(sizeof(EventDispatchEntry) * (size_t)(count)))
+
+/**
+ * @brief Розмір пам’яті для eventbus_init_static на етапі компіляції.
+ *
+ * Параметри – відповідні поля EventBusConfig; решта полів – як у eventbus_default_config
+ * (EVENTBUS_DEFAULT_TOPICS тем, EVENTBUS_DEFAULT_REQUESTS запитів, пули даних, потокових подій,
+ * асинхронних підписників та утримання вимкнені). static_subs – кількість EVENTBUS_STATIC_SUBSCRIBER
+ * у програмі при static_subscribers = true (як за замовчуванням) або 0, якщо їх вимкнено. Увімкнені
+ * пули додаються до результату через EVENTBUS_STATIC_POOL_SIZE. Точний розмір для довільної
+ * конфігурації повертає eventbus_static_size.
+ */
+#define EVENTBUS_STATIC_SIZE(queue_size, queue_ext_size, lane_count, shard_count, worker_count, subs_array_size, static_subs, stack_size) \
+  (EVENTBUS_STATIC_ALIGN - 1 +                                                                                                        \
+   EVENTBUS_STATIC_ALIGN_UP(sizeof(EventShard) * EVENTBUS_STATIC_SHARDS(shard_count, worker_count)) +                                  \
+   EVENTBUS_STATIC_ALIGN_UP(sizeof(EventBusWorker) * (size_t)(worker_count)) +                                                         \
+   EVENTBUS_STATIC_ALIGN_UP(sizeof(EventTopic) * EVENTBUS_DEFAULT_TOPICS) +                                                            \
+   EVENTBUS_STATIC_POOL_SIZE(sizeof(EventRequest), EVENTBUS_DEFAULT_REQUESTS) +                                                        \
+   EVENTBUS_STATIC_SHARDS(shard_count, worker_count) * (size_t)(lane_count) *                                                           \
+       EVENTBUS_STATIC_QUEUE_SIZE(queue_size, queue_ext_size) +                                                                        \
+   EVENTBUS_STATIC_SUBS_SIZE(subs_array_size) + ((static_subs) ? EVENTBUS_STATIC_SUBSCRIBERS_SIZE(static_subs) : (size_t)0) +        \
+   (size_t)(worker_count) * EVENTBUS_STATIC_STACK_SIZE(stack_size))
+
+/**
+ * @brief Ініціалізує EventBus у пам’яті викликача, без звернень до купи.
+ *
+ * Черги, пули, таблиця підписників, буфери знімків диспетчеризації та (на POSIX при task_stackSize != 0
+ * і на ESP-IDF) стеки потоків розміщуються в storage, а м’ютекси та умовні змінні – в самій структурі bus.
+ * Після ініціалізації публікація, обробка подій, підписка та відписка пам’ять не виділяють. Таблиця
+ * підписників і черги не ростуть, тож growable не підтримується. Статистика (EVENTBUS_STATS) виділяє
+ * пам’ять з купи, як і при eventbus_init.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param cfg Вказівник на конфігурацію EventBus.
+ * @param storage Пам’ять для EventBus, будь-якого вирівнювання.
+ * @param storage_size Розмір storage, байт; не менше eventbus_static_size(cfg).
+ * @return 0 при успіху, -1 якщо пам’яті не вистачає, задано growable або сталася інша помилка.
+ */
+int eventbus_init_static(EventBus *bus, EventBusConfig *cfg, void *storage, size_t storage_size);
+
+/**
+ * @brief Розмір пам’яті, потрібний eventbus_init_static для конфігурації cfg.
+ *
+ * @param cfg Вказівник на конфігурацію EventBus.
+ * @return Розмір, байт, з урахуванням вирівнювання початку storage.
+ */
+size_t eventbus_static_size(const EventBusConfig *cfg);
+
+EventBus *eventbus_create(EventBusConfig cfg);
+
+/**
+ * @brief Зупиняє роботу EventBus та звільняє всі ресурси.
+ *
+ * @param bus Вказівник на EventBus.
+ */
+void eventbus_stop(EventBus *bus);
+
+/**
+ * @brief Додає нового підписника до EventBus.
+ *
+ * Функція повертає вказівник на структуру EventSubscriber, яка використовується для подальшої відписки.
+ * Підписник вставляється в таблицю підписників за зростанням priority (якщо priority співпадають, новий елемент вставляється після існуючих).
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події для підписки.
+ * @param priority Пріоритет підписника.
+ * @param context Контекст підписника.
+ * @param callback Callback для обробки події.
+ * @return Вказівник на EventSubscriber при успіху, або NULL при помилці.
+ */
+EventSubscriber *eventbus_subscribe(EventBus *bus, EventType type, uint8_t priority, void *context, EventCallback callback);
+
+/**
+ * @brief Додає асинхронного підписника до EventBus.
+ *
+ * Асинхронний підписник займає місце в порядку пріоритетів так само, як звичайний, але, повернувши
+ * event_async_pending, не затримує наступних підписників і наступні події. Подія вважається
+ * обробленою (викликається done_fn, завершується запит, звільняються дані), коли завершились усі
+ * її асинхронні підписники. Відписка не перериває вже призупинених підписників.
+ * Призупинений підписник потокової події утримує свій шматок до завершення, тож коли вільних
+ * шматків немає, обробка потоку виконує відновлені задачі, а не лише чекає на пул.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події для підписки.
+ * @param priority Пріоритет підписника.
+ * @param context Контекст підписника.
+ * @param callback Callback асинхронного підписника.
+ * @return Вказівник на EventSubscriber при успіху, або NULL при помилці чи якщо async_task_count == 0.
+ */
+EventSubscriber *eventbus_subscribe_async(EventBus *bus, EventType type, uint8_t priority, void *context, EventAsyncCallback callback);
+
+/**
+ * @brief Видаляє підписника з EventBus.
+ *
+ * Не чекає завершення обробки поточної події: підписник не буде викликаний для подій,
+ * обробка яких почнеться після повернення з функції, але callback, який вже виконується
+ * (або саме розпочинається) в потоці обробки, може завершитись.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param subscriber Вказівник на підписника, який потрібно видалити.
+ * @return 0 при успіху, -1 якщо підписника не знайдено.
+ */
+int eventbus_unsubscribe(EventBus *bus, EventSubscriber *subscriber);
+
+/**
+ * @brief Публікує подію.
+ *
+ * Події з type.category==0 або type.id==0 заборонені.
+ * Якщо черга шарда переповнена, діє config.overflow_policy.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату.
+ * @return 0 при успішній публікації, -1 при помилці.
+ */
+int eventbus_publish(EventBus *bus, EventType type, EventInputData input, EventResultData result);
+
+/**
+ * @brief Публікує подію, чекаючи на місце в черзі не довше timeout_ms.
+ *
+ * Не залежить від config.overflow_policy. Продюсер спить на умовній змінній шарда, яку
+ * потік обробки сигналізує після звільнення слотів, тож очікування не навантажує процесор.
+ * При зупинці EventBus очікування переривається.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату.
+ * @param timeout_ms Максимальне очікування, мс; 0 – не чекати, EVENTBUS_WAIT_FOREVER – без обмеження.
+ * @return 0 при успішній публікації, -1 при помилці або після таймауту (дані залишаються за викликачем).
+ */
+int eventbus_publish_timeout(EventBus *bus, EventType type, EventInputData input, EventResultData result, uint32_t timeout_ms);
+
+/**
+ * @brief Публікує подію з заданим класом пріоритету.
+ *
+ * eventbus_publish публікує події з event_priority_normal. Подія високого пріоритету
+ * чекає в черзі не довше однієї пачки подій нижчих смуг, скільки б їх не було в черзі.
+ * Порядок зберігається лише між подіями одного класу пріоритету.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param priority Клас пріоритету події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату.
+ * @return 0 при успішній публікації, -1 при помилці.
+ */
+int eventbus_publish_priority(EventBus *bus, EventType type, EventPriority priority, EventInputData input, EventResultData result);
+
+/**
+ * @brief Резервує буфер для даних події в пулі EventBus.
+ *
+ * Буфер заповнюється на місці та передається в подію через create_event_input_payload,
+ * тож публікація не звертається до malloc/free. Після обробки події буфер автоматично
+ * повертається в пул. Якщо подію не вдалось опублікувати, буфер треба повернути через
+ * eventbus_payload_release.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param size Потрібний розмір.
+ * @return Вказівник на буфер або NULL, якщо size більший за блок пулу чи вільних блоків немає.
+ */
+void *eventbus_payload_reserve(EventBus *bus, size_t size);
+
+/**
+ * @brief Повертає в пул буфер, який не був опублікований.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param payload Вказівник на буфер з eventbus_payload_reserve.
+ */
+void eventbus_payload_release(EventBus *bus, void *payload);
+
+/**
+ * @brief Публікує пачку подій.
+ *
+ * Події, що потрапляють в одну чергу, резервують свої слоти одним атомарним кроком,
+ * а потік обробки будиться один раз на пачку, тож вартість синхронізації платиться
+ * на пачку, а не на кожну подію. Клас пріоритету береться з поля priority кожної події.
+ * Порядок подій одного класу в пачці зберігається.
+ * Публікація зупиняється на першій події, яку не вдалось додати (переповнена черга,
+ * заборонений тип або дані, для яких create_event_input_copy не отримала пам’ять); дані неопублікованих подій залишаються за викликачем.
+ * config.overflow_policy для пачок не застосовується.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param events Масив подій.
+ * @param n Кількість подій.
+ * @return Кількість опублікованих подій (перші елементи масиву).
+ */
+size_t eventbus_publish_batch(EventBus *bus, Event *events, size_t n);
+
+/**
+ * @brief Вмикає для типу подій режим останнього значення.
+ *
+ * Для таких тем (показники датчиків, знімки конфігурації) важливе лише найновіше значення.
+ * Публікація події цього типу не займає слот черги: якщо попереднє значення ще не отримав
+ * жоден підписник, воно замінюється новим (дані direct_data звільняються, запит завершується
+ * як event_request_dropped), інакше тема стає в чергу готових, яку потоки обробки переглядають
+ * перед шардами. Тож на тему припадає не більше однієї необробленої події, а повільний підписник
+ * отримує одразу найсвіжіше значення. Значення однієї теми обробляються по черзі, але порядок
+ * відносно подій інших типів не зберігається, а смуги пріоритету до тем не застосовуються.
+ * Режим не вимикається до eventbus_stop.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події (category та id не 0).
+ * @return 0 при успіху (або якщо режим уже ввімкнено), -1 при недопустимому типі
+ *         чи якщо вже зареєстровано config.topic_count тем.
+ */
+int eventbus_conflate(EventBus *bus, EventType type);
+
+/**
+ * @brief Утримує останні depth подій типу та повторює їх новим підписникам.
+ *
+ * Перед обробкою події цього типу її дані копіюються в кільце типу (замість найстарішої
+ * утриманої події). eventbus_subscribe одразу після реєстрації викликає callback нового
+ * підписника з утриманими подіями всіх типів, що відповідають його підписці (зокрема wildcard),
+ * від найстарішої до найновішої. Повтор упорядкований з живими подіями: кожна подія, оброблена
+ * до підписки, потрапляє в повтор, а кожна наступна надходить підписнику звичайним шляхом і вже
+ * після повтору. Повтор виконується в потоці, що викликав eventbus_subscribe, і потоки обробки
+ * подій утримуваних типів на цей час чекають, тож callback під час повтору не повинен
+ * підписуватись, синхронно публікувати утримувані типи чи чекати на місце в черзі.
+ *
+ * Утримується лише direct_data: подія з даними, більшими за retain_block_size, не утримується,
+ * а потокові події та події з даними через read_fn утримуються без даних. Асинхронним
+ * підписникам події не повторюються. Режим не вимикається до eventbus_stop.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події (category та id не 0).
+ * @param depth Скільки останніх подій утримувати.
+ * @return 0 при успіху, -1 при недопустимому типі чи depth, якщо тип уже утримується,
+ *         вже зареєстровано config.retain_type_count типів або в пулі немає depth вільних блоків.
+ */
+int eventbus_retain(EventBus *bus, EventType type, uint8_t depth);
+
+/**
+ * @brief Публікує подію синхронно, в потоці, що викликає функцію.
+ *
+ * Подія не потрапляє в чергу: ланцюжок підписників (той самий, що й для eventbus_publish,
+ * у порядку пріоритету) виконується одразу, і після повернення з функції всі callback‑функції
+ * вже відпрацювали. Можна викликати з будь-якого потоку, в тому числі з callback‑функції підписника.
+ * Дані direct_data звільняються після обробки, як і для асинхронної публікації.
+ *
+ * Події з type.category==0 або type.id==0 заборонені.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату.
+ * @return 0 при успішній обробці, -1 при помилці.
+ */
+int eventbus_publish_sync(EventBus *bus, EventType type, EventInputData input, EventResultData result);
+
+/**
+ * @brief Публікує подію та повертає запит, який завершиться разом з її обробкою.
+ *
+ * Запит завершується зі станом event_request_done після останнього підписника (одразу після
+ * result.done_fn) або зі станом event_request_dropped, якщо подію викинуто з черги, замінено
+ * новішою (event_overflow_coalesce) чи EventBus зупинено до її обробки. Результат підписники
+ * передають, як і раніше, через result.write_fn. Об’єкт запиту береться з пулу на
+ * config.request_count об’єктів і має бути відпущений через eventbus_request_release.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату; поле request заповнює функція.
+ * @return Запит або NULL, якщо пул запитів вичерпано чи подію не вдалось опублікувати
+ *         (дані залишаються за викликачем).
+ */
+EventRequest *eventbus_request(EventBus *bus, EventType type, EventInputData input, EventResultData result);
+
+/**
+ * @brief Повертає стан запиту, не чекаючи.
+ *
+ * @param request Вказівник на запит.
+ * @return Стан запиту.
+ */
+EventRequestStatus eventbus_request_poll(EventRequest *request);
+
+/**
+ * @brief Чекає на завершення запиту не довше timeout_ms.
+ *
+ * Потік спить на умовній змінній запиту, яку сигналізує потік, що завершив запит.
+ * Чекати на запит може лише один потік одночасно. Не можна викликати з callback‑функції
+ * підписника, якщо подія запиту обробляється в тому ж шарді.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param request Вказівник на запит.
+ * @param timeout_ms Максимальне очікування, мс; 0 – не чекати, EVENTBUS_WAIT_FOREVER – без обмеження.
+ * @return Стан запиту; event_request_pending після таймауту.
+ */
+EventRequestStatus eventbus_request_wait(EventBus *bus, EventRequest *request, uint32_t timeout_ms);
+
+/**
+ * @brief Встановлює продовження, яке буде викликане один раз після завершення запиту.
+ *
+ * Якщо запит уже завершений, продовження викликається одразу в потоці, що викликав функцію.
+ * Продовження можна встановити лише одне.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param request Вказівник на запит.
+ * @param fn Продовження.
+ * @param context Контекст продовження.
+ * @return 0 при успіху, -1 якщо продовження вже встановлене.
+ */
+int eventbus_request_then(EventBus *bus, EventRequest *request, EventRequestContinuation fn, void *context);
+
+/**
+ * @brief Відпускає запит. Після виклику вказівник на запит використовувати не можна.
+ *
+ * Запит можна відпустити до його завершення: встановлене продовження все одно буде викликане.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param request Вказівник на запит.
+ */
+void eventbus_request_release(EventBus *bus, EventRequest *request);
+
+/**
+ * @brief Передає результат підписника потокової події в result.write_fn.
+ *
+ * Якщо write_fn повертає від’ємне значення, EventBus більше не читає джерело: підписники
+ * отримують останній шматок з failed, а запит події завершується як event_request_dropped.
+ *
+ * @param evt Вказівник на подію, отриману в callback.
+ * @param buffer Дані.
+ * @param size Розмір даних.
+ * @return Результат write_fn.
+ */
+int eventbus_stream_write(Event *evt, const void *buffer, size_t size);
+
+/**
+ * @brief Утримує поточний шматок потоку після повернення з callback.
+ *
+ * Поки шматок утримується, він не повертається в пул, тож EventBus не читатиме джерело далі,
+ * якщо вільних шматків не залишилось: так повільний споживач притримує read_fn. Обробка події
+ * тримає один шматок, тож підписники, що відпускають шматки лише у своїх callback, можуть
+ * утримувати не більше stream_chunk_count - 1 шматків; коли утримано всі, обробка чекає, поки
+ * шматок відпустить інший потік.
+ *
+ * @param evt Вказівник на подію, отриману в callback.
+ * @return Шматок або NULL, якщо подія не потокова чи шматок порожній.
+ */
+EventStreamChunk *eventbus_stream_retain(Event *evt);
+
+/**
+ * @brief Відпускає шматок, утриманий через eventbus_stream_retain.
+ *
+ * Утримані шматки треба відпустити до eventbus_stop.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param chunk Вказівник на шматок.
+ */
+void eventbus_stream_release(EventBus *bus, EventStreamChunk *chunk);
+
+/**
+ * @brief Відновлює призупиненого асинхронного підписника.
+ *
+ * Можна викликати з будь-якого потоку, зокрема з callback завершення вводу-виводу, і навіть до того,
+ * як підписник повернув event_async_pending: тоді його буде викликано ще раз одразу після повернення.
+ * Задача стає в чергу готових, яку потоки обробки переглядають перед шардами. Зовнішні операції,
+ * що відновлюють підписників, мають завершитись до eventbus_stop: при зупинці призупинені
+ * підписники викликаються востаннє з task->cancelled.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param task Стан підписника, отриманий в EventAsyncCallback.
+ */
+void eventbus_async_resume(EventBus *bus, EventAsyncTask *task);
+
+/**
+ * @brief Сегмент спільної пам’яті для передачі подій між процесами.
+ *
+ * Сегмент містить кільце дескрипторів фіксованого розміру та кільце даних. Дескриптор задає
+ * дані зсувом у кільці, а не вказівником, тож події публікує будь-який процес, що відкрив
+ * сегмент, а отримують підписники EventBus у кожному процесі, що читає сегмент
+ * (eventbus_shm_subscribe). Дані копіюються один раз – у сегмент при публікації: підписники
+ * читача отримують direct_data, що вказує прямо в сегмент (event_data_shm).
+ *
+ * Реалізація є лише для Linux (futex на словах у сегменті); на інших платформах
+ * eventbus_shm_open повертає NULL.
+ */
+typedef struct EventShm EventShm;
+
+/**
+ * @brief Створює сегмент з іменем name або під’єднується до наявного.
+ *
+ * Розміри задає процес, що створив сегмент; при під’єднанні slot_count та payload_size ігноруються.
+ *
+ * @param name Ім’я сегмента для shm_open, наприклад "/eventbus".
+ * @param slot_count Кількість дескрипторів (округлюється вгору до степеня двійки).
+ * @param payload_size Розмір кільця даних, байт; найбільша подія не може бути більшою.
+ * @return Сегмент або NULL при помилці.
+ */
+EventShm *eventbus_shm_open(const char *name, uint32_t slot_count, size_t payload_size);
+
+/**
+ * @brief Закриває сегмент у цьому процесі.
+ *
+ * Якщо процес читав сегмент, функція зупиняє потік читача і чекає, поки EventBus звільнить
+ * дані вже переданих подій (оброблених або викинутих при eventbus_stop). Сам сегмент
+ * залишається, поки його не видалено через eventbus_shm_unlink.
+ *
+ * @param shm Вказівник на сегмент.
+ */
+void eventbus_shm_close(EventShm *shm);
+
+/**
+ * @brief Видаляє ім’я сегмента; відображення в процесах, що його відкрили, залишаються дійсними.
+ *
+ * @param name Ім’я сегмента.
+ * @return 0 при успіху, -1 при помилці.
+ */
+int eventbus_shm_unlink(const char *name);
+
+/**
+ * @brief Публікує подію в сегмент.
+ *
+ * Безпечно для виклику з багатьох потоків і процесів. Подію отримають читачі, що під’єдналися
+ * до її публікації. Якщо в кільці немає місця, бо його ще використовує найповільніший читач,
+ * продюсер чекає; процес, що завершився, не закривши сегмент, місця не тримає. Продюсер,
+ * що завершився між резервуванням місця та публікацією, зупиняє читачів на своїй події.
+ *
+ * @param shm Вказівник на сегмент.
+ * @param type Тип події.
+ * @param priority Клас пріоритету, з яким подію опублікують у EventBus читачів.
+ * @param data Дані події.
+ * @param size Розмір даних.
+ * @param timeout_ms Максимальне очікування місця, мс; 0 – не чекати, EVENTBUS_WAIT_FOREVER – без обмеження.
+ * @return 0 при успіху, -1 при помилці або після таймауту.
+ */
+int eventbus_shm_publish(EventShm *shm, EventType type, EventPriority priority, const void *data, size_t size, uint32_t timeout_ms);
+
+/**
+ * @brief Починає читати сегмент: кожна подія сегмента публікується в bus.
+ *
+ * Окремий потік читача передає події в bus у порядку їх публікації в сегмент, з класом
+ * пріоритету та політикою переповнення bus. Поки подія в EventBus, її дані займають місце
+ * в сегменті, тож повільні підписники зрештою притримують продюсерів усіх процесів.
+ * Процес може мати лише одного читача на відкритий сегмент.
+ *
+ * @param shm Вказівник на сегмент.
+ * @param bus Вказівник на EventBus.
+ * @return 0 при успіху, -1 при помилці або якщо всі записи читачів у сегменті зайняті.
+ */
+int eventbus_shm_subscribe(EventShm *shm, EventBus *bus);
 
 #endif
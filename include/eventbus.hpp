@@ -0,0 +1,267 @@
+/**
+ * @file eventbus.hpp
+ * @brief Типізована обгортка C++17 над EventBus без накладних витрат.
+ *
+ * Кожному типу даних події відповідає EventType, заданий на етапі компіляції через EVENTBUS_EVENT.
+ * eventbus::Bus::publish переміщує значення в саму подію, у блок пулу даних або, якщо пулу
+ * не вистачає, в блок malloc, а eventbus::Bus::subscribe реєструє callable, що приймає const T&.
+ * Callable без стану викликається з шаблонної функції-перехідника напряму, тож підписник коштує
+ * стільки ж, скільки написаний вручну на C; callable зі станом зберігається в самому Subscription.
+ */
+
+#ifndef EVENTBUS_HPP
+#define EVENTBUS_HPP
+
+// eventbus_def.h підключає <atomic> і має бути підключений поза extern "C"
+#include "eventbus_def.h"
+extern "C"
+{
+#include "eventbus.h"
+}
+
+#if __cplusplus >= 201703L
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef EVENTBUS_CPP_BUFFER_SIZE
+// Скільки байтів callable зі станом Subscription зберігає в собі; більші розміщуються через new.
+#define EVENTBUS_CPP_BUFFER_SIZE (4 * sizeof(void *))
+#endif
+
+namespace eventbus
+{
+
+/**
+ * @brief Тип події для типу даних T; задається через EVENTBUS_EVENT.
+ */
+template <class T>
+struct event_traits;
+
+/**
+ * @brief Задає EventType для типу даних T. Записується в глобальному просторі імен.
+ */
+#define EVENTBUS_EVENT(T, category, id)                 \
+  template <>                                           \
+  struct eventbus::event_traits<T>                      \
+  {                                                     \
+    static constexpr EventType type = {(category), (id)}; \
+  }
+
+namespace detail
+{
+
+template <class T>
+constexpr EventType event_type_of()
+{
+  constexpr EventType type = event_traits<T>::type;
+  static_assert(type.category != 0 && type.id != 0, "EventType типізованої події не може бути wildcard");
+  return type;
+}
+
+// Дані вміщуються в саму подію: копіюються побайтно разом з подією і вирівняні як inline_data
+template <class T>
+constexpr bool fits_inline = std::is_trivially_copyable_v<T> && sizeof(T) <= EVENTBUS_INLINE_SIZE &&
+                             alignof(T) <= alignof(void *);
+
+template <class T>
+const T &payload(const Event *evt)
+{
+  return *static_cast<const T *>(evt->input.direct_data);
+}
+
+template <class T, class F>
+constexpr bool stateless = std::is_empty_v<F> && std::is_default_constructible_v<F>;
+
+template <class T, class F>
+constexpr bool function_like = std::is_convertible_v<F, void (*)(const T &)>;
+
+// Callable без стану створюється на місці, тож виклик вбудовується в перехідник
+template <class T, class F>
+void call_stateless(Event *evt, void *)
+{
+  F{}(payload<T>(evt));
+}
+
+template <class T>
+void call_function(Event *evt, void *context)
+{
+  reinterpret_cast<void (*)(const T &)>(context)(payload<T>(evt));
+}
+
+template <class T, class F>
+void call_object(Event *evt, void *context)
+{
+  (*static_cast<F *>(context))(payload<T>(evt));
+}
+
+template <class F>
+void destroy_inline(void *object)
+{
+  static_cast<F *>(object)->~F();
+}
+
+template <class F>
+void destroy_heap(void *object)
+{
+  delete static_cast<F *>(object);
+}
+
+} // namespace detail
+
+/**
+ * @brief Підписка, отримана з Bus::subscribe; при знищенні відписується.
+ *
+ * Callable зі станом живе в самому об’єкті (або, якщо не вміщується в EVENTBUS_CPP_BUFFER_SIZE,
+ * у блоці new), а EventBus тримає на нього вказівник, тож Subscription не копіюється і не переміщується.
+ * Як і eventbus_unsubscribe, знищення не чекає на callback, що вже виконується: Subscription
+ * знищується, коли події цього типу вже не обробляються, або після eventbus_stop.
+ */
+class Subscription
+{
+public:
+  Subscription(const Subscription &) = delete;
+  Subscription &operator=(const Subscription &) = delete;
+  ~Subscription() { reset(); }
+
+  /**
+   * @brief Чи вдалося підписатись.
+   */
+  explicit operator bool() const { return subscriber_ != nullptr; }
+
+  /**
+   * @brief Відписується та знищує callable.
+   */
+  void reset()
+  {
+    if (subscriber_)
+      eventbus_unsubscribe(bus_, subscriber_);
+    subscriber_ = nullptr;
+    if (destroy_)
+      destroy_(object_);
+    destroy_ = nullptr;
+    object_ = nullptr;
+  }
+
+private:
+  friend class Bus;
+
+  template <class T, class F>
+  Subscription(EventBus *bus, std::in_place_type_t<T>, F &&fn, uint8_t priority) : bus_(bus)
+  {
+    using C = std::decay_t<F>;
+    constexpr EventType type = detail::event_type_of<T>();
+    if constexpr (detail::stateless<T, C>)
+      subscriber_ = eventbus_subscribe(bus, type, priority, nullptr, &detail::call_stateless<T, C>);
+    else if constexpr (std::is_empty_v<C> && detail::function_like<T, C>)
+    {
+      void (*function)(const T &) = fn;
+      subscriber_ = eventbus_subscribe(bus, type, priority, reinterpret_cast<void *>(function), &detail::call_function<T>);
+    }
+    else
+    {
+      if constexpr (sizeof(C) <= sizeof(buffer_) && alignof(C) <= alignof(std::max_align_t))
+      {
+        object_ = new (buffer_) C(std::forward<F>(fn));
+        destroy_ = &detail::destroy_inline<C>;
+      }
+      else
+      {
+        object_ = new C(std::forward<F>(fn));
+        destroy_ = &detail::destroy_heap<C>;
+      }
+      subscriber_ = eventbus_subscribe(bus, type, priority, object_, &detail::call_object<T, C>);
+      if (!subscriber_)
+        reset();
+    }
+  }
+
+  EventBus *bus_;
+  EventSubscriber *subscriber_ = nullptr;
+  void *object_ = nullptr;
+  void (*destroy_)(void *) = nullptr;
+  alignas(std::max_align_t) unsigned char buffer_[EVENTBUS_CPP_BUFFER_SIZE];
+};
+
+/**
+ * @brief Типізований доступ до EventBus. Не володіє ним і копіюється як вказівник.
+ */
+class Bus
+{
+public:
+  explicit Bus(EventBus *bus) : bus_(bus) {}
+
+  EventBus *get() const { return bus_; }
+
+  /**
+   * @brief Публікує значення як подію типу event_traits<T>::type.
+   *
+   * Тривіально копійовані дані до EVENTBUS_INLINE_SIZE байтів копіюються в саму подію, більші
+   * або з нетривіальним копіюванням переміщуються на місце в блок пулу даних (payload_block_count),
+   * а якщо вільного блоку не вистачає – у блок malloc. Деструктор даних EventBus не викликає,
+   * тож тип має бути тривіально знищуваним.
+   *
+   * @param value Дані події.
+   * @param priority Клас пріоритету події.
+   * @return 0 при успішній публікації, -1 при помилці (дані тоді звільняються).
+   */
+  template <class V>
+  int publish(V &&value, EventPriority priority = event_priority_normal) const
+  {
+    using T = std::decay_t<V>;
+    static_assert(std::is_trivially_destructible_v<T>, "EventBus не викликає деструктор даних події");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "дані з надмірним вирівнюванням не підтримуються");
+    constexpr EventType type = detail::event_type_of<T>();
+
+    if constexpr (detail::fits_inline<T>)
+      return eventbus_publish_priority(bus_, type, priority, create_event_input_copy(&value, sizeof(T)),
+                                       create_event_result());
+    else
+    {
+      // Блоки пулу вирівняні лише до вказівника
+      void *block = alignof(T) <= alignof(void *) ? eventbus_payload_reserve(bus_, sizeof(T)) : nullptr;
+      EventInputData input;
+      if (block)
+        input = create_event_input_payload(block, sizeof(T));
+      else if ((block = std::malloc(sizeof(T))) != nullptr)
+        input = create_event_input_data(block, sizeof(T));
+      else
+        return -1;
+      new (block) T(std::forward<V>(value));
+      if (eventbus_publish_priority(bus_, type, priority, input, create_event_result()) == 0)
+        return 0;
+      if (input.storage == event_data_pool)
+        eventbus_payload_release(bus_, block);
+      else
+        std::free(block);
+      return -1;
+    }
+  }
+
+  /**
+   * @brief Підписує callable fn(const T &) на події типу event_traits<T>::type.
+   *
+   * @param fn Callable; лямбда без захоплень викликається без жодного непрямого виклику, крім самого
+   *           callback EventBus.
+   * @param priority Пріоритет підписника.
+   * @return Підписка; false, якщо підписатись не вдалося.
+   */
+  template <class T, class F>
+  Subscription subscribe(F &&fn, uint8_t priority = 0) const
+  {
+    static_assert(std::is_invocable_v<std::decay_t<F> &, const T &>, "callable має приймати const T &");
+    return Subscription(bus_, std::in_place_type<T>, std::forward<F>(fn), priority);
+  }
+
+private:
+  EventBus *bus_;
+};
+
+} // namespace eventbus
+
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file eventbus_async.hpp
+ * @brief Обгортка C++20‑корутин над асинхронними підписниками EventBus.
+ *
+ * Підписник пишеться як корутина, що повертає eventbus::AsyncHandler і отримує eventbus::AsyncContext:
+ * запускає операцію, по завершенні якої викликається ctx.resume(), і чекає на неї через co_await ctx.wait().
+ * Кадр корутини зберігається в EventAsyncTask::locals, тож EVENTBUS_ASYNC_* разом з нею не використовуються.
+ */
+
+#ifndef EVENTBUS_ASYNC_HPP
+#define EVENTBUS_ASYNC_HPP
+
+// eventbus_def.h підключає <atomic> і має бути підключений поза extern "C"
+#include "eventbus_def.h"
+extern "C"
+{
+#include "eventbus.h"
+}
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace eventbus
+{
+
+/**
+ * @brief Результат корутини‑підписника.
+ *
+ * Корутина виконується одразу при виклику, до першого co_await, а її кадр знищує AsyncSubscriber
+ * після завершення або при зупинці EventBus.
+ */
+class AsyncHandler
+{
+public:
+  struct promise_type
+  {
+    AsyncHandler get_return_object() { return AsyncHandler(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  AsyncHandler(AsyncHandler &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  AsyncHandler(const AsyncHandler &) = delete;
+  AsyncHandler &operator=(const AsyncHandler &) = delete;
+  ~AsyncHandler()
+  {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  /**
+   * @brief Забирає кадр корутини; після виклику AsyncHandler його не знищує.
+   */
+  std::coroutine_handle<promise_type> release() { return std::exchange(handle_, nullptr); }
+
+private:
+  explicit AsyncHandler(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief Доступ корутини‑підписника до події та до відновлення.
+ */
+class AsyncContext
+{
+public:
+  AsyncContext(EventBus *bus, EventAsyncTask *task) : bus_(bus), task_(task) {}
+
+  /**
+   * @brief Подія; дійсна, поки корутина не завершилась.
+   */
+  Event &event() const { return task_->event; }
+
+  /**
+   * @brief Відновлює корутину. Можна викликати з будь-якого потоку, зокрема до co_await wait().
+   */
+  void resume() const { eventbus_async_resume(bus_, task_); }
+
+  /**
+   * @brief Призупиняє корутину до resume().
+   */
+  std::suspend_always wait() const { return {}; }
+
+private:
+  EventBus *bus_;
+  EventAsyncTask *task_;
+};
+
+/**
+ * @brief Асинхронний підписник з корутиною F: AsyncHandler(AsyncContext).
+ *
+ * Об’єкт передається в EventBus як контекст підписника, тож має жити, поки підписка активна
+ * і поки не завершились усі його корутини.
+ */
+template <class F>
+class AsyncSubscriber
+{
+public:
+  explicit AsyncSubscriber(F fn) : fn_(std::move(fn)) {}
+
+  /**
+   * @brief Підписує корутину на тип подій (див. eventbus_subscribe_async).
+   */
+  EventSubscriber *subscribe(EventBus *bus, EventType type, uint8_t priority)
+  {
+    bus_ = bus;
+    return eventbus_subscribe_async(bus, type, priority, this, &AsyncSubscriber::step);
+  }
+
+private:
+  using Handle = std::coroutine_handle<AsyncHandler::promise_type>;
+
+  static EventAsyncStatus step(Event *, EventAsyncTask *task, void *context)
+  {
+    AsyncSubscriber *self = static_cast<AsyncSubscriber *>(context);
+    Handle handle;
+    if (task->locals == nullptr)
+      handle = self->fn_(AsyncContext(self->bus_, task)).release();
+    else
+    {
+      handle = Handle::from_address(task->locals);
+      if (!task->cancelled)
+        handle.resume();
+    }
+    if (task->cancelled || handle.done())
+    {
+      // При зупинці кадр знищується в точці очікування, викликаючи деструктори локальних змінних
+      handle.destroy();
+      task->locals = nullptr;
+      return event_async_done;
+    }
+    task->locals = handle.address();
+    return event_async_pending;
+  }
+
+  F fn_;
+  EventBus *bus_ = nullptr;
+};
+
+} // namespace eventbus
+
+#endif
+
+#endif
@@ -2,20 +2,58 @@
 #ifndef EVENTBUS_DEF_H
 #define EVENTBUS_DEF_H
 
+#include <stdint.h>
+
 #if defined(CONFIG_IDF_TARGET)
   // esp-idf specific
 
-typedef SemaphoreHandle_t eventbus_mutex_t;
-#define EVENTBUS_MUTEX_INIT(m) m = xSemaphoreCreateMutex()
-#define EVENTBUS_MUTEX_LOCK(m) xSemaphoreTake(m, portMAX_DELAY)
-#define EVENTBUS_MUTEX_UNLOCK(m) xSemaphoreGive(m)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+// Семафори створюються в пам’яті самої структури (xSemaphoreCreate*Static), без виділення з купи.
+typedef struct
+{
+  SemaphoreHandle_t handle;
+  StaticSemaphore_t buffer;
+} eventbus_mutex_t;
+#define EVENTBUS_MUTEX_INIT(m) ((m)->handle = xSemaphoreCreateMutexStatic(&(m)->buffer))
+#define EVENTBUS_MUTEX_LOCK(m) xSemaphoreTake((m)->handle, portMAX_DELAY)
+#define EVENTBUS_MUTEX_UNLOCK(m) xSemaphoreGive((m)->handle)
+#define EVENTBUS_MUTEX_DESTROY(m) vSemaphoreDelete((m)->handle)
+
+// Умовна змінна емулюється бінарним семафором: сигнал, відданий до очікування, не губиться,
+// а хибні пробудження допустимі, бо очікування завжди виконується в циклі з перевіркою умови.
+typedef eventbus_mutex_t eventbus_cond_t;
+#define EVENTBUS_COND_INIT(c) ((c)->handle = xSemaphoreCreateBinaryStatic(&(c)->buffer))
+#define EVENTBUS_COND_WAIT(c, m)                 \
+  do                                             \
+  {                                              \
+    xSemaphoreGive((m)->handle);                 \
+    xSemaphoreTake((c)->handle, portMAX_DELAY);  \
+    xSemaphoreTake((m)->handle, portMAX_DELAY);  \
+  } while (0)
+#define EVENTBUS_COND_TIMEDWAIT(c, m, ms)            \
+  do                                                 \
+  {                                                  \
+    xSemaphoreGive((m)->handle);                     \
+    xSemaphoreTake((c)->handle, pdMS_TO_TICKS(ms));  \
+    xSemaphoreTake((m)->handle, portMAX_DELAY);      \
+  } while (0)
+#define EVENTBUS_COND_SIGNAL(c) xSemaphoreGive((c)->handle)
+#define EVENTBUS_COND_DESTROY(c) vSemaphoreDelete((c)->handle)
 
 typedef TaskHandle_t eventbus_thread_t;
 #define TASK_DELAY(x) vTaskDelay(pdMS_TO_TICKS(x))
+#define EVENTBUS_TIME_MS() ((uint64_t)xTaskGetTickCount() * portTICK_PERIOD_MS)
+#define EVENTBUS_TIME_NS() ((uint64_t)esp_timer_get_time() * 1000u)
 typedef TickType_t TimeType;
 #define THREAD_RETURN_TYPE void
 #define THREAD_ARG_TYPE void *
 #define THREAD_RETURN
+// Пам’ять потоку при eventbus_init_static: стек і блок керування задачі
+#define EVENTBUS_STATIC_STACK_SIZE(stack) (EVENTBUS_STATIC_ALIGN_UP(stack) + EVENTBUS_STATIC_ALIGN_UP(sizeof(StaticTask_t)))
 
 #elif defined(_WIN32)
   // Windows-specific
@@ -25,25 +63,109 @@ typedef CRITICAL_SECTION eventbus_mutex_t;
 #define EVENTBUS_MUTEX_INIT(m) InitializeCriticalSection(m)
 #define EVENTBUS_MUTEX_LOCK(m) EnterCriticalSection(m)
 #define EVENTBUS_MUTEX_UNLOCK(m) LeaveCriticalSection(m)
+#define EVENTBUS_MUTEX_DESTROY(m) DeleteCriticalSection(m)
+
+typedef CONDITION_VARIABLE eventbus_cond_t;
+#define EVENTBUS_COND_INIT(c) InitializeConditionVariable(c)
+#define EVENTBUS_COND_WAIT(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define EVENTBUS_COND_TIMEDWAIT(c, m, ms) SleepConditionVariableCS(c, m, ms)
+#define EVENTBUS_COND_SIGNAL(c) WakeConditionVariable(c)
+#define EVENTBUS_COND_DESTROY(c) ((void)(c))
 
 typedef HANDLE eventbus_thread_t;
 #define TASK_DELAY(x) Sleep(x)
+#define EVENTBUS_TIME_MS() ((uint64_t)GetTickCount64())
+#define EVENTBUS_TIME_NS() eventbus_time_ns()
+
+static inline uint64_t eventbus_time_ns(void)
+{
+  LARGE_INTEGER freq, now;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (uint64_t)(now.QuadPart / freq.QuadPart) * 1000000000u +
+         (uint64_t)(now.QuadPart % freq.QuadPart) * 1000000000u / (uint64_t)freq.QuadPart;
+}
+
 typedef DWORD TimeType;
 #define THREAD_RETURN_TYPE DWORD WINAPI
 #define THREAD_ARG_TYPE LPVOID
 #define THREAD_RETURN 0
+// Стек потоку CreateThread завжди виділяє система
+#define EVENTBUS_STATIC_STACK_SIZE(stack) ((size_t)0)
 
 #else
   // Unix-specific
 
 #include <pthread.h>
+#include <time.h>
+#include <unistd.h>
 typedef pthread_mutex_t eventbus_mutex_t;
 #define EVENTBUS_MUTEX_INIT(m) pthread_mutex_init(m, NULL)
 #define EVENTBUS_MUTEX_LOCK(m) pthread_mutex_lock(m)
 #define EVENTBUS_MUTEX_UNLOCK(m) pthread_mutex_unlock(m)
+#define EVENTBUS_MUTEX_DESTROY(m) pthread_mutex_destroy(m)
+
+typedef pthread_cond_t eventbus_cond_t;
+#define EVENTBUS_COND_INIT(c) pthread_cond_init(c, NULL)
+#define EVENTBUS_COND_WAIT(c, m) pthread_cond_wait(c, m)
+#define EVENTBUS_COND_TIMEDWAIT(c, m, ms) eventbus_cond_timedwait(c, m, ms)
+#define EVENTBUS_COND_SIGNAL(c) pthread_cond_signal(c)
+#define EVENTBUS_COND_DESTROY(c) pthread_cond_destroy(c)
+
+// clock_gettime оголошується лише з POSIX‑розширеннями, тож функції часу визначені в eventbus.c,
+// а заголовок компілюється й у програмах зі строгим -std=c11
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+  void eventbus_cond_timedwait(pthread_cond_t *c, pthread_mutex_t *m, uint32_t ms);
+  uint64_t eventbus_time_ms(void);
+  uint64_t eventbus_time_ns(void);
+#ifdef __cplusplus
+}
+#endif
+
 typedef pthread_t eventbus_thread_t;
+#define TASK_DELAY(x) usleep((x) * 1000)
+#define EVENTBUS_TIME_MS() eventbus_time_ms()
+#define EVENTBUS_TIME_NS() eventbus_time_ns()
+typedef unsigned long TimeType;
+#define THREAD_RETURN_TYPE void *
+#define THREAD_ARG_TYPE void *
+#define THREAD_RETURN NULL
+// Стек потоку при eventbus_init_static; 0 – стек за замовчуванням виділяє система
+#define EVENTBUS_STATIC_STACK_SIZE(stack) EVENTBUS_STATIC_ALIGN_UP(stack)
+
+#endif
+
+// Атомарні типи: у C використовується C11 <stdatomic.h>, у C++ – сумісний за розміщенням std::atomic.
+#ifdef __cplusplus
+#include <atomic>
+#define EVENTBUS_ATOMIC(T) std::atomic<T>
+#else
+#include <stdatomic.h>
+#define EVENTBUS_ATOMIC(T) _Atomic(T)
+#endif
 
+// Перелічення займають один байт: у C полем є uint8_t, у C++ – саме перелічення з базовим типом uint8_t.
+#ifdef __cplusplus
+#define EVENTBUS_ENUM(name) enum name : uint8_t
+#define EVENTBUS_ENUM_TYPEDEF(name)
+#else
+#define EVENTBUS_ENUM(name) enum name
+#define EVENTBUS_ENUM_TYPEDEF(name) typedef uint8_t name
 #endif
 
+// Секція лінкера для EVENTBUS_STATIC_SUBSCRIBER. Межі секції дають символи, які генерує лінкер ELF
+// (__start_/__stop_), а на ESP-IDF – фрагмент linker.lf, тож на інших платформах секції немає.
+// Явне вирівнювання не дає компілятору збільшити його, і дескриптори лежать у секції без проміжків.
+#if defined(__ELF__) && defined(__GNUC__)
+#define EVENTBUS_STATIC_SUBS_SECTION __attribute__((section("eventbus_subs"), used, aligned(sizeof(void *))))
+#endif
+
+// Розмір кеш-лінії, по якому розносяться поля, що змінюються різними потоками.
+#ifndef EVENTBUS_CACHE_LINE
+#define EVENTBUS_CACHE_LINE 64
+#endif
 
 #endif
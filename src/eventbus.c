@@ -4,6 +4,10 @@
  */
 
 #include "eventbus.h"
+#include "eventbus_pool.h"
+#include "eventbus_queue.h"
+#include "eventbus_shm.h"
+#include "eventbus_stats.h"
 #include <stdio.h>
 
 EventBusConfig eventbus_default_config(void)
@@ -12,11 +16,31 @@ EventBusConfig eventbus_default_config(void)
   EventBusConfig config;
   config.subs_array_size = 20;
   config.queue_size = 10;
+  config.queue_ext_size = 0;
+  config.lane_count = 1;
+  config.worker_count = 1;
+  config.shard_count = 1;
+  config.shard_key_fn = NULL;
+  config.payload_block_size = 64;
+  config.payload_block_count = 0;
+  config.overflow_policy = event_overflow_reject;
+  config.overflow_timeout_ms = 0;
+  config.request_count = EVENTBUS_DEFAULT_REQUESTS;
+  config.stream_chunk_size = 512;
+  config.stream_chunk_count = 0;
+  config.async_task_count = 0;
+  config.topic_count = EVENTBUS_DEFAULT_TOPICS;
+  config.retain_type_count = 8;
+  config.retain_block_size = 64;
+  config.retain_block_count = 0;
+  config.growable = false;
+  config.static_subscribers = true;
+  config.memory_limit = 0;
 
 #if defined(CONFIG_IDF_TARGET)
   // esp-idf specific
 
-  config.task_name = strdup("EventBus");
+  config.task_name = "EventBus";
   config.task_priority = 5;
   config.task_stackSize = 4096;
   config.task_xCoreId = 0;
@@ -29,14 +53,49 @@ EventBusConfig eventbus_default_config(void)
 #else
   // Unix-specific
 
+  config.task_stackSize = 0;
+
 #endif
 
   return config;
 }
 
+#if !defined(CONFIG_IDF_TARGET) && !defined(_WIN32)
+// Unix-specific: очікування з таймаутом і монотонний час (див. eventbus_def.h)
+
+void eventbus_cond_timedwait(pthread_cond_t *c, pthread_mutex_t *m, uint32_t ms)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_sec += ms / 1000;
+  ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+  if (ts.tv_nsec >= 1000000000L)
+  {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000L;
+  }
+  pthread_cond_timedwait(c, m, &ts);
+}
+
+uint64_t eventbus_time_ms(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+uint64_t eventbus_time_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#endif
+
 EventInputData create_event_input_str(const char *data)
 {
-  return create_event_input_data(strdup(data), strlen(data) + 1);
+  return create_event_input_copy(data, strlen(data) + 1);
 }
 
 EventInputData create_event_input_data(void *data, size_t data_size)
@@ -44,451 +103,2625 @@ EventInputData create_event_input_data(void *data, size_t data_size)
   EventInputData data_ptr;
   data_ptr.read_fn = NULL;
   data_ptr.size_fn = NULL;
+  data_ptr.context = NULL;
   data_ptr.direct_data = data;
   data_ptr.data_size = data_size;
+  data_ptr.storage = event_data_heap;
+  return data_ptr;
+}
+
+EventInputData create_event_input_payload(void *payload, size_t data_size)
+{
+  EventInputData data_ptr = create_event_input_data(payload, data_size);
+  data_ptr.storage = event_data_pool;
   return data_ptr;
 }
 
+EventInputData create_event_input_copy(const void *data, size_t data_size)
+{
+#if EVENTBUS_INLINE_SIZE > 0
+  if (data_size <= EVENTBUS_INLINE_SIZE)
+  {
+    EventInputData data_ptr = create_event_input_data(NULL, data_size);
+    memcpy(data_ptr.inline_data, data, data_size);
+    data_ptr.storage = event_data_inline;
+    return data_ptr;
+  }
+#endif
+  void *copy = malloc(data_size);
+  if (copy)
+    memcpy(copy, data, data_size);
+  // Без копії data_size залишається ненульовим, тож публікація таких даних відхиляється (event_input_valid)
+  return create_event_input_data(copy, data_size);
+}
+
 EventInputData create_event_input_callback(EventDataReadFn read_fn, EventDataSizeFn size_fn)
 {
   EventInputData data_ptr;
   data_ptr.read_fn = read_fn;
   data_ptr.size_fn = size_fn;
+  data_ptr.context = NULL;
   data_ptr.direct_data = NULL;
   data_ptr.data_size = 0;
+  data_ptr.storage = event_data_heap;
   return data_ptr;
 }
 
-static int create_event_write_devnull_callback(void *context, void *buffer, size_t size)
+EventInputData create_event_input_stream(EventDataReadFn read_fn, void *context)
 {
+  EventInputData data_ptr = create_event_input_callback(read_fn, NULL);
+  data_ptr.context = context;
+  data_ptr.storage = event_data_stream;
+  return data_ptr;
 }
 
-static int create_event_done_devnull_callback(void *context)
+int eventbus_result_devnull(void *context, void *buffer, size_t size)
 {
+  (void)context;
+  (void)buffer;
+  (void)size;
+  return 0;
 }
 
 EventResultData create_event_result()
 {
   EventResultData result;
   result.context = NULL;
-  result.write_fn = create_event_write_devnull_callback;
-  result.done_fn = create_event_done_devnull_callback;
+  result.write_fn = eventbus_result_devnull;
+  result.done_fn = NULL;
+  result.request = NULL;
   return result;
 }
 
-// ==================== Робота з чергою подій ====================
+// ==================== Дані подій ====================
 
 /**
- * @brief Додає подію до циклічного буфера.
+ * @brief Звільняє дані direct_data відповідно до того, де вони розміщені.
  *
  * @param bus Вказівник на EventBus.
- * @param evt Вказівник на подію.
- * @return 0 при успіху, -1 якщо черга переповнена.
+ * @param input Вхідні дані події.
  */
-static int queue_push(EventBus *bus, Event *evt)
+static void event_input_release(EventBus *bus, EventInputData *input)
 {
-  EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
-  size_t next = (bus->tail + 1) % bus->config.queue_size;
-  if (next == bus->head)
+  if (input->storage == event_data_inline)
   {
-    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
-    return -1; // черга переповнена
+    input->direct_data = NULL;
+    input->data_size = 0;
+    return;
   }
-  bus->queue[bus->tail] = *evt;
-  bus->tail = next;
-  EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
-  return 0;
+  if (input->storage == event_data_shm)
+  {
+    // Місце в сегменті займає й подія без даних, тож повертається завжди
+    eventbus_shm_input_release(input);
+    return;
+  }
+  if (input->direct_data == NULL)
+    return;
+  if (input->storage == event_data_pool)
+    eventbus_pool_release(&bus->payload_pool, input->direct_data);
+  else
+    free(input->direct_data);
+  input->direct_data = NULL;
+  input->data_size = 0;
 }
 
 /**
- * @brief Видаляє подію з циклічного буфера.
+ * @brief Перевіряє, чи вхідні дані можна публікувати.
  *
- * @param bus Вказівник на EventBus.
- * @param evt Вказівник, куди буде скопійована подія.
- * @return 0 при успіху, -1 якщо черга порожня.
+ * Дані з ненульовим розміром, але без вказівника та callback‑функцій, – це копія,
+ * для якої create_event_input_copy не отримала пам’ять.
  */
-static int queue_pop(EventBus *bus, Event *evt)
-{
-  EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
-  if (bus->head == bus->tail)
-  {
-    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
-    return -1; // черга порожня
-  }
-  *evt = bus->queue[bus->head];
-  bus->head = (bus->head + 1) % bus->config.queue_size;
-  EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
-  return 0;
-}
-
-// ==================== Обробка подій ====================
-
-static int sub_next(EventBus *bus, int id, EventType type)
+static inline bool event_input_valid(const EventInputData *input)
 {
-  if (id == -1)
-    return -1;
-  if (id == -2)
-    id = bus->sub_head;
-  else
-  {
-    bus->subs[id].status = sub_slot_used;
-    id = bus->subs[id].next;
-  }
-  while (id != -1)
-  {
-    // Блокуємо subs_mutex для зчитування інформації про поточного підписника та його next.
-    EventSubscriber *sub = &bus->subs[id];
-    // Перевіряємо, чи відповідає тип події (з wildcard-правилами)
-    if (sub->type.category == 0)
-      break;
-    else if (sub->type.category == type.category)
-    {
-      if (sub->type.id == type.id || sub->type.id == 0)
-        break;
-    }
-    id = sub->next;
-  }
-  if (id != -1)
-    bus->subs[id].status = sub_slot_inWork;
-  return id;
+  return input->storage != event_data_heap || input->direct_data || !input->data_size || input->read_fn;
 }
 
 /**
- * @brief Обробляє подію, послідовно обходячи зв'язаний список підписників.
+ * @brief Спрямовує direct_data вбудованих даних на inline_data цієї копії події.
  *
- * Виконання починається з першого підписника (bus->sub_head). Для кожного підписника,
- * якщо тип події відповідає (з урахуванням wildcard‑правил), викликається його callback.
- * При виборі наступного підписника м’ютекс subs_mutex блокується для зчитування значення поля next,
- * після чого розблокується перед викликом callback.
- *
- * @param bus Вказівник на EventBus.
- * @param evt Вказівник на подію.
+ * Подія копіюється (у слот черги, у тему, в задачу асинхронного підписника), тож вказівник
+ * виставляється на копії, яку отримують підписники, безпосередньо перед обробкою.
  */
-static void process_event(EventBus *bus, Event *evt)
+static inline void event_input_bind(EventInputData *input)
 {
-  EVENTBUS_MUTEX_LOCK(&bus->subs_mutex);
-  int id = sub_next(bus, -2, evt->type);
-  EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
-
-  while (id != -1)
-  {
-    EventSubscriber *sub = &bus->subs[id];
-    sub->callback(evt, sub->context);
+#if EVENTBUS_INLINE_SIZE > 0
+  if (input->storage == event_data_inline)
+    input->direct_data = input->data_size ? input->inline_data : NULL;
+#endif
+}
 
-    if (bus->status == bus_thread_stopping)
-      break;
+void *eventbus_payload_reserve(EventBus *bus, size_t size)
+{
+  if (size > bus->payload_pool.block_size)
+    return NULL;
+  return eventbus_pool_alloc(&bus->payload_pool);
+}
 
-    EVENTBUS_MUTEX_LOCK(&bus->subs_mutex);
-    id = sub_next(bus, id, evt->type);
-    EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
-  }
-  if (evt->input.direct_data != NULL)
-  {
-    free(evt->input.direct_data);
-    evt->input.direct_data = NULL;
-    evt->input.data_size = 0;
-  }
+void eventbus_payload_release(EventBus *bus, void *payload)
+{
+  if (payload)
+    eventbus_pool_release(&bus->payload_pool, payload);
 }
 
-// ==================== Потік обробки подій ====================
+// ==================== Потокові дані ====================
+
+static bool async_run_ready(EventBus *bus);
+
 /**
- * @brief Функція потоку обробки подій.
+ * @brief Будить обробку потоку, що чекає на вільний шматок.
  *
- * Потік чекає появи подій у черзі та обробляє їх.
- *
- * @param arg Вказівник на EventBus.
- * @return NULL.
+ * Пара до fence у stream_chunk_alloc, так само як queue_space_wake до queue_wait_space.
  */
-static THREAD_RETURN_TYPE eventbus_thread_func(THREAD_ARG_TYPE arg)
+static void stream_wake(EventBus *bus)
 {
-  EventBus *bus = (EventBus *)arg;
-  bus->status = bus_thread_working;
-  while (true)
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&bus->stream_waiters, memory_order_relaxed) != 0)
   {
-    Event evt;
-    if (bus->status == bus_thread_stopping)
-    {
-      while (queue_pop(bus, &evt) == 0)
-      {
-        if (evt.input.direct_data == NULL)
-          continue;
-
-        free(evt.input.direct_data);
-        evt.input.direct_data = NULL;
-        evt.input.data_size = 0;
-      }
-      break;
-    }
-    if (queue_pop(bus, &evt) != 0)
-    {
-      TASK_DELAY(1);
-      continue;
-    }
-    process_event(bus, &evt);
+    EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+    EVENTBUS_COND_SIGNAL(&bus->stream_cond);
+    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
   }
-
-  bus->status = bus_thread_stoped;
-  return THREAD_RETURN;
 }
 
-// ==================== Ініціалізація EventBus ====================
+/**
+ * @brief Повертає шматок у пул і будить обробку потоку, що чекає на вільний шматок.
+ */
+static void stream_chunk_free(EventBus *bus, EventStreamChunk *chunk)
+{
+  eventbus_pool_release(&bus->stream_pool, chunk);
+  stream_wake(bus);
+}
 
 /**
- * @brief Ініціалізує EventBus згідно з переданою конфігурацією.
+ * @brief Бере шматок з пулу, чекаючи, поки підписники відпустять утримані шматки.
  *
- * Виділяє пам’ять для черги подій та масиву підписників, ініціалізує м’ютекси,
- * умовну змінну та створює потік обробки подій.
+ * Очікування тут і є зворотним тиском на джерело: read_fn не викликається, доки немає куди читати.
+ * Шматки утримують і призупинені асинхронні підписники, тож, як і async_alloc, потік сам виконує
+ * відновлені задачі, а eventbus_async_resume будить його на stream_cond.
  *
- * @param bus Вказівник на EventBus.
- * @param cfg Вказівник на конфігурацію EventBus.
- * @return 0 при успіху, -1 при помилці.
+ * @return Шматок або NULL, якщо пул порожній або EventBus зупиняється.
  */
-int eventbus_init(EventBus *bus, EventBusConfig *cfg)
+static EventStreamChunk *stream_chunk_alloc(EventBus *bus)
 {
-  bus->config = *cfg;
-  bus->status = bus_thread_noStarted;
-  bus->head = bus->tail = 0;
-  bus->sub_head = -1;
-  bus->queue = (Event *)malloc(sizeof(Event) * bus->config.queue_size);
-  if (!bus->queue)
-    return -1;
-  bus->subs = (EventSubscriber *)malloc(sizeof(EventSubscriber) * bus->config.subs_array_size);
-  if (!bus->subs)
-  {
-    free(bus->queue);
-    return -1;
-  }
-  for (size_t i = 0; i < bus->config.queue_size; i++)
-  {
-    bus->queue[i].input.direct_data = NULL;
-    bus->queue[i].input.data_size = 0;
-  }
-  for (size_t i = 0; i < bus->config.subs_array_size; i++)
+  while (true)
   {
-    bus->subs[i].status = sub_slot_free;
-    bus->subs[i].next = -1;
-    bus->subs[i].prev = -1;
+    EventStreamChunk *chunk = (EventStreamChunk *)eventbus_pool_alloc(&bus->stream_pool);
+    if (chunk || bus->stream_pool.block_count == 0)
+      return chunk;
+    if (async_run_ready(bus))
+      continue;
+
+    EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+    atomic_fetch_add_explicit(&bus->stream_waiters, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    while ((chunk = (EventStreamChunk *)eventbus_pool_alloc(&bus->stream_pool)) == NULL &&
+           atomic_load_explicit(&bus->async_ready, memory_order_relaxed) == NULL &&
+           bus->status == bus_thread_working)
+      EVENTBUS_COND_WAIT(&bus->stream_cond, &bus->queue_mutex);
+    if (atomic_fetch_sub_explicit(&bus->stream_waiters, 1, memory_order_relaxed) > 1)
+      EVENTBUS_COND_SIGNAL(&bus->stream_cond);
+    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+    if (chunk || bus->status != bus_thread_working)
+      return chunk;
   }
-  EVENTBUS_MUTEX_INIT(&bus->queue_mutex);
-  EVENTBUS_MUTEX_INIT(&bus->subs_mutex);
+}
 
-#if defined(CONFIG_IDF_TARGET)
-  // esp-idf specific
+EventStreamChunk *eventbus_stream_retain(Event *evt)
+{
+  if (evt->chunk == NULL || evt->chunk->size == 0)
+    return NULL;
+  atomic_fetch_add_explicit(&evt->chunk->refs, 1, memory_order_relaxed);
+  return evt->chunk;
+}
 
-  xTaskCreatePinnedToCore(eventbus_thread_func,
-                          bus->config.task_name,
-                          bus->config.task_stackSize,
-                          bus,
-                          bus->config.task_priority,
-                          &(bus->thread), bus->config.task_xCoreId);
+void eventbus_stream_release(EventBus *bus, EventStreamChunk *chunk)
+{
+  if (chunk && atomic_fetch_sub_explicit(&chunk->refs, 1, memory_order_acq_rel) == 1)
+    stream_chunk_free(bus, chunk);
+}
 
-#elif defined(_WIN32)
-  // Windows-specific
+int eventbus_stream_write(Event *evt, const void *buffer, size_t size)
+{
+  int res = evt->result.write_fn(evt->result.context, (void *)buffer, size);
+  if (res < 0)
+    evt->stream_failed = true;
+  return res;
+}
 
-  bus->thread = CreateThread(
-      NULL,                       // default security attributes
-      bus->config.task_stackSize, // use default stack size
-      eventbus_thread_func,       // thread function name
-      bus,                        // argument to thread function
-      0,                          // use default creation flags
-      &(bus->dwThreadId));        // returns the thread identifier
-#else
-  // Unix-specific
+// ==================== Запити ====================
 
-#endif
+// Молодші біти EventRequest.state – EventRequestStatus, наступний біт – встановлене продовження
+#define REQUEST_STATUS_MASK 0x03
+#define REQUEST_THEN 0x04
 
-  return 0;
+static EventRequest *request_at(EventBus *bus, uint16_t index)
+{
+  return (EventRequest *)(bus->request_pool.blocks + bus->request_pool.block_size * index);
 }
 
-EventBus *eventbus_create(EventBusConfig cfg)
+static void request_unref(EventBus *bus, EventRequest *request)
 {
-  EventBus *bus = (EventBus *)malloc(sizeof(EventBus));
-  if (eventbus_init(bus, &cfg) != 0)
+  if (atomic_fetch_sub_explicit(&request->refs, 1, memory_order_acq_rel) == 1)
+    eventbus_pool_release(&bus->request_pool, request);
+}
+
+/**
+ * @brief Завершує запит, викликає продовження та будить викликача, що на нього чекає.
+ *
+ * Пара до eventbus_request_wait: стан змінюється до перевірки waiting, а викликач виставляє
+ * waiting до перевірки стану (обидва seq_cst), тож хтось із двох обов’язково побачить іншого.
+ * Сигнал подається під request_mutex, щоб не загубитись між перевіркою стану та засинанням.
+ */
+static void request_complete(EventBus *bus, EventRequest *request, EventRequestStatus status)
+{
+  uint8_t old = atomic_fetch_or(&request->state, status);
+  if (old & REQUEST_THEN)
+    request->then_fn(bus, request, request->then_context);
+  if (atomic_load(&request->waiting))
   {
-    free(bus);
-    return NULL;
+    EVENTBUS_MUTEX_LOCK(&bus->request_mutex);
+    EVENTBUS_COND_SIGNAL(&request->cond);
+    EVENTBUS_MUTEX_UNLOCK(&bus->request_mutex);
   }
-  return bus;
+  request_unref(bus, request);
 }
 
 /**
- * @brief Зупиняє роботу EventBus.
- *
- * Встановлює прапорець завершення, сигналізує потоку та чекає його завершення,
- * після чого звільняє всі виділені ресурси.
+ * @brief Завершує результат події: викликає done_fn, якщо подію оброблено, та завершує її запит.
  *
  * @param bus Вказівник на EventBus.
+ * @param result Дані для повернення результату.
+ * @param status event_request_done після обробки, event_request_dropped, якщо подію викинуто.
  */
-void eventbus_stop(EventBus *bus)
+static void event_result_finish(EventBus *bus, EventResultData *result, EventRequestStatus status)
 {
-  bus->status = bus_thread_stopping;
-
-  while (bus->status != bus_thread_stoped)
-    TASK_DELAY(1);
-
-  free(bus->queue);
-  free(bus->subs);
-
-#if defined(CONFIG_IDF_TARGET)
-  // esp-idf specific
-
-  free(config.task_name);
+  if (status == event_request_done && result->done_fn)
+    result->done_fn(result->context);
+  if (result->request)
+  {
+    request_complete(bus, result->request, status);
+    result->request = NULL;
+  }
+}
 
-#elif defined(_WIN32)
-  // Windows-specific
+// ==================== Робота з чергою подій ====================
 
-#else
-  // Unix-specific
+#ifndef EVENTBUS_SHARD_BATCH
+// Скільки подій потік обробляє підряд з одного шарда, перш ніж відпустити його та переглянути інші.
+// Слоти цих подій звільняються після обробки всієї пачки.
+#define EVENTBUS_SHARD_BATCH 32
+#endif
 
+#ifndef EVENTBUS_LANE_AGING
+// Скільки пачок поспіль непорожня смуга нижчого пріоритету може поступитись вищим смугам.
+#define EVENTBUS_LANE_AGING 4
 #endif
+
+/**
+ * @brief Повертає шард, у який потрапляє подія.
+ */
+static EventShard *queue_shard(EventBus *bus, const Event *evt)
+{
+  uint32_t key = bus->config.shard_key_fn ? bus->config.shard_key_fn(evt) : evt->type.category;
+  return &bus->shards[key & bus->shard_mask];
 }
 
-// ==================== Робота з підписниками ====================
+/**
+ * @brief Повертає смугу шарда, в яку потрапляє подія.
+ */
+static EventQueue *queue_lane(EventBus *bus, EventShard *shard, const Event *evt)
+{
+  uint8_t lane = evt->priority < bus->config.lane_count ? evt->priority : bus->config.lane_count - 1;
+  return &shard->lanes[lane];
+}
 
-static void remove_subscriber(EventBus *bus, int idx)
+/**
+ * @brief Перевіряє, чи порожні всі смуги шарда.
+ */
+static bool shard_empty(EventBus *bus, EventShard *shard)
 {
-  // Видаляємо елемент із зв’язного списку
-  int prev = bus->subs[idx].prev;
-  int next = bus->subs[idx].next;
-  if (prev != -1)
-    bus->subs[prev].next = next;
-  else
-    bus->sub_head = next;
-  if (next != -1)
-    bus->subs[next].prev = prev;
-  bus->subs[idx].next = -1;
-  bus->subs[idx].prev = -1;
-  bus->subs[idx].status = sub_slot_free;
+  for (uint8_t lane = 0; lane < bus->config.lane_count; lane++)
+    if (!eventbus_queue_empty(&shard->lanes[lane]))
+      return false;
+  return true;
 }
 
 /**
- * @brief Вставляє підписника у двосторонній зв’язаний список за зростанням priority.
+ * @brief Будить один потік обробки, якщо хтось із них спить.
  *
- * Якщо priority співпадають, новий елемент вставляється після існуючих з таким же значенням.
- *
- * @param bus Вказівник на EventBus.
- * @param idx Індекс нового підписника в масиві bus->subs.
+ * Пара до fence у queue_wait: або потік побачить нову подію, або ми побачимо його в idle_workers.
+ * Сигнал подається під queue_mutex, щоб не загубитись між перевіркою шардів та засинанням.
  */
-static void insert_subscriber(EventBus *bus, int idx)
+static void queue_wake(EventBus *bus)
 {
-  // Якщо список порожній, новий елемент стає першим.
-  if (bus->sub_head == -1)
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&bus->idle_workers, memory_order_relaxed) != 0)
   {
-    bus->sub_head = idx;
-    bus->subs[idx].next = -1;
-    bus->subs[idx].prev = -1;
-    return;
+    EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+    EVENTBUS_COND_SIGNAL(&bus->queue_cond);
+    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
   }
+}
 
-  int cur = bus->sub_head;
-  int prev = -1;
-  while (cur != -1 && bus->subs[cur].priority <= bus->subs[idx].priority)
-  {
-    prev = cur;
-    cur = bus->subs[cur].next;
-  }
-  if (prev == -1)
-  {
-    // Вставка на початок списку
-    bus->subs[idx].next = bus->sub_head;
-    bus->subs[idx].prev = -1;
-    bus->subs[bus->sub_head].prev = idx;
-    bus->sub_head = idx;
-  }
-  else
+/**
+ * @brief Пробує захопити шард для роботи з його подіями як споживач.
+ *
+ * @return true, якщо шард захоплено; звільняється через shard_unclaim.
+ */
+static bool shard_claim(EventShard *shard)
+{
+  bool expected = false;
+  return atomic_compare_exchange_strong_explicit(&shard->busy, &expected, true,
+                                                 memory_order_acquire, memory_order_relaxed);
+}
+
+static void shard_unclaim(EventShard *shard)
+{
+  atomic_store_explicit(&shard->busy, false, memory_order_release);
+}
+
+/**
+ * @brief Будить продюсера, що чекає на місце в черзі шарда, якщо такий є.
+ *
+ * Пара до fence у queue_wait_space, так само як queue_wake до queue_wait.
+ */
+static void queue_space_wake(EventBus *bus, EventShard *shard)
+{
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&shard->blocked, memory_order_relaxed) != 0)
   {
-    // Вставка між prev та cur або в кінець
-    bus->subs[idx].next = cur;
-    bus->subs[idx].prev = prev;
-    bus->subs[prev].next = idx;
-    if (cur != -1)
-      bus->subs[cur].prev = idx;
+    EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+    EVENTBUS_COND_SIGNAL(&shard->space_cond);
+    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
   }
 }
 
-static int sub_finde_free_slot(EventBus *bus)
+/**
+ * @brief Присипляє продюсера, поки в смузі шарда не з’явиться місце для його події.
+ *
+ * Подія, що описується самим дескриптором, чекає лише на вільний слот, інша – ще й на запис
+ * бічної таблиці. Продюсер, що прокинувся, будить наступного з тих, хто чекає на цей шард: сигнал подається
+ * один раз на звільнену пачку слотів, а умовна змінна на FreeRTOS не вміє будити всіх одразу.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param shard Вказівник на шард.
+ * @param queue Смуга шарда, в якій потрібне місце.
+ * @param evt Подія, для якої потрібне місце.
+ * @param deadline Момент EVENTBUS_TIME_MS(), після якого чекати вже не можна; UINT64_MAX – без обмеження.
+ * @return true, якщо місце з’явилось; false після таймауту або при зупинці EventBus.
+ */
+static bool queue_wait_space(EventBus *bus, EventShard *shard, EventQueue *queue, const Event *evt, uint64_t deadline)
 {
-  for (size_t i = 0; i < bus->config.subs_array_size; i++)
+  bool has_space = true;
+  EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+  atomic_fetch_add_explicit(&shard->blocked, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  while (!eventbus_queue_fits(queue, evt))
   {
-    if (bus->subs[i].status == sub_slot_free)
+    if (bus->status != bus_thread_working)
     {
-      return i;
+      has_space = false;
+      break;
+    }
+    if (deadline == UINT64_MAX)
+    {
+      EVENTBUS_COND_WAIT(&shard->space_cond, &bus->queue_mutex);
+      continue;
+    }
+    uint64_t now = EVENTBUS_TIME_MS();
+    if (now >= deadline)
+    {
+      has_space = false;
+      break;
     }
+    EVENTBUS_COND_TIMEDWAIT(&shard->space_cond, &bus->queue_mutex, (uint32_t)(deadline - now));
   }
-  return -1;
+  if (atomic_fetch_sub_explicit(&shard->blocked, 1, memory_order_relaxed) > 1)
+    EVENTBUS_COND_SIGNAL(&shard->space_cond);
+  if (bus->status != bus_thread_working)
+    EVENTBUS_COND_SIGNAL(&bus->stop_cond); // eventbus_stop чекає, поки продюсери вийдуть з очікування
+  EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+  return has_space;
 }
 
-static EventSubscriber *sub_add(EventBus *bus, EventType type, uint8_t priority, void *context, EventCallback callback)
+/**
+ * @brief Викидає найстарішу необроблену подію смуги шарда та звільняє її дані.
+ *
+ * @return true, якщо подію викинуто; false, якщо шард зараз обробляє потік
+ *         або найстаріша подія ще записується.
+ */
+static bool queue_drop_oldest(EventBus *bus, EventShard *shard, EventQueue *queue)
 {
-  int free_slot = sub_finde_free_slot(bus);
-  if (free_slot == -1)
+  if (!shard_claim(shard))
+    return false;
+  Event dropped;
+  bool done = eventbus_queue_pop(queue, &dropped) == 0;
+  shard_unclaim(shard);
+  if (done)
   {
-    return NULL; // немає вільного слоту
+    event_input_release(bus, &dropped.input);
+    event_result_finish(bus, &dropped.result, event_request_dropped);
+    EVENTBUS_STAT_ADD(bus->stats, evicted, 1);
   }
-  bus->subs[free_slot].status = sub_slot_used;
-  bus->subs[free_slot].type = type;
-  bus->subs[free_slot].priority = priority;
-  bus->subs[free_slot].context = context;
-  bus->subs[free_slot].callback = callback;
-  bus->subs[free_slot].next = -1;
-  bus->subs[free_slot].prev = -1;
-  // Вставка підписника у зв’язаний список
-  insert_subscriber(bus, free_slot);
-  return &bus->subs[free_slot];
+  return done;
 }
 
 /**
- * @brief Додає нового підписника до EventBus.
- *
- * Шукає вільний слот у масиві підписників, заповнює його інформацією та вставляє у зв’язаний список.
- *
- * @param bus Вказівник на EventBus.
- * @param type Тип події для підписки.
- * @param priority Пріоритет підписника.
- * @param context Контекст підписника.
- * @param callback Callback для обробки події.
- * @return Вказівник на структуру EventSubscriber при успіху, або NULL при помилці.
+ * @brief Викидає саму нову подію замість найстарішої: дані звільняються, запит завершується як викинутий.
  */
-EventSubscriber *eventbus_subscribe(EventBus *bus, EventType type, uint8_t priority, void *context, EventCallback callback)
+static void queue_discard(EventBus *bus, Event *evt)
 {
-  EventSubscriber *ret = NULL;
-
-  EVENTBUS_MUTEX_LOCK(&bus->subs_mutex);
-
-  ret = sub_add(bus, type, priority, context, callback);
-
-  EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
-
-  return ret;
+  event_input_release(bus, &evt->input);
+  event_result_finish(bus, &evt->result, event_request_dropped);
+  EVENTBUS_STAT_ADD(bus->stats, evicted, 1);
 }
 
 /**
- * @brief Видаляє підписника з EventBus.
+ * @brief Замінює дані найновішої необробленої події того ж типу в смузі шарда даними evt.
  *
- * Видаляє елемент зі зв’язного списку та маркує слот як вільний.
+ * Замінена подія залишається на своєму місці в черзі, тож порядок решти подій не змінюється.
+ * Запит заміненої події завершується як викинутий, вже після звільнення шарда.
+ *
+ * @return 1, якщо подію замінено; 0, якщо подій того ж типу в черзі немає;
+ *         -1, якщо шард зараз обробляє потік або для evt немає вільного запису бічної таблиці.
+ */
+static int queue_coalesce(EventBus *bus, EventShard *shard, EventQueue *queue, const Event *evt)
+{
+  if (!shard_claim(shard))
+    return -1;
+  Event old;
+  int replaced = eventbus_queue_replace_newest(queue, evt, &old);
+  if (replaced == 1)
+  {
+    event_input_release(bus, &old.input);
+    EVENTBUS_STAT_ADD(bus->stats, coalesced, 1);
+  }
+  shard_unclaim(shard);
+  // Поки шард був захоплений, потік обробки міг його пропустити й заснути
+  queue_wake(bus);
+  if (replaced == 1)
+    event_result_finish(bus, &old.result, event_request_dropped);
+  return replaced;
+}
+
+// ==================== Теми з останнім значенням ====================
+
+static inline uint16_t event_key(EventType type);
+
+/**
+ * @brief Шукає тему з останнім значенням для типу події.
+ *
+ * Теми лише додаються, тож масив читається без м’ютекса до опублікованої кількості.
+ *
+ * @return Тема або NULL, якщо тип не в режимі останнього значення.
+ */
+static EventTopic *topic_find(EventBus *bus, EventType type)
+{
+  uint16_t count = atomic_load_explicit(&bus->topic_count, memory_order_acquire);
+  uint16_t key = event_key(type);
+  for (uint16_t i = 0; i < count; i++)
+    if (bus->topics[i].key == key)
+      return &bus->topics[i];
+  return NULL;
+}
+
+/**
+ * @brief Додає тему в кінець черги готових. Викликається під topic_mutex.
+ */
+static void topic_ready_push(EventBus *bus, EventTopic *topic)
+{
+  topic->ready_next = NULL;
+  if (bus->topic_ready_tail)
+    bus->topic_ready_tail->ready_next = topic;
+  else
+    atomic_store_explicit(&bus->topic_ready, topic, memory_order_relaxed);
+  bus->topic_ready_tail = topic;
+}
+
+/**
+ * @brief Публікує значення теми: замінює необроблене або ставить тему в чергу готових.
+ *
+ * @return 0.
+ */
+static int topic_publish(EventBus *bus, EventTopic *topic, const Event *evt)
+{
+  Event old;
+  EVENTBUS_MUTEX_LOCK(&bus->topic_mutex);
+  bool replaced = topic->pending;
+  if (replaced)
+    old = topic->event;
+  topic->event = *evt;
+  EVENTBUS_STAT(topic->event.enqueue_ns = EVENTBUS_TIME_NS());
+  topic->pending = true;
+  bool ready = !topic->queued;
+  if (ready)
+  {
+    topic->queued = true;
+    topic_ready_push(bus, topic);
+  }
+  EVENTBUS_MUTEX_UNLOCK(&bus->topic_mutex);
+
+  EVENTBUS_STAT_ADD(bus->stats, published, 1);
+  if (replaced)
+  {
+    EVENTBUS_STAT_ADD(bus->stats, coalesced, 1);
+    event_input_release(bus, &old.input);
+    event_result_finish(bus, &old.result, event_request_dropped);
+  }
+  if (ready)
+    queue_wake(bus);
+  return 0;
+}
+
+/**
+ * @brief Викидає необроблені значення всіх тем. Викликається при зупинці.
+ */
+static void topics_discard(EventBus *bus)
+{
+  uint16_t count = bus->topics ? atomic_load(&bus->topic_count) : 0;
+  for (uint16_t i = 0; i < count; i++)
+  {
+    EventTopic *topic = &bus->topics[i];
+    if (topic->pending)
+    {
+      event_input_release(bus, &topic->event.input);
+      event_result_finish(bus, &topic->event.result, event_request_dropped);
+    }
+    topic->pending = topic->queued = false;
+  }
+  atomic_store(&bus->topic_ready, NULL);
+  bus->topic_ready_tail = NULL;
+}
+
+/**
+ * @brief Рахує публікацію, відхилену через брак місця в черзі.
+ *
+ * @return -1.
+ */
+static int queue_reject(EventBus *bus)
+{
+  (void)bus; // без EVENTBUS_STATS лічильника немає
+  EVENTBUS_STAT_ADD(bus->stats, rejected, 1);
+  return -1;
+}
+
+/**
+ * @brief Додає подію до смуги її шарда.
+ *
+ * Запис у чергу не бере жодного м’ютекса; м’ютекс потрібен лише продюсерам,
+ * які засинають в очікуванні місця. Подія типу в режимі останнього значення в чергу
+ * не потрапляє, а стає значенням своєї теми.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param evt Вказівник на подію.
+ * @param policy Що робити, якщо черга переповнена.
+ * @param timeout_ms Максимальне очікування для event_overflow_timeout, мс.
+ * @return 0 при успіху, -1 якщо подію не вдалось додати.
+ */
+static int queue_push(EventBus *bus, Event *evt, EventOverflowPolicy policy, uint32_t timeout_ms)
+{
+  EventTopic *topic = topic_find(bus, evt->type);
+  if (topic)
+    return topic_publish(bus, topic, evt);
+
+  EventShard *shard = queue_shard(bus, evt);
+  EventQueue *queue = queue_lane(bus, shard, evt);
+  uint64_t deadline = UINT64_MAX;
+  if (policy == event_overflow_timeout && timeout_ms != EVENTBUS_WAIT_FOREVER)
+    deadline = EVENTBUS_TIME_MS() + timeout_ms;
+  EVENTBUS_STAT(evt->enqueue_ns = EVENTBUS_TIME_NS());
+
+  int pushed;
+  while ((pushed = eventbus_queue_push(queue, evt)) != 0)
+  {
+    switch (policy)
+    {
+    case event_overflow_drop_oldest:
+      // Викидання простих подій записів бічної таблиці не звільнить, а в кільці місце є
+      if (pushed == EVENTBUS_QUEUE_NO_EXT)
+        return queue_reject(bus);
+      if (queue_drop_oldest(bus, shard, queue))
+        continue;
+      // Шард обробляє потік, можливо цей самий (підписник публікує у свій шард): чекати не можна,
+      // тож викидається нова подія
+      queue_discard(bus, evt);
+      return 0;
+    case event_overflow_coalesce:
+      if (queue_coalesce(bus, shard, queue, evt) == 1)
+        return 0;
+      return queue_reject(bus); // замінити нічого або шард обробляє потік
+    case event_overflow_block:
+    case event_overflow_timeout:
+      break;
+    default:
+      return queue_reject(bus); // черга переповнена
+    }
+    if (!queue_wait_space(bus, shard, queue, evt, deadline))
+      return queue_reject(bus);
+  }
+
+  EVENTBUS_STAT_ADD(bus->stats, published, 1);
+  EVENTBUS_STAT(eventbus_stats_depth(bus->stats, (uint32_t)eventbus_queue_depth(queue)));
+  queue_wake(bus);
+  return 0;
+}
+
+/**
+ * @brief Перевіряє, чи є шард, який можна взяти в обробку.
+ */
+static bool queue_has_work(EventBus *bus)
+{
+  if (atomic_load_explicit(&bus->async_ready, memory_order_relaxed) != NULL ||
+      atomic_load_explicit(&bus->topic_ready, memory_order_relaxed) != NULL)
+    return true;
+  for (size_t i = 0; i <= bus->shard_mask; i++)
+  {
+    EventShard *shard = &bus->shards[i];
+    if (!atomic_load_explicit(&shard->busy, memory_order_relaxed) && !shard_empty(bus, shard))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Присипляє потік обробки, поки не з’явиться шард з подіями або EventBus не почне зупинку.
+ *
+ * Шард, зайнятий іншим потоком, не будить: той потік після звільнення шарда сам перегляне всі шарди.
+ *
+ * @param bus Вказівник на EventBus.
+ */
+static void queue_wait(EventBus *bus)
+{
+  EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+  atomic_fetch_add_explicit(&bus->idle_workers, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  while (!queue_has_work(bus) && bus->status == bus_thread_working)
+    EVENTBUS_COND_WAIT(&bus->queue_cond, &bus->queue_mutex);
+  atomic_fetch_sub_explicit(&bus->idle_workers, 1, memory_order_relaxed);
+  EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+}
+
+// ==================== Таблиця диспетчеризації ====================
+
+static EventSubscriber *sub_handle(EventBus *bus, uint16_t index);
+static int sub_grow(EventBus *bus);
+
+#ifndef EVENTBUS_DISPATCH_LINEAR
+// До скількох записів знімок переглядається послідовно замість двійкового пошуку.
+#define EVENTBUS_DISPATCH_LINEAR 64
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EVENTBUS_KEYS_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define EVENTBUS_KEYS_NEON
+#endif
+
+static inline uint16_t event_key(EventType type)
+{
+  return (uint16_t)((type.category << 8) | type.id);
+}
+
+static int dispatch_key_cmp(const void *a, const void *b)
+{
+  return (int)((const EventDispatchEntry *)a)->key - (int)((const EventDispatchEntry *)b)->key;
+}
+
+/**
+ * @brief Шукає ключ в упакованому масиві 16-бітних ключів послідовним переглядом.
+ *
+ * Ключі порівнюються по 8 за раз (SSE2/NEON, якщо доступні); блок, у якому знайдено збіг,
+ * і хвіст масиву доглядаються поелементно.
+ *
+ * @param keys Масив ключів.
+ * @param count Кількість ключів.
+ * @param key Ключ.
+ * @return Індекс першого збігу або count, якщо ключа немає.
+ */
+static size_t keys_find(const uint16_t *keys, size_t count, uint16_t key)
+{
+  size_t i = 0;
+#if defined(EVENTBUS_KEYS_SSE2)
+  __m128i needle = _mm_set1_epi16((short)key);
+  for (; i + 8 <= count; i += 8)
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(keys + i)), needle)) != 0)
+      break;
+#elif defined(EVENTBUS_KEYS_NEON)
+  uint16x8_t needle = vdupq_n_u16(key);
+  for (; i + 8 <= count; i += 8)
+  {
+    uint16x8_t eq = vceqq_u16(vld1q_u16(keys + i), needle);
+    uint16x4_t any = vorr_u16(vget_low_u16(eq), vget_high_u16(eq));
+    if (vget_lane_u64(vreinterpret_u64_u16(any), 0) != 0)
+      break;
+  }
+#endif
+  for (; i < count; i++)
+    if (keys[i] == key)
+      return i;
+  return count;
+}
+
+/**
+ * @brief Шукає перший ключ >= заданого у відсортованому упакованому масиві ключів.
+ *
+ * @param keys Ключі, відсортовані за зростанням.
+ * @param count Кількість ключів.
+ * @param key Ключ.
+ * @return Індекс або count, якщо такого немає.
+ */
+static int keys_lower_bound(const uint16_t *keys, int count, uint16_t key)
+{
+  int lo = 0, hi = count;
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (keys[mid] < key)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * @brief Знаходить запис з заданим ключем у відсортованих записах таблиці диспетчеризації.
+ *
+ * @param keys Ключі записів.
+ * @param entries Записи, у тому ж порядку, що й keys.
+ * @param count Кількість записів.
+ * @param key Ключ.
+ * @return Вказівник на запис або NULL, якщо такого ключа немає.
+ */
+static const EventDispatchEntry *entries_find(const uint16_t *keys, const EventDispatchEntry *entries, size_t count,
+                                              uint16_t key)
+{
+  size_t e;
+  if (count <= EVENTBUS_DISPATCH_LINEAR)
+    e = keys_find(keys, count, key);
+  else
+  {
+    e = (size_t)keys_lower_bound(keys, (int)count, key);
+    if (e < count && keys[e] != key)
+      e = count;
+  }
+  return e < count ? &entries[e] : NULL;
+}
+
+/**
+ * @brief Знаходить запис знімка з заданим ключем підписки.
+ *
+ * @param snap Вказівник на знімок.
+ * @param key Ключ.
+ * @return Вказівник на запис або NULL, якщо на цей ключ ніхто не підписаний.
+ */
+static const EventDispatchEntry *dispatch_find(const EventDispatchSnapshot *snap, uint16_t key)
+{
+  return entries_find(snap->keys, snap->entries, snap->entry_count, key);
+}
+
+static void rcu_reclaim(EventBus *bus);
+
+/**
+ * @brief Виділяє пам’ять під знімок таблиці диспетчеризації. Викликається під subs_mutex.
+ *
+ * При розміщенні в пам’яті викликача знімок береться зі списку dispatch_spare буферів найбільшого
+ * розміру. Якщо вільних буферів немає, спершу звільняються знімки, з яких вийшли читачі.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param size Розмір знімка, байт.
+ * @return Пам’ять або NULL, якщо її немає.
+ */
+static EventDispatchSnapshot *dispatch_alloc(EventBus *bus, size_t size)
+{
+  if (!bus->arena.base)
+    return (EventDispatchSnapshot *)malloc(size);
+  if (!bus->dispatch_spare)
+    rcu_reclaim(bus);
+  EventDispatchSnapshot *snap = bus->dispatch_spare;
+  if (snap)
+    bus->dispatch_spare = snap->retired_next;
+  return snap;
+}
+
+/**
+ * @brief Будує новий знімок таблиці диспетчеризації з таблиці підписників. Викликається під subs_mutex.
+ *
+ * Рядки таблиці підписників вже впорядковані за пріоритетом, тож кожен запис заповнюється
+ * відсортованим, а номер рядка стає рангом підписника для злиття записів при обробці.
+ * Кожен підписник потрапляє рівно в один запис, тому розмір знімка пропорційний кількості підписників.
+ * Ключі збираються в робочому буфері dispatch_keys, після чого знімок розміщується одним блоком
+ * пам’яті точного розміру.
+ *
+ * @param bus Вказівник на EventBus.
+ * @return Новий знімок або NULL при помилці виділення пам’яті.
+ */
+static EventDispatchSnapshot *dispatch_build(EventBus *bus)
+{
+  EventDispatchEntry *keys = bus->dispatch_keys;
+
+  // Збираємо ключі: глобальний запис завжди є і має індекс 0
+  int n = 0;
+  keys[n++].key = 0;
+  for (uint16_t row = 0; row < bus->sub_count; row++)
+    if (bus->sub_keys[row] != 0)
+      keys[n++].key = bus->sub_keys[row];
+  qsort(keys, n, sizeof(EventDispatchEntry), dispatch_key_cmp);
+  int count = 0;
+  for (int i = 0; i < n; i++)
+  {
+    if (count > 0 && keys[count - 1].key == keys[i].key)
+      continue;
+    keys[count].key = keys[i].key;
+    keys[count].count = 0;
+    count++;
+  }
+
+  // Заголовок, items, entries та keys в одному блоці, у порядку спадання вирівнювання
+  size_t total = bus->sub_count;
+  EventDispatchSnapshot *snap = dispatch_alloc(bus, sizeof(EventDispatchSnapshot) +
+                                                        sizeof(EventDispatchItem) * total +
+                                                        sizeof(EventDispatchEntry) * count +
+                                                        sizeof(uint16_t) * count);
+  if (!snap)
+    return NULL;
+  snap->retired_next = NULL;
+  snap->version = ++bus->dispatch_version;
+  snap->entry_count = (uint16_t)count;
+  snap->items = (EventDispatchItem *)(snap + 1);
+  snap->entries = (EventDispatchEntry *)(snap->items + total);
+  snap->keys = (uint16_t *)(snap->entries + count);
+  for (int e = 0; e < count; e++)
+    snap->keys[e] = keys[e].key;
+
+  // Рахуємо розміри записів і розкладаємо їх у масиві items
+  for (uint16_t row = 0; row < bus->sub_count; row++)
+    keys[keys_lower_bound(snap->keys, count, bus->sub_keys[row])].count++;
+  uint32_t offset = 0;
+  for (int e = 0; e < count; e++)
+  {
+    keys[e].offset = offset;
+    offset += keys[e].count;
+    keys[e].count = 0;
+  }
+
+  for (uint16_t row = 0; row < bus->sub_count; row++)
+  {
+    EventDispatchEntry *entry = &keys[keys_lower_bound(snap->keys, count, bus->sub_keys[row])];
+    EventDispatchItem *item = &snap->items[entry->offset + entry->count++];
+    EventSubscriber *sub = sub_handle(bus, bus->sub_slots[row]);
+    item->callback = bus->sub_callbacks[row];
+    item->context = bus->sub_contexts[row];
+    item->sub = sub;
+    item->generation = atomic_load_explicit(&sub->generation, memory_order_relaxed);
+    item->rank = row;
+    item->async = sub->async;
+    item->priority = bus->sub_priorities[row];
+  }
+  memcpy(snap->entries, keys, sizeof(EventDispatchEntry) * count);
+  return snap;
+}
+
+// ==================== Статичні підписники ====================
+
+#if defined(EVENTBUS_STATIC_SUBS_SECTION)
+#if defined(CONFIG_IDF_TARGET)
+// Межі секції задає SURROUND у фрагменті лінкера linker.lf
+extern const EventStaticSubscriber _eventbus_subs_start[];
+extern const EventStaticSubscriber _eventbus_subs_end[];
+#define STATIC_SUBS_BEGIN _eventbus_subs_start
+#define STATIC_SUBS_END _eventbus_subs_end
+#else
+// Межі секції генерує лінкер; якщо в програмі немає жодного дескриптора, слабкі символи дорівнюють NULL
+extern const EventStaticSubscriber __start_eventbus_subs[] __attribute__((weak));
+extern const EventStaticSubscriber __stop_eventbus_subs[] __attribute__((weak));
+#define STATIC_SUBS_BEGIN __start_eventbus_subs
+#define STATIC_SUBS_END __stop_eventbus_subs
+#endif
+#else
+#define STATIC_SUBS_BEGIN ((const EventStaticSubscriber *)NULL)
+#define STATIC_SUBS_END ((const EventStaticSubscriber *)NULL)
+#endif
+
+/**
+ * @brief Кількість дескрипторів у секції eventbus_subs.
+ */
+static size_t static_subs_count(void)
+{
+  size_t count = (size_t)(STATIC_SUBS_END - STATIC_SUBS_BEGIN);
+  return count < UINT16_MAX ? count : UINT16_MAX;
+}
+
+static int static_sub_cmp(const void *a, const void *b)
+{
+  uint16_t i = *(const uint16_t *)a, j = *(const uint16_t *)b;
+  const EventStaticSubscriber *x = &STATIC_SUBS_BEGIN[i], *y = &STATIC_SUBS_BEGIN[j];
+  if (x->key != y->key)
+    return x->key < y->key ? -1 : 1;
+  if (x->priority != y->priority)
+    return x->priority < y->priority ? -1 : 1;
+  return i < j ? -1 : (i > j);
+}
+
+/**
+ * @brief Будує таблицю диспетчеризації статичних підписників.
+ *
+ * Дескриптори в секції не впорядковані (порядок задає лінкер), тож сортуються лише їх 16‑бітні
+ * індекси: за ключем, потім за пріоритетом і порядком у секції.
+ *
+ * @param bus Вказівник на EventBus.
+ * @return 0 при успіху, -1 при помилці виділення пам’яті.
+ */
+static int static_dispatch_init(EventBus *bus)
+{
+  EventStaticDispatch *st = &bus->statics;
+  size_t count = bus->config.static_subscribers ? static_subs_count() : 0;
+  if (count == 0)
+    return 0;
+  st->subs = STATIC_SUBS_BEGIN;
+  st->order = (uint16_t *)eventbus_arena_alloc(&bus->arena, sizeof(uint16_t) * count);
+  st->keys = (uint16_t *)eventbus_arena_alloc(&bus->arena, sizeof(uint16_t) * count);
+  st->entries = (EventDispatchEntry *)eventbus_arena_alloc(&bus->arena, sizeof(EventDispatchEntry) * count);
+  if (!st->order || !st->keys || !st->entries)
+    return -1;
+
+  // Порожні записи, якщо вони є, – вирівнювання між дескрипторами різних об’єктних файлів
+  size_t n = 0;
+  for (size_t i = 0; i < count; i++)
+    if (st->subs[i].callback)
+      st->order[n++] = (uint16_t)i;
+  qsort(st->order, n, sizeof(uint16_t), static_sub_cmp);
+
+  uint16_t entry_count = 0;
+  for (size_t i = 0; i < n; i++)
+  {
+    uint16_t key = st->subs[st->order[i]].key;
+    if (entry_count == 0 || st->keys[entry_count - 1] != key)
+    {
+      st->keys[entry_count] = key;
+      st->entries[entry_count].key = key;
+      st->entries[entry_count].count = 0;
+      st->entries[entry_count].offset = (uint32_t)i;
+      entry_count++;
+    }
+    st->entries[entry_count - 1].count++;
+  }
+  st->entry_count = entry_count;
+  return 0;
+}
+
+static void static_dispatch_free(EventBus *bus)
+{
+  EventStaticDispatch *st = &bus->statics;
+  eventbus_arena_free(&bus->arena, st->order);
+  eventbus_arena_free(&bus->arena, st->keys);
+  eventbus_arena_free(&bus->arena, st->entries);
+  st->subs = NULL;
+  st->entry_count = 0;
+  st->order = NULL;
+  st->keys = NULL;
+  st->entries = NULL;
+}
+
+// ==================== RCU для знімків підписників ====================
+
+/**
+ * @brief Реєструє читача знімка в поточній епосі.
+ *
+ * Лічильник збільшується до повторної перевірки епохи: якщо епоха встигла змінитись,
+ * реєстрація відкочується і повторюється, тож письменник ніколи не пропустить читача.
+ *
+ * @param bus Вказівник на EventBus.
+ * @return Епоха, яку треба передати в rcu_read_unlock.
+ */
+static uint32_t rcu_read_lock(EventBus *bus)
+{
+  while (true)
+  {
+    uint32_t epoch = atomic_load(&bus->rcu_epoch);
+    atomic_fetch_add(&bus->rcu_readers[epoch & 1], 1);
+    if (atomic_load(&bus->rcu_epoch) == epoch)
+      return epoch;
+    atomic_fetch_sub(&bus->rcu_readers[epoch & 1], 1);
+  }
+}
+
+static void rcu_read_unlock(EventBus *bus, uint32_t epoch)
+{
+  atomic_fetch_sub_explicit(&bus->rcu_readers[epoch & 1], 1, memory_order_release);
+}
+
+static void rcu_free_list(EventBus *bus, EventDispatchSnapshot *snap)
+{
+  while (snap)
+  {
+    EventDispatchSnapshot *next = snap->retired_next;
+    if (bus->arena.base)
+    {
+      snap->retired_next = bus->dispatch_spare;
+      bus->dispatch_spare = snap;
+    }
+    else
+      free(snap);
+    snap = next;
+  }
+}
+
+/**
+ * @brief Звільняє знімки, з яких вийшли всі читачі. Викликається під subs_mutex.
+ *
+ * Знімок, замінений в епосі e, може бути в руках читачів епох e та e-1. Тому епоха перемикається
+ * на e+1 лише коли читачів епохи e-1 немає, а список rcu_waiting звільняється, коли після
+ * перемикання зникнуть і читачі епохи e. Функція ніколи не чекає: якщо читачі ще працюють,
+ * знімки залишаються в списках до наступної підписки чи відписки.
+ *
+ * @param bus Вказівник на EventBus.
+ */
+static void rcu_reclaim(EventBus *bus)
+{
+  uint32_t epoch = atomic_load(&bus->rcu_epoch);
+  if (bus->rcu_waiting && atomic_load(&bus->rcu_readers[(epoch - 1) & 1]) == 0)
+  {
+    rcu_free_list(bus, bus->rcu_waiting);
+    bus->rcu_waiting = NULL;
+  }
+  if (bus->rcu_waiting || !bus->rcu_pending || atomic_load(&bus->rcu_readers[(epoch - 1) & 1]) != 0)
+    return;
+
+  atomic_store(&bus->rcu_epoch, epoch + 1);
+  bus->rcu_waiting = bus->rcu_pending;
+  bus->rcu_pending = NULL;
+  if (atomic_load(&bus->rcu_readers[epoch & 1]) == 0)
+  {
+    rcu_free_list(bus, bus->rcu_waiting);
+    bus->rcu_waiting = NULL;
+  }
+}
+
+/**
+ * @brief Будує та публікує новий знімок таблиці диспетчеризації. Викликається під subs_mutex.
+ *
+ * @param bus Вказівник на EventBus.
+ * @return 0 при успіху, -1 при помилці виділення пам’яті (поточний знімок не змінюється).
+ */
+static int dispatch_publish(EventBus *bus)
+{
+  EventDispatchSnapshot *snap = dispatch_build(bus);
+  if (!snap)
+    return -1;
+  EventDispatchSnapshot *old = atomic_exchange(&bus->dispatch, snap);
+  if (old)
+  {
+    old->retired_next = bus->rcu_pending;
+    bus->rcu_pending = old;
+  }
+  rcu_reclaim(bus);
+  return 0;
+}
+
+// ==================== Асинхронні підписники ====================
+
+// Стани EventAsyncTask.state
+#define ASYNC_RUNNING 0   // callback виконується
+#define ASYNC_SUSPENDED 1 // callback повернув event_async_pending і чекає на eventbus_async_resume
+#define ASYNC_RESUMED 2   // eventbus_async_resume прийшов, поки callback виконувався
+#define ASYNC_READY 3     // задача в стеку async_ready
+
+/**
+ * @brief Будить потік, що чекає на вільну задачу чи стан події. Пара до fence в async_alloc.
+ */
+static void async_wake(EventBus *bus)
+{
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&bus->async_waiters, memory_order_relaxed) != 0)
+  {
+    EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+    EVENTBUS_COND_SIGNAL(&bus->async_cond);
+    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+  }
+}
+
+/**
+ * @brief Відпускає спільний стан події; останній власник завершує подію.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param group Вказівник на спільний стан.
+ * @param status event_request_dropped, якщо власник не дообробив подію.
+ */
+static void async_group_unref(EventBus *bus, EventAsyncGroup *group, EventRequestStatus status)
+{
+  if (status != event_request_done)
+    atomic_store_explicit(&group->status, status, memory_order_relaxed);
+  if (atomic_fetch_sub_explicit(&group->refs, 1, memory_order_acq_rel) != 1)
+    return;
+  event_result_finish(bus, &group->event.result, atomic_load_explicit(&group->status, memory_order_relaxed));
+  event_input_release(bus, &group->event.input);
+  eventbus_pool_release(&bus->async_group_pool, group);
+  async_wake(bus);
+}
+
+static void async_task_finish(EventBus *bus, EventAsyncTask *task, EventRequestStatus status)
+{
+  EventAsyncGroup *group = task->group;
+  if (task->event.chunk != &task->stream_end)
+    eventbus_stream_release(bus, task->event.chunk);
+  task->callback = NULL;
+  eventbus_pool_release(&bus->async_task_pool, task);
+  async_wake(bus);
+  async_group_unref(bus, group, status);
+}
+
+/**
+ * @brief Викликає асинхронного підписника, доки він не призупиниться або не завершиться.
+ *
+ * Якщо eventbus_async_resume прийшов під час виклику, підписник викликається знову одразу:
+ * стан задачі перемикається з ASYNC_RUNNING на ASYNC_SUSPENDED лише атомарним CAS.
+ */
+static void async_step(EventBus *bus, EventAsyncTask *task)
+{
+  while (true)
+  {
+    atomic_store_explicit(&task->state, ASYNC_RUNNING, memory_order_relaxed);
+    if (task->callback(&task->event, task, task->context) == event_async_done)
+    {
+      async_task_finish(bus, task, event_request_done);
+      return;
+    }
+    uint8_t expected = ASYNC_RUNNING;
+    if (atomic_compare_exchange_strong_explicit(&task->state, &expected, ASYNC_SUSPENDED,
+                                                memory_order_acq_rel, memory_order_acquire))
+      return;
+  }
+}
+
+/**
+ * @brief Виконує задачі, відновлені через eventbus_async_resume.
+ *
+ * @return true, якщо хоч одна задача виконувалась.
+ */
+static bool async_run_ready(EventBus *bus)
+{
+  if (atomic_load_explicit(&bus->async_ready, memory_order_relaxed) == NULL)
+    return false;
+  EventAsyncTask *list = atomic_exchange_explicit(&bus->async_ready, NULL, memory_order_acquire);
+
+  // Стек віддає задачі у зворотному порядку, а виконуються вони в порядку відновлення
+  EventAsyncTask *ordered = NULL;
+  while (list)
+  {
+    EventAsyncTask *next = list->ready_next;
+    list->ready_next = ordered;
+    ordered = list;
+    list = next;
+  }
+  while (ordered)
+  {
+    EventAsyncTask *next = ordered->ready_next;
+    async_step(bus, ordered);
+    ordered = next;
+  }
+  return true;
+}
+
+/**
+ * @brief Бере блок з пулу задач або спільних станів, чекаючи, поки якась задача завершиться.
+ *
+ * Блоки повертають лише задачі, що завершуються, тож поки вільних немає, потік сам виконує
+ * відновлені задачі, а якщо їх немає – спить на async_cond.
+ *
+ * @return Блок або NULL, якщо пул порожній або EventBus зупиняється.
+ */
+static void *async_alloc(EventBus *bus, EventPool *pool)
+{
+  while (true)
+  {
+    void *block = eventbus_pool_alloc(pool);
+    if (block || pool->block_count == 0)
+      return block;
+    if (async_run_ready(bus))
+      continue;
+
+    EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+    atomic_fetch_add_explicit(&bus->async_waiters, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    while ((block = eventbus_pool_alloc(pool)) == NULL &&
+           atomic_load_explicit(&bus->async_ready, memory_order_relaxed) == NULL &&
+           bus->status == bus_thread_working)
+      EVENTBUS_COND_WAIT(&bus->async_cond, &bus->queue_mutex);
+    if (atomic_fetch_sub_explicit(&bus->async_waiters, 1, memory_order_relaxed) > 1)
+      EVENTBUS_COND_SIGNAL(&bus->async_cond);
+    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+    if (block || bus->status != bus_thread_working)
+      return block;
+  }
+}
+
+/**
+ * @brief Запускає асинхронного підписника для події.
+ *
+ * Задача отримує власну копію події, а шматок потокової події утримується до її завершення.
+ * Спільний стан події створюється при першому асинхронному підписнику.
+ *
+ * @return false, якщо EventBus зупиняється і підписника не запущено.
+ */
+static bool async_start(EventBus *bus, Event *evt, const EventDispatchItem *item, EventAsyncGroup **group)
+{
+  if (*group == NULL)
+  {
+    *group = (EventAsyncGroup *)async_alloc(bus, &bus->async_group_pool);
+    if (*group == NULL)
+      return false;
+    atomic_store_explicit(&(*group)->refs, 1, memory_order_relaxed);
+    atomic_store_explicit(&(*group)->status, event_request_done, memory_order_relaxed);
+  }
+  EventAsyncTask *task = (EventAsyncTask *)async_alloc(bus, &bus->async_task_pool);
+  if (task == NULL)
+    return false;
+
+  task->event = *evt;
+  event_input_bind(&task->event.input);
+  if (evt->chunk && eventbus_stream_retain(evt) == NULL)
+  {
+    // Порожній останній шматок живе на стеку обробника потоку
+    memcpy(&task->stream_end, evt->chunk, sizeof(EventStreamChunk));
+    task->event.chunk = &task->stream_end;
+  }
+  task->callback = item->callback.async;
+  task->context = item->context;
+  task->group = *group;
+  task->resume_point = 0;
+  task->locals = NULL;
+  task->cancelled = false;
+  atomic_fetch_add_explicit(&(*group)->refs, 1, memory_order_relaxed);
+  async_step(bus, task);
+  return true;
+}
+
+/**
+ * @brief Востаннє викликає всіх незавершених асинхронних підписників з task->cancelled.
+ *
+ * Викликається при зупинці, коли потоки обробки вже завершились.
+ */
+static void async_cancel_all(EventBus *bus)
+{
+  atomic_store(&bus->async_ready, NULL);
+  for (uint16_t i = 0; i < bus->async_task_pool.block_count; i++)
+  {
+    EventAsyncTask *task = (EventAsyncTask *)(bus->async_task_pool.blocks + bus->async_task_pool.block_size * i);
+    if (task->callback == NULL)
+      continue;
+    task->cancelled = true;
+    task->callback(&task->event, task, task->context);
+    async_task_finish(bus, task, event_request_dropped);
+  }
+}
+
+void eventbus_async_resume(EventBus *bus, EventAsyncTask *task)
+{
+  uint8_t state = atomic_load_explicit(&task->state, memory_order_acquire);
+  while (true)
+  {
+    if (state == ASYNC_RUNNING)
+    {
+      if (atomic_compare_exchange_weak_explicit(&task->state, &state, ASYNC_RESUMED,
+                                                memory_order_acq_rel, memory_order_acquire))
+        return; // async_step викличе підписника ще раз
+    }
+    else if (state == ASYNC_SUSPENDED)
+    {
+      if (atomic_compare_exchange_weak_explicit(&task->state, &state, ASYNC_READY,
+                                                memory_order_acq_rel, memory_order_acquire))
+        break;
+    }
+    else
+      return; // вже відновлена
+  }
+
+  EventAsyncTask *head = atomic_load_explicit(&bus->async_ready, memory_order_relaxed);
+  do
+    task->ready_next = head;
+  while (!atomic_compare_exchange_weak_explicit(&bus->async_ready, &head, task,
+                                                memory_order_release, memory_order_relaxed));
+  queue_wake(bus);
+  async_wake(bus);
+  stream_wake(bus);
+}
+
+// ==================== Обробка подій ====================
+
+/**
+ * @brief Викликає підписників події, обходячи записи знімка таблиці диспетчеризації для її типу.
+ *
+ * Подію отримують підписники трьох записів – точного типу, категорії та всіх подій; кожен запис
+ * відсортований за пріоритетом, тож вони зливаються за рангом підписника.
+ * Підписник, відписаний після побудови знімка, пропускається за зміною покоління слоту.
+ * Так само зливаються записи статичних підписників, а зі знімком – за пріоритетом: статичний
+ * підписник викликається перед динамічними того ж пріоритету.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param snap Знімок, утримуваний викликачем через RCU.
+ * @param evt Вказівник на подію.
+ * @param stamp Момент завершення попереднього callback (лише з EVENTBUS_STATS).
+ * @param group Спільний стан події для асинхронних підписників; створюється при першому з них.
+ * @return false, якщо обхід перервано зупинкою EventBus і частина підписників подію не отримала.
+ */
+static bool dispatch_subscribers(EventBus *bus, const EventDispatchSnapshot *snap, Event *evt, uint64_t *stamp,
+                                 EventAsyncGroup **group)
+{
+  (void)stamp; // без EVENTBUS_STATS час callback не рахується
+  // Підписники точного типу, категорії та всіх подій – три відсортовані списки
+  const EventDispatchItem *lists[3];
+  const EventDispatchItem *ends[3];
+  int list_count = 0;
+  const EventDispatchEntry *found[3] = {
+      dispatch_find(snap, event_key(evt->type)),
+      dispatch_find(snap, event_key(event_type(evt->type.category, 0))),
+      &snap->entries[0]};
+  for (int l = 0; l < 3; l++)
+  {
+    if (found[l] && found[l]->count > 0)
+    {
+      lists[list_count] = &snap->items[found[l]->offset];
+      ends[list_count] = lists[list_count] + found[l]->count;
+      list_count++;
+    }
+  }
+
+  // Статичні підписники тих самих трьох ключів
+  const EventStaticDispatch *st = &bus->statics;
+  const uint16_t *statics[3];
+  const uint16_t *static_ends[3];
+  int static_count = 0;
+  if (st->entry_count > 0)
+  {
+    uint16_t keys[3] = {event_key(evt->type), event_key(event_type(evt->type.category, 0)), 0};
+    for (int l = 0; l < 3; l++)
+    {
+      const EventDispatchEntry *entry = entries_find(st->keys, st->entries, st->entry_count, keys[l]);
+      if (entry && (l == 0 || keys[l] != keys[l - 1]))
+      {
+        statics[static_count] = &st->order[entry->offset];
+        static_ends[static_count] = statics[static_count] + entry->count;
+        static_count++;
+      }
+    }
+  }
+
+  while (list_count > 0 || static_count > 0)
+  {
+    // Зливаємо списки: наступним викликається підписник з найменшим рангом
+    int l = 0;
+    for (int i = 1; i < list_count; i++)
+      if (lists[i]->rank < lists[l]->rank)
+        l = i;
+    if (static_count > 0)
+    {
+      int s = 0;
+      for (int i = 1; i < static_count; i++)
+        if (st->subs[*statics[i]].priority < st->subs[*statics[s]].priority ||
+            (st->subs[*statics[i]].priority == st->subs[*statics[s]].priority && *statics[i] < *statics[s]))
+          s = i;
+      const EventStaticSubscriber *sub = &st->subs[*statics[s]];
+      if (list_count == 0 || sub->priority <= lists[l]->priority)
+      {
+        if (++statics[s] == static_ends[s])
+        {
+          static_count--;
+          statics[s] = statics[static_count];
+          static_ends[s] = static_ends[static_count];
+        }
+        sub->callback(evt, sub->context);
+        EVENTBUS_STAT(*stamp = EVENTBUS_TIME_NS());
+        if (bus->status == bus_thread_stopping && (list_count > 0 || static_count > 0))
+          return false;
+        continue;
+      }
+    }
+    const EventDispatchItem *item = lists[l]++;
+    if (lists[l] == ends[l])
+    {
+      list_count--;
+      lists[l] = lists[list_count];
+      ends[l] = ends[list_count];
+    }
+
+    if (atomic_load_explicit(&item->sub->generation, memory_order_acquire) != item->generation)
+      continue; // підписник відписався після побудови знімка
+
+    if (!item->async)
+      item->callback.sync(evt, item->context);
+    else if (!async_start(bus, evt, item, group))
+      return false;
+#if defined(EVENTBUS_STATS)
+    uint64_t now = EVENTBUS_TIME_NS();
+    eventbus_stats_record(item->sub->stats, now - *stamp);
+    *stamp = now;
+#endif
+
+    if (bus->status == bus_thread_stopping && (list_count > 0 || static_count > 0))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Обробляє потокову подію: читає джерело шматками і передає кожен шматок усім підписникам.
+ *
+ * Наступний шматок читається лише після того, як усі підписники повернулись з callback, а пам’ять
+ * під нього береться з пулу, тож на подію припадає не більше одного шматка, крім утриманих
+ * підписниками. Після кінця даних або помилки підписники отримують порожній шматок з last.
+ *
+ * @return Стан запиту події: event_request_done, якщо потік дочитано до кінця.
+ */
+static EventRequestStatus stream_dispatch(EventBus *bus, const EventDispatchSnapshot *snap, Event *evt, uint64_t *stamp,
+                                          EventAsyncGroup **group)
+{
+  EventStreamChunk end;
+  memset(&end, 0, sizeof(end));
+  end.last = true;
+
+  while (true)
+  {
+    EventStreamChunk *chunk = stream_chunk_alloc(bus);
+    if (!chunk)
+    {
+      if (bus->stream_pool.block_count == 0)
+        return event_request_dropped; // потокові події вимкнені: підписники нічого не отримали
+      end.failed = true;
+      break;
+    }
+    chunk->data = (uint8_t *)chunk + sizeof(EventStreamChunk);
+    int n = evt->input.read_fn(evt->input.context, chunk->data, bus->config.stream_chunk_size);
+    if (n <= 0)
+    {
+      stream_chunk_free(bus, chunk);
+      end.failed = n < 0;
+      break;
+    }
+    atomic_store_explicit(&chunk->refs, 1, memory_order_relaxed);
+    chunk->last = false;
+    chunk->failed = false;
+    chunk->offset = end.offset;
+    chunk->size = (size_t)n;
+    end.offset += chunk->size;
+
+    evt->chunk = chunk;
+    evt->input.direct_data = chunk->data;
+    evt->input.data_size = chunk->size;
+    bool completed = dispatch_subscribers(bus, snap, evt, stamp, group);
+    evt->chunk = NULL;
+    evt->input.direct_data = NULL;
+    evt->input.data_size = 0;
+    eventbus_stream_release(bus, chunk);
+    if (!completed)
+      return event_request_dropped;
+    if (evt->stream_failed)
+    {
+      end.failed = true;
+      break;
+    }
+  }
+
+  evt->chunk = &end;
+  bool completed = dispatch_subscribers(bus, snap, evt, stamp, group);
+  evt->chunk = NULL;
+  return completed && !end.failed ? event_request_done : event_request_dropped;
+}
+
+// ==================== Утримувані події ====================
+
+/**
+ * @brief Шукає кільце утримуваних подій для типу події.
+ *
+ * Типи лише додаються, тож масив читається без м’ютекса до опублікованої кількості.
+ *
+ * @return Кільце або NULL, якщо події типу не утримуються.
+ */
+static EventRetained *retain_find(EventBus *bus, EventType type)
+{
+  uint16_t count = atomic_load_explicit(&bus->retained_count, memory_order_acquire);
+  uint16_t key = event_key(type);
+  for (uint16_t i = 0; i < count; i++)
+    if (bus->retained[i].key == key)
+      return &bus->retained[i];
+  return NULL;
+}
+
+/**
+ * @brief Копіює подію в кільце на місце найстарішої. Викликається під retain_mutex.
+ */
+static void retain_capture(EventBus *bus, EventRetained *retained, const Event *evt)
+{
+  size_t size = 0;
+  if (evt->input.storage != event_data_stream && evt->input.direct_data)
+    size = evt->input.data_size;
+  if (size > bus->config.retain_block_size)
+    return;
+  EventRetainedEntry *entry = &retained->entries[retained->head];
+  if (size)
+    memcpy(entry->data, evt->input.direct_data, size);
+  entry->size = (uint16_t)size;
+  entry->priority = evt->priority;
+  entry->seq = ++bus->retain_seq;
+  retained->head = (uint8_t)((retained->head + 1) % retained->depth);
+  if (retained->used < retained->depth)
+    retained->used++;
+}
+
+/**
+ * @brief Викликає callback нового підписника з утриманими подіями, що відповідають його підписці.
+ *
+ * Викликається під retain_mutex. Події різних типів зливаються за номером утримання,
+ * від найстарішої до найновішої.
+ */
+static void retain_replay(EventBus *bus, EventType type, void *context, EventCallback callback)
+{
+  uint16_t count = atomic_load_explicit(&bus->retained_count, memory_order_relaxed);
+  // Вік події відносно останньої утриманої: так порівняння не ламається після переповнення seq
+  uint32_t last_age = UINT32_MAX;
+  for (;;)
+  {
+    const EventRetained *next_type = NULL;
+    const EventRetainedEntry *next = NULL;
+    uint32_t next_age = 0;
+    for (uint16_t i = 0; i < count; i++)
+    {
+      const EventRetained *retained = &bus->retained[i];
+      uint8_t category = (uint8_t)(retained->key >> 8);
+      if ((type.category != 0 && type.category != category) ||
+          (type.id != 0 && event_key(type) != retained->key))
+        continue;
+      for (uint8_t j = 0; j < retained->used; j++)
+      {
+        const EventRetainedEntry *entry = &retained->entries[j];
+        uint32_t age = bus->retain_seq - entry->seq;
+        if (age < last_age && (next == NULL || age > next_age))
+        {
+          next_type = retained;
+          next = entry;
+          next_age = age;
+        }
+      }
+    }
+    if (next == NULL)
+      break;
+    last_age = next_age;
+
+    Event evt;
+    evt.type = event_type((uint8_t)(next_type->key >> 8), (uint8_t)next_type->key);
+    evt.priority = next->priority;
+    evt.stream_failed = false;
+    evt.input = create_event_input_data(next->size ? next->data : NULL, next->size);
+    evt.input.context = NULL;
+    evt.result = create_event_result();
+    evt.chunk = NULL;
+    callback(&evt, context);
+  }
+}
+
+/**
+ * @brief Обробляє подію.
+ *
+ * Знімок таблиці диспетчеризації незмінний і утримується через RCU, тому обробка не бере
+ * м’ютексів і не чекає на підписку чи відписку. Після останнього підписника (а якщо серед них
+ * є асинхронні – після завершення останнього з них) викликається result.done_fn і завершується запит події.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param evt Вказівник на подію.
+ */
+static void process_event(EventBus *bus, Event *evt)
+{
+  uint32_t epoch = rcu_read_lock(bus);
+  event_input_bind(&evt->input);
+  // Утримання та знімок під одним м’ютексом з підпискою: подія або потрапляє в повтор новому
+  // підписнику, або обробляється вже зі знімком, у якому він є, і після повтору
+  EventRetained *retained = retain_find(bus, evt->type);
+  if (retained)
+  {
+    EVENTBUS_MUTEX_LOCK(&bus->retain_mutex);
+    retain_capture(bus, retained, evt);
+  }
+  const EventDispatchSnapshot *snap = atomic_load_explicit(&bus->dispatch, memory_order_acquire);
+  if (retained)
+    EVENTBUS_MUTEX_UNLOCK(&bus->retain_mutex);
+  evt->chunk = NULL;
+  evt->stream_failed = false;
+  uint64_t stamp = 0;
+  EVENTBUS_STAT(stamp = EVENTBUS_TIME_NS());
+  EVENTBUS_STAT(uint64_t started = stamp);
+
+  EventAsyncGroup *group = NULL;
+  EventRequestStatus status;
+  if (evt->input.storage == event_data_stream)
+    status = stream_dispatch(bus, snap, evt, &stamp, &group);
+  else
+    status = dispatch_subscribers(bus, snap, evt, &stamp, &group) ? event_request_done : event_request_dropped;
+  rcu_read_unlock(bus, epoch);
+
+  EVENTBUS_STAT(eventbus_stats_record(eventbus_stats_type(bus->stats, evt->type), stamp - started));
+  EVENTBUS_STAT_ADD(bus->stats, dispatched, 1);
+
+  if (group)
+  {
+    // Подію ще обробляють асинхронні підписники: дані та результат переходять у спільний стан
+    group->event = *evt;
+    async_group_unref(bus, group, status);
+    return;
+  }
+  event_result_finish(bus, &evt->result, status);
+  event_input_release(bus, &evt->input);
+}
+
+// ==================== Потоки обробки подій ====================
+
+/**
+ * @brief Обробляє значення тем з черги готових, не більше EVENTBUS_SHARD_BATCH за виклик.
+ *
+ * Тема, якій поки обробки опублікували нове значення, повертається в кінець черги готових,
+ * тож часто оновлювана тема не затримує інші теми та шарди.
+ *
+ * @return true, якщо оброблено хоч одне значення.
+ */
+static bool topics_run_ready(EventBus *bus)
+{
+  if (atomic_load_explicit(&bus->topic_ready, memory_order_relaxed) == NULL)
+    return false;
+  size_t processed = 0;
+  for (; processed < EVENTBUS_SHARD_BATCH; processed++)
+  {
+    Event evt;
+    EVENTBUS_MUTEX_LOCK(&bus->topic_mutex);
+    EventTopic *topic = atomic_load_explicit(&bus->topic_ready, memory_order_relaxed);
+    if (topic)
+    {
+      atomic_store_explicit(&bus->topic_ready, topic->ready_next, memory_order_relaxed);
+      if (topic->ready_next == NULL)
+        bus->topic_ready_tail = NULL;
+      evt = topic->event;
+      topic->pending = false;
+    }
+    EVENTBUS_MUTEX_UNLOCK(&bus->topic_mutex);
+    if (!topic)
+      break;
+
+    EVENTBUS_STAT(eventbus_stats_record(&bus->stats->queue_latency, EVENTBUS_TIME_NS() - evt.enqueue_ns));
+    process_event(bus, &evt);
+
+    EVENTBUS_MUTEX_LOCK(&bus->topic_mutex);
+    if (topic->pending)
+      topic_ready_push(bus, topic);
+    else
+      topic->queued = false;
+    EVENTBUS_MUTEX_UNLOCK(&bus->topic_mutex);
+  }
+  return processed > 0;
+}
+
+/**
+ * @brief Обирає смугу шарда для наступної пачки. Викликається лише власником шарда.
+ *
+ * Береться найвища непорожня смуга, крім випадку, коли нижчу непорожню смугу оминули
+ * вже EVENTBUS_LANE_AGING разів поспіль – тоді пачку отримує вона.
+ *
+ * @return Смуга або NULL, якщо всі смуги порожні.
+ */
+static EventQueue *shard_pick_lane(EventBus *bus, EventShard *shard)
+{
+  int lane = -1, aged = -1;
+  for (uint8_t i = 0; i < bus->config.lane_count; i++)
+  {
+    if (eventbus_queue_empty(&shard->lanes[i]))
+    {
+      shard->lane_skipped[i] = 0;
+      continue;
+    }
+    if (lane < 0)
+      lane = i;
+    else if (++shard->lane_skipped[i] >= EVENTBUS_LANE_AGING && aged < 0)
+      aged = i;
+  }
+  if (lane < 0)
+    return NULL;
+  if (aged >= 0)
+    lane = aged;
+  shard->lane_skipped[lane] = 0;
+  return &shard->lanes[lane];
+}
+
+/**
+ * @brief Захоплює шард і обробляє пачку до EVENTBUS_SHARD_BATCH подій однієї його смуги.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param shard Вказівник на шард.
+ * @return true, якщо була оброблена хоча б одна подія.
+ */
+static bool shard_drain(EventBus *bus, EventShard *shard)
+{
+  if (atomic_load_explicit(&shard->busy, memory_order_relaxed) || shard_empty(bus, shard))
+    return false;
+  if (!shard_claim(shard))
+    return false; // шард уже обробляє інший потік
+
+  EventQueue *queue = shard_pick_lane(bus, shard);
+  size_t processed = 0;
+  if (queue)
+  {
+    // Події відновлюються з дескрипторів слотів, а слоти звільняються одним викликом на пачку
+    processed = eventbus_queue_ready(queue, EVENTBUS_SHARD_BATCH);
+    for (size_t i = 0; i < processed; i++)
+    {
+      Event evt;
+      eventbus_queue_peek(queue, i, &evt);
+      EVENTBUS_STAT(eventbus_stats_record(&bus->stats->queue_latency, EVENTBUS_TIME_NS() - evt.enqueue_ns));
+      process_event(bus, &evt);
+    }
+    eventbus_queue_consume(queue, processed);
+  }
+  shard_unclaim(shard);
+  if (processed > 0)
+    queue_space_wake(bus, shard);
+  return processed > 0;
+}
+
+/**
+ * @brief Функція потоку обробки подій.
+ *
+ * Потік обходить шарди, починаючи зі своєї частини, тож спершу обробляє власні шарди,
+ * а коли вони порожні або зайняті – забирає цілі шарди інших потоків. Якщо роботи немає,
+ * потік спить на queue_cond.
+ *
+ * @param arg Вказівник на EventBusWorker.
+ * @return NULL.
+ */
+static THREAD_RETURN_TYPE eventbus_thread_func(THREAD_ARG_TYPE arg)
+{
+  EventBusWorker *worker = (EventBusWorker *)arg;
+  EventBus *bus = worker->bus;
+  size_t shard_count = (size_t)bus->shard_mask + 1;
+  // Власні шарди потоку – рівна частина всіх шардів, що починається з first
+  size_t first = worker->index * shard_count / bus->config.worker_count;
+
+  while (bus->status == bus_thread_working)
+  {
+    bool processed = async_run_ready(bus);
+    processed |= topics_run_ready(bus);
+    for (size_t i = 0; i < shard_count; i++)
+      processed |= shard_drain(bus, &bus->shards[(first + i) & bus->shard_mask]);
+    if (!processed)
+      queue_wait(bus);
+  }
+
+  EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+  // Ланцюгове пробудження: кожен потік, що завершується, будить наступного
+  EVENTBUS_COND_SIGNAL(&bus->queue_cond);
+  if (atomic_fetch_sub(&bus->running_workers, 1) == 1)
+  {
+    bus->status = bus_thread_stoped;
+    EVENTBUS_COND_SIGNAL(&bus->stop_cond);
+  }
+  EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+
+#if defined(CONFIG_IDF_TARGET)
+  // esp-idf specific: задача FreeRTOS не може повертатись зі своєї функції
+  vTaskDelete(NULL);
+#endif
+  return THREAD_RETURN;
+}
+
+// ==================== Ініціалізація EventBus ====================
+
+/**
+ * @brief Створює потік обробки подій.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param worker Вказівник на опис потоку.
+ * @return true, якщо потік створено.
+ */
+static bool worker_start(EventBus *bus, EventBusWorker *worker)
+{
+#if defined(CONFIG_IDF_TARGET)
+  // esp-idf specific
+
+  // Один потік прив’язується до заданого ядра, пул потоків планувальник розподіляє між ядрами сам
+  BaseType_t core = bus->config.worker_count > 1 ? tskNO_AFFINITY : bus->config.task_xCoreId;
+  if (bus->arena.base)
+  {
+    // Стек і блок керування задачі – з пам’яті викликача
+    StaticTask_t *tcb = (StaticTask_t *)eventbus_arena_alloc(&bus->arena, sizeof(StaticTask_t));
+    StackType_t *stack = (StackType_t *)eventbus_arena_alloc(&bus->arena, bus->config.task_stackSize);
+    if (!tcb || !stack)
+      return false;
+    worker->thread = xTaskCreateStaticPinnedToCore(eventbus_thread_func,
+                                                   bus->config.task_name,
+                                                   bus->config.task_stackSize,
+                                                   worker,
+                                                   bus->config.task_priority,
+                                                   stack,
+                                                   tcb,
+                                                   core);
+    return worker->thread != NULL;
+  }
+  return xTaskCreatePinnedToCore(eventbus_thread_func,
+                                 bus->config.task_name,
+                                 bus->config.task_stackSize,
+                                 worker,
+                                 bus->config.task_priority,
+                                 &(worker->thread),
+                                 core) == pdPASS;
+
+#elif defined(_WIN32)
+  // Windows-specific
+
+  worker->thread = CreateThread(
+      NULL,                       // default security attributes
+      bus->config.task_stackSize, // use default stack size
+      eventbus_thread_func,       // thread function name
+      worker,                     // argument to thread function
+      0,                          // use default creation flags
+      NULL);                      // thread identifier is not needed
+  return worker->thread != NULL;
+#else
+  // Unix-specific
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  if (bus->config.task_stackSize != 0 && bus->arena.base)
+  {
+    void *stack = eventbus_arena_alloc(&bus->arena, bus->config.task_stackSize);
+    if (!stack || pthread_attr_setstack(&attr, stack, bus->config.task_stackSize) != 0)
+    {
+      pthread_attr_destroy(&attr);
+      return false;
+    }
+  }
+  else if (bus->config.task_stackSize != 0)
+    pthread_attr_setstacksize(&attr, bus->config.task_stackSize);
+  bool started = pthread_create(&worker->thread, &attr, eventbus_thread_func, worker) == 0;
+  pthread_attr_destroy(&attr);
+  return started;
+#endif
+}
+
+/**
+ * @brief Чекає завершення потоків обробки подій, які вже отримали сигнал зупинки.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param count Кількість запущених потоків.
+ */
+static void workers_join(EventBus *bus, size_t count)
+{
+#if defined(CONFIG_IDF_TARGET)
+  // esp-idf specific
+
+  // Задачу FreeRTOS не можна приєднати: останній потік, що завершується, сигналізує stop_cond
+  (void)count;
+  EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+  while (bus->status != bus_thread_stoped)
+    EVENTBUS_COND_WAIT(&bus->stop_cond, &bus->queue_mutex);
+  EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+
+#elif defined(_WIN32)
+  // Windows-specific
+
+  for (size_t i = 0; i < count; i++)
+  {
+    WaitForSingleObject(bus->workers[i].thread, INFINITE);
+    CloseHandle(bus->workers[i].thread);
+  }
+
+#else
+  // Unix-specific
+
+  for (size_t i = 0; i < count; i++)
+    pthread_join(bus->workers[i].thread, NULL);
+
+#endif
+}
+
+/**
+ * @brief Викидає події, що залишились у черзі: звільняє їх дані та завершує їх запити як викинуті.
+ *
+ * Викликається, коли потоків обробки вже немає. Безпечна для частково ініціалізованого EventBus.
+ *
+ * @param bus Вказівник на EventBus.
+ */
+static void queues_discard(EventBus *bus)
+{
+  topics_discard(bus);
+  if (!bus->shards)
+    return;
+  for (size_t i = 0; i <= bus->shard_mask; i++)
+  {
+    for (size_t lane = 0; lane < EVENTBUS_LANE_MAX; lane++)
+    {
+      EventQueue *queue = &bus->shards[i].lanes[lane];
+      Event evt;
+      if (!atomic_load(&queue->head_seg))
+        continue;
+      while (eventbus_queue_pop(queue, &evt) == 0)
+      {
+        event_input_release(bus, &evt.input);
+        event_result_finish(bus, &evt.result, event_request_dropped);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Звільняє пам’ять EventBus разом з даними подій, що залишились у черзі.
+ *
+ * Викликається, коли потоків обробки вже немає. Безпечна для частково ініціалізованого EventBus.
+ *
+ * @param bus Вказівник на EventBus.
+ */
+static void eventbus_release(EventBus *bus)
+{
+  queues_discard(bus);
+  if (bus->shards)
+  {
+    for (size_t i = 0; i <= bus->shard_mask; i++)
+      for (size_t lane = 0; lane < EVENTBUS_LANE_MAX; lane++)
+        eventbus_queue_free(&bus->shards[i].lanes[lane]);
+  }
+  eventbus_pool_free(&bus->payload_pool);
+  for (uint16_t i = 0; i < bus->request_pool.block_count; i++)
+    EVENTBUS_COND_DESTROY(&request_at(bus, i)->cond);
+  eventbus_pool_free(&bus->request_pool);
+  eventbus_pool_free(&bus->stream_pool);
+  eventbus_pool_free(&bus->async_task_pool);
+  eventbus_pool_free(&bus->async_group_pool);
+  eventbus_pool_free(&bus->retain_pool);
+#if defined(EVENTBUS_STATS)
+  eventbus_stats_destroy(bus->stats);
+  bus->stats = NULL;
+#endif
+  EventArena *arena = &bus->arena;
+  eventbus_arena_free(arena, bus->shards);
+  eventbus_arena_free(arena, bus->topics);
+  eventbus_arena_free(arena, bus->retained);
+  eventbus_arena_free(arena, bus->retain_entries);
+  eventbus_arena_free(arena, bus->workers);
+  for (uint8_t i = 0; i < bus->sub_chunk_count; i++)
+    eventbus_arena_free(arena, bus->sub_chunks[i]);
+  eventbus_arena_free(arena, bus->sub_keys);
+  eventbus_arena_free(arena, bus->sub_priorities);
+  eventbus_arena_free(arena, bus->sub_callbacks);
+  eventbus_arena_free(arena, bus->sub_contexts);
+  eventbus_arena_free(arena, bus->sub_slots);
+  eventbus_arena_free(arena, bus->dispatch_keys);
+  if (!arena->base)
+    free(atomic_load(&bus->dispatch));
+  rcu_free_list(bus, bus->rcu_pending);
+  rcu_free_list(bus, bus->rcu_waiting);
+  static_dispatch_free(bus);
+  bus->shards = NULL;
+  bus->topics = NULL;
+  bus->retained = NULL;
+  bus->retain_entries = NULL;
+  bus->dispatch_spare = NULL;
+  bus->workers = NULL;
+  bus->sub_chunk_count = 0;
+  bus->sub_capacity = 0;
+  bus->sub_free = EVENTBUS_SUB_NONE;
+  bus->sub_keys = NULL;
+  bus->sub_priorities = NULL;
+  bus->sub_callbacks = NULL;
+  bus->sub_contexts = NULL;
+  bus->sub_slots = NULL;
+  bus->sub_count = 0;
+  bus->dispatch_keys = NULL;
+  atomic_store(&bus->dispatch, NULL);
+  bus->rcu_pending = bus->rcu_waiting = NULL;
+}
+
+/**
+ * @brief Ініціалізує EventBus згідно з переданою конфігурацією.
+ *
+ * Виділяє пам’ять для шардів черги подій (розміри округлюються вгору до степеня двійки)
+ * та першого блоку таблиці підписників, ініціалізує м’ютекси, умовну змінну та створює потоки обробки подій.
+ * Пам’ять береться з bus->arena, яку викликач задає заздалегідь.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param cfg Вказівник на конфігурацію EventBus.
+ * @return 0 при успіху, -1 при помилці.
+ */
+static int bus_init(EventBus *bus, EventBusConfig *cfg)
+{
+  bus->config = *cfg;
+  if (bus->config.worker_count == 0)
+    bus->config.worker_count = 1;
+  if (bus->config.lane_count == 0)
+    bus->config.lane_count = 1;
+  if (bus->config.lane_count > EVENTBUS_LANE_MAX)
+    bus->config.lane_count = EVENTBUS_LANE_MAX;
+  if (bus->config.subs_array_size == 0)
+    bus->config.subs_array_size = 1;
+  size_t shard_count = 1;
+  while (shard_count < bus->config.shard_count || shard_count < bus->config.worker_count)
+    shard_count <<= 1;
+  bus->shard_mask = (uint16_t)(shard_count - 1);
+
+  atomic_init(&bus->status, bus_thread_noStarted);
+  atomic_init(&bus->idle_workers, 0);
+  atomic_init(&bus->running_workers, 0);
+  bus->sub_count = 0;
+  bus->sub_chunk_count = 0;
+  bus->sub_capacity = 0;
+  bus->sub_free = EVENTBUS_SUB_NONE;
+  bus->sub_keys = NULL;
+  bus->sub_priorities = NULL;
+  bus->sub_callbacks = NULL;
+  bus->sub_contexts = NULL;
+  bus->sub_slots = NULL;
+  bus->dispatch_keys = NULL;
+  atomic_init(&bus->memory.used, 0);
+  bus->memory.limit = bus->config.memory_limit;
+  bus->dispatch_version = 0;
+  atomic_init(&bus->dispatch, NULL);
+  atomic_init(&bus->rcu_epoch, 0);
+  atomic_init(&bus->rcu_readers[0], 0);
+  atomic_init(&bus->rcu_readers[1], 0);
+  bus->rcu_pending = bus->rcu_waiting = NULL;
+  bus->dispatch_spare = NULL;
+  bus->statics.subs = NULL;
+  bus->statics.entry_count = 0;
+  bus->statics.keys = NULL;
+  bus->statics.entries = NULL;
+  bus->statics.order = NULL;
+
+  EventArena *arena = &bus->arena;
+  eventbus_pool_init(&bus->payload_pool, 0, 0, arena);
+  eventbus_pool_init(&bus->request_pool, 0, 0, arena);
+  atomic_init(&bus->request_waiters, 0);
+  eventbus_pool_init(&bus->stream_pool, 0, 0, arena);
+  atomic_init(&bus->stream_waiters, 0);
+  eventbus_pool_init(&bus->async_task_pool, 0, 0, arena);
+  eventbus_pool_init(&bus->async_group_pool, 0, 0, arena);
+  atomic_init(&bus->async_ready, NULL);
+  atomic_init(&bus->async_waiters, 0);
+  atomic_init(&bus->topic_count, 0);
+  atomic_init(&bus->topic_ready, NULL);
+  bus->topic_ready_tail = NULL;
+  bus->topics = NULL;
+  eventbus_pool_init(&bus->retain_pool, 0, 0, arena);
+  atomic_init(&bus->retained_count, 0);
+  bus->retain_seq = 0;
+  bus->retained = NULL;
+  bus->retain_entries = NULL;
+  bus->retain_entries_used = 0;
+  EVENTBUS_STAT(bus->stats = NULL);
+  bool retain = bus->config.retain_type_count > 0 && bus->config.retain_block_count > 0;
+  bus->shards = (EventShard *)eventbus_arena_alloc(arena, sizeof(EventShard) * shard_count);
+  if (bus->shards)
+    memset(bus->shards, 0, sizeof(EventShard) * shard_count);
+  bus->workers = (EventBusWorker *)eventbus_arena_alloc(arena, sizeof(EventBusWorker) * bus->config.worker_count);
+  if (bus->config.topic_count > 0)
+    bus->topics = (EventTopic *)eventbus_arena_alloc(arena, sizeof(EventTopic) * bus->config.topic_count);
+  if (retain)
+  {
+    // Записи кілець усіх типів – один масив: кожен запис тримає блок retain_pool, тож їх не більше, ніж блоків
+    bus->retained = (EventRetained *)eventbus_arena_alloc(arena, sizeof(EventRetained) * bus->config.retain_type_count);
+    bus->retain_entries = (EventRetainedEntry *)eventbus_arena_alloc(arena, sizeof(EventRetainedEntry) *
+                                                                                bus->config.retain_block_count);
+  }
+  if (!bus->shards || !bus->workers || (bus->config.topic_count > 0 && !bus->topics) ||
+      (retain && (!bus->retained || !bus->retain_entries)))
+  {
+    eventbus_release(bus);
+    return -1;
+  }
+  if (eventbus_pool_init(&bus->payload_pool, bus->config.payload_block_size, bus->config.payload_block_count, arena) != 0 ||
+      eventbus_pool_init(&bus->request_pool, sizeof(EventRequest), bus->config.request_count, arena) != 0 ||
+      eventbus_pool_init(&bus->stream_pool, sizeof(EventStreamChunk) + bus->config.stream_chunk_size,
+                         bus->config.stream_chunk_count, arena) != 0 ||
+      eventbus_pool_init(&bus->async_task_pool, sizeof(EventAsyncTask), bus->config.async_task_count, arena) != 0 ||
+      eventbus_pool_init(&bus->async_group_pool, sizeof(EventAsyncGroup), bus->config.async_task_count, arena) != 0 ||
+      eventbus_pool_init(&bus->retain_pool, bus->config.retain_block_size,
+                         retain ? bus->config.retain_block_count : 0, arena) != 0)
+  {
+    eventbus_release(bus);
+    return -1;
+  }
+  for (uint16_t i = 0; i < bus->request_pool.block_count; i++)
+    EVENTBUS_COND_INIT(&request_at(bus, i)->cond);
+  for (uint16_t i = 0; i < bus->async_task_pool.block_count; i++)
+    ((EventAsyncTask *)(bus->async_task_pool.blocks + bus->async_task_pool.block_size * i))->callback = NULL;
+#if defined(EVENTBUS_STATS)
+  bus->stats = eventbus_stats_create();
+  if (!bus->stats)
+  {
+    eventbus_release(bus);
+    return -1;
+  }
+#endif
+  for (size_t i = 0; i < shard_count; i++)
+  {
+    atomic_init(&bus->shards[i].busy, false);
+    atomic_init(&bus->shards[i].blocked, 0);
+    for (size_t lane = 0; lane < bus->config.lane_count; lane++)
+    {
+      if (eventbus_queue_init(&bus->shards[i].lanes[lane], bus->config.queue_size, bus->config.queue_ext_size,
+                              bus->config.growable ? &bus->memory : NULL, arena) != 0)
+      {
+        eventbus_release(bus);
+        return -1;
+      }
+    }
+  }
+  if (sub_grow(bus) != 0 || static_dispatch_init(bus) != 0)
+  {
+    eventbus_release(bus);
+    return -1;
+  }
+  if (arena->base)
+  {
+    // Буфери знімків найбільшого розміру: підписників не більше за місткість першого блоку таблиці
+    size_t snap_size = EVENTBUS_STATIC_SNAPSHOT_SIZE(bus->sub_capacity);
+    for (size_t i = 0; i < EVENTBUS_STATIC_SNAPSHOTS; i++)
+    {
+      EventDispatchSnapshot *snap = (EventDispatchSnapshot *)eventbus_arena_alloc(arena, snap_size);
+      if (!snap)
+      {
+        eventbus_release(bus);
+        return -1;
+      }
+      snap->retired_next = bus->dispatch_spare;
+      bus->dispatch_spare = snap;
+    }
+  }
+  if (dispatch_publish(bus) != 0)
+  {
+    eventbus_release(bus);
+    return -1;
+  }
+  EVENTBUS_MUTEX_INIT(&bus->queue_mutex);
+  EVENTBUS_COND_INIT(&bus->queue_cond);
+  EVENTBUS_COND_INIT(&bus->stop_cond);
+  for (size_t i = 0; i < shard_count; i++)
+    EVENTBUS_COND_INIT(&bus->shards[i].space_cond);
+  EVENTBUS_COND_INIT(&bus->stream_cond);
+  EVENTBUS_COND_INIT(&bus->async_cond);
+  EVENTBUS_MUTEX_INIT(&bus->subs_mutex);
+  EVENTBUS_MUTEX_INIT(&bus->request_mutex);
+  EVENTBUS_MUTEX_INIT(&bus->topic_mutex);
+  EVENTBUS_MUTEX_INIT(&bus->retain_mutex);
+
+  // Статус виставляється до старту потоків, щоб eventbus_stop, викликаний одразу після init,
+  // не був перезаписаний потоком, який ще не встиг запуститись.
+  bus->status = bus_thread_working;
+  size_t started = 0;
+  for (; started < bus->config.worker_count; started++)
+  {
+    bus->workers[started].bus = bus;
+    bus->workers[started].index = (uint16_t)started;
+    atomic_fetch_add(&bus->running_workers, 1);
+    if (!worker_start(bus, &bus->workers[started]))
+    {
+      atomic_fetch_sub(&bus->running_workers, 1);
+      break;
+    }
+  }
+
+  if (started < bus->config.worker_count)
+  {
+    EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+    bus->status = started > 0 ? bus_thread_stopping : bus_thread_stoped;
+    EVENTBUS_COND_SIGNAL(&bus->queue_cond);
+    EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+    workers_join(bus, started);
+    EVENTBUS_MUTEX_DESTROY(&bus->queue_mutex);
+    EVENTBUS_COND_DESTROY(&bus->queue_cond);
+    EVENTBUS_COND_DESTROY(&bus->stop_cond);
+    for (size_t i = 0; i < shard_count; i++)
+      EVENTBUS_COND_DESTROY(&bus->shards[i].space_cond);
+    EVENTBUS_COND_DESTROY(&bus->stream_cond);
+    EVENTBUS_COND_DESTROY(&bus->async_cond);
+    EVENTBUS_MUTEX_DESTROY(&bus->subs_mutex);
+    EVENTBUS_MUTEX_DESTROY(&bus->request_mutex);
+    EVENTBUS_MUTEX_DESTROY(&bus->topic_mutex);
+    EVENTBUS_MUTEX_DESTROY(&bus->retain_mutex);
+    eventbus_release(bus);
+    bus->status = bus_thread_noStarted;
+    return -1;
+  }
+
+  return 0;
+}
+
+int eventbus_init(EventBus *bus, EventBusConfig *cfg)
+{
+  bus->arena.base = NULL;
+  bus->arena.size = 0;
+  bus->arena.used = 0;
+  return bus_init(bus, cfg);
+}
+
+int eventbus_init_static(EventBus *bus, EventBusConfig *cfg, void *storage, size_t storage_size)
+{
+  if (!storage || cfg->growable)
+    return -1;
+  // Початок пам’яті вирівнюється, тож вирівняні й усі розміщені в ній структури
+  uintptr_t base = ((uintptr_t)storage + EVENTBUS_STATIC_ALIGN - 1) & ~(uintptr_t)(EVENTBUS_STATIC_ALIGN - 1);
+  size_t skip = (size_t)(base - (uintptr_t)storage);
+  if (storage_size < skip + eventbus_static_size(cfg) - (EVENTBUS_STATIC_ALIGN - 1))
+    return -1;
+  bus->arena.base = (uint8_t *)base;
+  bus->arena.size = storage_size - skip;
+  bus->arena.used = 0;
+  return bus_init(bus, cfg);
+}
+
+size_t eventbus_static_size(const EventBusConfig *cfg)
+{
+  size_t worker_count = cfg->worker_count ? cfg->worker_count : 1;
+  size_t lane_count = cfg->lane_count == 0 ? 1 : (cfg->lane_count > EVENTBUS_LANE_MAX ? EVENTBUS_LANE_MAX : cfg->lane_count);
+  size_t shard_count = 1;
+  while (shard_count < cfg->shard_count || shard_count < worker_count)
+    shard_count <<= 1;
+  size_t subs = cfg->subs_array_size ? cfg->subs_array_size : 1;
+  if (subs > EVENTBUS_SUB_NONE)
+    subs = EVENTBUS_SUB_NONE;
+  bool retain = cfg->retain_type_count > 0 && cfg->retain_block_count > 0;
+
+  size_t size = EVENTBUS_STATIC_ALIGN - 1;
+  size += EVENTBUS_STATIC_ALIGN_UP(sizeof(EventShard) * shard_count);
+  size += EVENTBUS_STATIC_ALIGN_UP(sizeof(EventBusWorker) * worker_count);
+  size += EVENTBUS_STATIC_ALIGN_UP(sizeof(EventTopic) * cfg->topic_count);
+  if (retain)
+  {
+    size += EVENTBUS_STATIC_ALIGN_UP(sizeof(EventRetained) * cfg->retain_type_count);
+    size += EVENTBUS_STATIC_ALIGN_UP(sizeof(EventRetainedEntry) * cfg->retain_block_count);
+    size += EVENTBUS_STATIC_POOL_SIZE(cfg->retain_block_size, cfg->retain_block_count);
+  }
+  size += EVENTBUS_STATIC_POOL_SIZE(cfg->payload_block_size, cfg->payload_block_count);
+  size += EVENTBUS_STATIC_POOL_SIZE(sizeof(EventRequest), cfg->request_count);
+  size += EVENTBUS_STATIC_POOL_SIZE(sizeof(EventStreamChunk) + cfg->stream_chunk_size, cfg->stream_chunk_count);
+  size += EVENTBUS_STATIC_POOL_SIZE(sizeof(EventAsyncTask), cfg->async_task_count);
+  size += EVENTBUS_STATIC_POOL_SIZE(sizeof(EventAsyncGroup), cfg->async_task_count);
+  size += shard_count * lane_count * EVENTBUS_STATIC_QUEUE_SIZE(cfg->queue_size, cfg->queue_ext_size);
+  size += EVENTBUS_STATIC_SUBS_SIZE(subs);
+  if (cfg->static_subscribers)
+    size += EVENTBUS_STATIC_SUBSCRIBERS_SIZE(static_subs_count());
+  size += worker_count * EVENTBUS_STATIC_STACK_SIZE(cfg->task_stackSize);
+  return size;
+}
+
+EventBus *eventbus_create(EventBusConfig cfg)
+{
+  EventBus *bus = (EventBus *)malloc(sizeof(EventBus));
+  if (eventbus_init(bus, &cfg) != 0)
+  {
+    free(bus);
+    return NULL;
+  }
+  return bus;
+}
+
+/**
+ * @brief Зупиняє роботу EventBus.
+ *
+ * Встановлює прапорець завершення, будить потоки через queue_cond та продюсерів, що чекають
+ * на місце в черзі, приєднує потоки і на stop_cond чекає виходу продюсерів з очікування. Запити подій,
+ * що залишились у черзі, завершуються як викинуті, і функція чекає, поки викликачі вийдуть
+ * з eventbus_request_wait, після чого звільняє всі виділені ресурси та дані подій.
+ *
+ * @param bus Вказівник на EventBus.
+ */
+void eventbus_stop(EventBus *bus)
+{
+  EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+  bus->status = bus_thread_stopping;
+  EVENTBUS_COND_SIGNAL(&bus->queue_cond);
+  for (size_t i = 0; i <= bus->shard_mask; i++)
+    EVENTBUS_COND_SIGNAL(&bus->shards[i].space_cond);
+  EVENTBUS_COND_SIGNAL(&bus->stream_cond);
+  EVENTBUS_COND_SIGNAL(&bus->async_cond);
+  EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+
+  workers_join(bus, bus->config.worker_count);
+
+  // Продюсери зменшують blocked під queue_mutex і після зупинки сигналізують stop_cond,
+  // тож після нуля під м’ютексом вони його вже відпустили
+  EVENTBUS_MUTEX_LOCK(&bus->queue_mutex);
+  while (true)
+  {
+    size_t blocked = 0;
+    for (size_t i = 0; i <= bus->shard_mask; i++)
+      blocked += atomic_load(&bus->shards[i].blocked);
+    if (blocked == 0)
+      break;
+    EVENTBUS_COND_WAIT(&bus->stop_cond, &bus->queue_mutex);
+  }
+  EVENTBUS_MUTEX_UNLOCK(&bus->queue_mutex);
+
+  async_cancel_all(bus);
+
+  // Викликачі, що чекали на запити викинутих подій, вже розбуджені: чекаємо, поки вони відпустять request_mutex
+  queues_discard(bus);
+  EVENTBUS_MUTEX_LOCK(&bus->request_mutex);
+  while (atomic_load(&bus->request_waiters) != 0)
+    EVENTBUS_COND_WAIT(&bus->stop_cond, &bus->request_mutex);
+  EVENTBUS_MUTEX_UNLOCK(&bus->request_mutex);
+
+  for (size_t i = 0; i <= bus->shard_mask; i++)
+    EVENTBUS_COND_DESTROY(&bus->shards[i].space_cond);
+  eventbus_release(bus);
+  EVENTBUS_MUTEX_DESTROY(&bus->queue_mutex);
+  EVENTBUS_COND_DESTROY(&bus->queue_cond);
+  EVENTBUS_COND_DESTROY(&bus->stop_cond);
+  EVENTBUS_COND_DESTROY(&bus->stream_cond);
+  EVENTBUS_COND_DESTROY(&bus->async_cond);
+  EVENTBUS_MUTEX_DESTROY(&bus->subs_mutex);
+  EVENTBUS_MUTEX_DESTROY(&bus->request_mutex);
+  EVENTBUS_MUTEX_DESTROY(&bus->topic_mutex);
+  EVENTBUS_MUTEX_DESTROY(&bus->retain_mutex);
+
+}
+
+// ==================== Робота з підписниками ====================
+
+/**
+ * @brief Зсуває рядки таблиці підписників, починаючи з from, на одну позицію.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param from Перший рядок, що зсувається.
+ * @param shift 1 – звільнити рядок from, -1 – затерти рядок from - 1.
+ */
+static void sub_rows_move(EventBus *bus, uint16_t from, int shift)
+{
+  size_t n = bus->sub_count - from;
+  memmove(&bus->sub_keys[from + shift], &bus->sub_keys[from], n * sizeof(bus->sub_keys[0]));
+  memmove(&bus->sub_priorities[from + shift], &bus->sub_priorities[from], n * sizeof(bus->sub_priorities[0]));
+  memmove(&bus->sub_callbacks[from + shift], &bus->sub_callbacks[from], n * sizeof(bus->sub_callbacks[0]));
+  memmove(&bus->sub_contexts[from + shift], &bus->sub_contexts[from], n * sizeof(bus->sub_contexts[0]));
+  memmove(&bus->sub_slots[from + shift], &bus->sub_slots[from], n * sizeof(bus->sub_slots[0]));
+}
+
+/**
+ * @brief Повертає дескриптор підписника за індексом.
+ *
+ * Блок c має subs_array_size << c дескрипторів і починається з індексу subs_array_size * (2^c - 1),
+ * тож номер блоку – старший біт index / subs_array_size + 1.
+ */
+static EventSubscriber *sub_handle(EventBus *bus, uint16_t index)
+{
+  size_t base = bus->config.subs_array_size;
+  size_t q = index / base + 1;
+  uint8_t chunk = 0;
+  while (q >>= 1)
+    chunk++;
+  return &bus->sub_chunks[chunk][index - base * (((size_t)1 << chunk) - 1)];
+}
+
+static bool sub_realloc(EventBus *bus, void **array, size_t size)
+{
+  // Пам’ять викликача виділяється лише під перший блок, тож масивів ще немає
+  void *grown = bus->arena.base ? eventbus_arena_alloc(&bus->arena, size) : realloc(*array, size);
+  if (grown)
+    *array = grown;
+  return grown != NULL;
+}
+
+/**
+ * @brief Додає до таблиці підписників блок дескрипторів. Викликається під subs_mutex.
+ *
+ * Першим блоком EventBus володіє завжди, наступні додаються лише при growable. Кожен блок удвічі
+ * більший за попередній, а вже видані дескриптори не переміщуються, тож їх адреси залишаються дійсними.
+ * Масиви рядків таблиці перевиділяються під нову місткість: обробка подій їх не читає.
+ * Нові дескриптори додаються в список вільних, перший з них стає його головою.
+ *
+ * @param bus Вказівник на EventBus.
+ * @return 0 при успіху, -1 якщо таблиця не може рости або бракує пам’яті.
+ */
+static int sub_grow(EventBus *bus)
+{
+  uint8_t chunk = bus->sub_chunk_count;
+  if ((chunk > 0 && !bus->config.growable) || chunk == EVENTBUS_SUB_CHUNKS || bus->sub_capacity == EVENTBUS_SUB_NONE)
+    return -1;
+  size_t size = (size_t)bus->config.subs_array_size << chunk;
+  if (size > (size_t)(EVENTBUS_SUB_NONE - bus->sub_capacity))
+    size = EVENTBUS_SUB_NONE - bus->sub_capacity;
+  size_t capacity = bus->sub_capacity + size;
+
+  // Дескриптор, рядок таблиці та запис робочого буфера знімка
+  size_t bytes = size * (sizeof(EventSubscriber) + sizeof(uint16_t) * 2 + sizeof(uint8_t) +
+                         sizeof(EventCallback) + sizeof(void *) + sizeof(EventDispatchEntry));
+  EVENTBUS_STAT(bytes += size * sizeof(EventStatsHistogram));
+  if (bus->config.growable && !eventbus_budget_reserve(&bus->memory, bytes))
+    return -1;
+
+  EventSubscriber *subs = (EventSubscriber *)eventbus_arena_alloc(&bus->arena, sizeof(EventSubscriber) * size);
+  // Кожен підписник додає щонайбільше один запис знімка плюс глобальний запис
+  bool ok = subs &&
+            sub_realloc(bus, (void **)&bus->sub_keys, sizeof(uint16_t) * capacity) &&
+            sub_realloc(bus, (void **)&bus->sub_priorities, sizeof(uint8_t) * capacity) &&
+            sub_realloc(bus, (void **)&bus->sub_callbacks, sizeof(EventSubscriberFn) * capacity) &&
+            sub_realloc(bus, (void **)&bus->sub_contexts, sizeof(void *) * capacity) &&
+            sub_realloc(bus, (void **)&bus->sub_slots, sizeof(uint16_t) * capacity) &&
+            sub_realloc(bus, (void **)&bus->dispatch_keys, sizeof(EventDispatchEntry) * (capacity + 1));
+#if defined(EVENTBUS_STATS)
+  EventStatsHistogram *hist = ok ? eventbus_stats_grow(bus->stats, (uint16_t)size) : NULL;
+  ok = hist != NULL;
+#endif
+  if (!ok)
+  {
+    // Вже збільшені масиви рядків залишаються більшими, це не порушує таблицю
+    eventbus_arena_free(&bus->arena, subs);
+    if (bus->config.growable)
+      eventbus_budget_release(&bus->memory, bytes);
+    return -1;
+  }
+
+  for (size_t i = size; i-- > 0;)
+  {
+    subs[i].status = sub_slot_free;
+    subs[i].index = (uint16_t)(bus->sub_capacity + i);
+    subs[i].next_free = bus->sub_free;
+    atomic_init(&subs[i].generation, 0);
+    EVENTBUS_STAT(subs[i].stats = &hist[i]);
+    bus->sub_free = subs[i].index;
+  }
+  bus->sub_chunks[chunk] = subs;
+  bus->sub_chunk_count++;
+  bus->sub_capacity = (uint16_t)capacity;
+  return 0;
+}
+
+/**
+ * @brief Видаляє рядок підписника з таблиці та повертає дескриптор у список вільних.
+ */
+static void remove_subscriber(EventBus *bus, EventSubscriber *sub)
+{
+  // Рядок підписника шукається послідовним переглядом упакованих індексів дескрипторів
+  uint16_t row = (uint16_t)keys_find(bus->sub_slots, bus->sub_count, sub->index);
+  if (row < bus->sub_count)
+  {
+    sub_rows_move(bus, row + 1, -1);
+    bus->sub_count--;
+  }
+  sub->status = sub_slot_free;
+  sub->next_free = bus->sub_free;
+  bus->sub_free = sub->index;
+}
+
+/**
+ * @brief Вставляє рядок підписника в таблицю підписників за зростанням priority.
+ *
+ * Якщо priority співпадають, новий рядок вставляється після існуючих з таким же значенням.
  *
  * @param bus Вказівник на EventBus.
- * @param subscriber Вказівник на підписника, який потрібно видалити.
- * @return 0 при успіху, -1 якщо subscriber == NULL.
+ * @param index Індекс дескриптора підписника.
+ * @param type Тип події для підписки.
+ * @param priority Пріоритет підписника.
+ * @param context Контекст підписника.
+ * @param callback Callback для обробки події.
  */
-int eventbus_unsubscribe(EventBus *bus, EventSubscriber *subscriber)
+static void insert_subscriber(EventBus *bus, uint16_t index, EventType type, uint8_t priority, void *context, EventSubscriberFn callback)
 {
-  if (!subscriber)
-    return -1;
-  int idx = (int)(subscriber - bus->subs); // розраховуємо індекс елемента
-  if (bus->subs[idx].status == sub_slot_free)
+  // Рядки впорядковані за priority, тож позиція знаходиться двійковим пошуком
+  uint16_t lo = 0, hi = bus->sub_count;
+  while (lo < hi)
   {
-    return -1;
+    uint16_t mid = (uint16_t)((lo + hi) / 2);
+    if (bus->sub_priorities[mid] <= priority)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  sub_rows_move(bus, lo, 1);
+  bus->sub_keys[lo] = event_key(type);
+  bus->sub_priorities[lo] = priority;
+  bus->sub_callbacks[lo] = callback;
+  bus->sub_contexts[lo] = context;
+  bus->sub_slots[lo] = index;
+  bus->sub_count++;
+}
+
+static EventSubscriber *sub_add(EventBus *bus, EventType type, uint8_t priority, void *context, EventSubscriberFn callback, bool async)
+{
+  if (bus->sub_free == EVENTBUS_SUB_NONE && sub_grow(bus) != 0)
+  {
+    return NULL; // немає вільного дескриптора
   }
+  EventSubscriber *sub = sub_handle(bus, bus->sub_free);
+  bus->sub_free = sub->next_free;
+  sub->status = sub_slot_used;
+  sub->async = async;
+  atomic_fetch_add_explicit(&sub->generation, 1, memory_order_relaxed);
+  EVENTBUS_STAT(eventbus_stats_reset(sub->stats));
+  // Вставка рядка підписника в таблицю підписників
+  insert_subscriber(bus, sub->index, type, priority, context, callback);
+  if (dispatch_publish(bus) != 0)
+  {
+    // Поточний знімок не змінився і про новий слот не знає
+    remove_subscriber(bus, sub);
+    return NULL;
+  }
+  return sub;
+}
 
-  while (bus->subs[idx].status == sub_slot_inWork)
+/**
+ * @brief Додає нового підписника до EventBus.
+ *
+ * Бере вільний дескриптор зі списку вільних (при growable за потреби додаючи блок дескрипторів),
+ * вставляє рядок підписника в таблицю підписників та публікує новий знімок таблиці диспетчеризації.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події для підписки.
+ * @param priority Пріоритет підписника.
+ * @param context Контекст підписника.
+ * @param callback Callback для обробки події.
+ * @return Вказівник на структуру EventSubscriber при успіху, або NULL при помилці.
+ */
+EventSubscriber *eventbus_subscribe(EventBus *bus, EventType type, uint8_t priority, void *context, EventCallback callback)
+{
+  EventSubscriber *ret = NULL;
+
+  // Новий знімок публікується під retain_mutex, тож між ним і повтором утриманих подій
+  // жодна подія утримуваного типу не обробляється
+  bool retain = atomic_load_explicit(&bus->retained_count, memory_order_acquire) > 0;
+  if (retain)
+    EVENTBUS_MUTEX_LOCK(&bus->retain_mutex);
+
+  EVENTBUS_MUTEX_LOCK(&bus->subs_mutex);
+
+  EventSubscriberFn fn;
+  fn.sync = callback;
+  ret = sub_add(bus, type, priority, context, fn, false);
+
+  EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
+
+  if (retain)
   {
-    TASK_DELAY(1);
+    if (ret)
+      retain_replay(bus, type, context, callback);
+    EVENTBUS_MUTEX_UNLOCK(&bus->retain_mutex);
   }
 
+  return ret;
+}
+
+EventSubscriber *eventbus_subscribe_async(EventBus *bus, EventType type, uint8_t priority, void *context, EventAsyncCallback callback)
+{
+  if (bus->async_task_pool.block_count == 0)
+    return NULL;
+
+  EventSubscriberFn fn;
+  fn.async = callback;
+  EVENTBUS_MUTEX_LOCK(&bus->subs_mutex);
+  EventSubscriber *ret = sub_add(bus, type, priority, context, fn, true);
+  EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
+  return ret;
+}
+
+/**
+ * @brief Видаляє підписника з EventBus.
+ *
+ * Видаляє рядок підписника з таблиці, повертає дескриптор у список вільних та публікує новий знімок таблиці
+ * диспетчеризації. Не чекає на потік обробки подій.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param subscriber Вказівник на підписника, який потрібно видалити.
+ * @return 0 при успіху, -1 якщо subscriber == NULL.
+ */
+int eventbus_unsubscribe(EventBus *bus, EventSubscriber *subscriber)
+{
+  if (!subscriber)
+    return -1;
+
   EVENTBUS_MUTEX_LOCK(&bus->subs_mutex);
 
-  remove_subscriber(bus, idx);
+  if (subscriber->status == sub_slot_free)
+  {
+    EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
+    return -1;
+  }
+  // Нове покоління одразу виключає слот з усіх знімків, навіть якщо новий знімок не вдасться побудувати
+  atomic_fetch_add_explicit(&subscriber->generation, 1, memory_order_release);
+  remove_subscriber(bus, subscriber);
+  dispatch_publish(bus);
 
   EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
   return 0;
@@ -507,12 +2740,396 @@ int eventbus_unsubscribe(EventBus *bus, EventSubscriber *subscriber)
  */
 int eventbus_publish(EventBus *bus, EventType type, EventInputData input, EventResultData result)
 {
-  if (type.category == 0 || type.id == 0)
+  if (type.category == 0 || type.id == 0 || !event_input_valid(&input))
+    return -1;
+
+  Event evt;
+  evt.type = type;
+  evt.input = input;
+  evt.result = result;
+  evt.priority = event_priority_normal;
+  return queue_push(bus, &evt, bus->config.overflow_policy, bus->config.overflow_timeout_ms);
+}
+
+/**
+ * @brief Публікує подію з заданим класом пріоритету.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param priority Клас пріоритету події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату.
+ * @return 0 при успішній публікації, -1 при помилці.
+ */
+int eventbus_publish_priority(EventBus *bus, EventType type, EventPriority priority, EventInputData input, EventResultData result)
+{
+  if (type.category == 0 || type.id == 0 || !event_input_valid(&input))
+    return -1;
+
+  Event evt;
+  evt.type = type;
+  evt.input = input;
+  evt.result = result;
+  evt.priority = priority;
+  return queue_push(bus, &evt, bus->config.overflow_policy, bus->config.overflow_timeout_ms);
+}
+
+/**
+ * @brief Публікує подію, чекаючи на місце в черзі не довше timeout_ms.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату.
+ * @param timeout_ms Максимальне очікування, мс.
+ * @return 0 при успішній публікації, -1 при помилці або після таймауту.
+ */
+int eventbus_publish_timeout(EventBus *bus, EventType type, EventInputData input, EventResultData result, uint32_t timeout_ms)
+{
+  if (type.category == 0 || type.id == 0 || !event_input_valid(&input))
+    return -1;
+
+  Event evt;
+  evt.type = type;
+  evt.input = input;
+  evt.result = result;
+  evt.priority = event_priority_normal;
+  return queue_push(bus, &evt, timeout_ms == 0 ? event_overflow_reject : event_overflow_timeout, timeout_ms);
+}
+
+/**
+ * @brief Публікує подію синхронно, в потоці, що викликає функцію.
+ *
+ * Обробка та сама, що й у потоці обробки (process_event): знімок підписників читається через RCU,
+ * тож виклик безпечний з будь-якого потоку і з callback‑функцій.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату.
+ * @return 0 при успішній обробці, -1 при помилці.
+ */
+int eventbus_publish_sync(EventBus *bus, EventType type, EventInputData input, EventResultData result)
+{
+  if (type.category == 0 || type.id == 0 || !event_input_valid(&input))
     return -1;
 
   Event evt;
   evt.type = type;
   evt.input = input;
   evt.result = result;
-  return queue_push(bus, &evt);
+  evt.priority = event_priority_normal;
+  process_event(bus, &evt);
+  return 0;
+}
+
+/**
+ * @brief Публікує подію та повертає запит, який завершиться разом з її обробкою.
+ *
+ * Запит утримують викликач і подія, тож він повертається в пул, коли подію оброблено
+ * (або викинуто) і викликач відпустив його через eventbus_request_release.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param type Тип події.
+ * @param input Вхідні дані події.
+ * @param result Дані для повернення результату.
+ * @return Запит або NULL при помилці.
+ */
+EventRequest *eventbus_request(EventBus *bus, EventType type, EventInputData input, EventResultData result)
+{
+  if (type.category == 0 || type.id == 0 || !event_input_valid(&input))
+    return NULL;
+  EventRequest *request = (EventRequest *)eventbus_pool_alloc(&bus->request_pool);
+  if (!request)
+    return NULL;
+  atomic_store_explicit(&request->state, event_request_pending, memory_order_relaxed);
+  atomic_store_explicit(&request->refs, 2, memory_order_relaxed);
+  atomic_store_explicit(&request->waiting, false, memory_order_relaxed);
+  request->then_fn = NULL;
+  request->then_context = NULL;
+
+  Event evt;
+  evt.type = type;
+  evt.input = input;
+  evt.result = result;
+  evt.result.request = request;
+  evt.priority = event_priority_normal;
+  if (queue_push(bus, &evt, bus->config.overflow_policy, bus->config.overflow_timeout_ms) != 0)
+  {
+    eventbus_pool_release(&bus->request_pool, request);
+    return NULL;
+  }
+  return request;
+}
+
+EventRequestStatus eventbus_request_poll(EventRequest *request)
+{
+  return atomic_load_explicit(&request->state, memory_order_acquire) & REQUEST_STATUS_MASK;
+}
+
+/**
+ * @brief Чекає на завершення запиту не довше timeout_ms.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param request Вказівник на запит.
+ * @param timeout_ms Максимальне очікування, мс.
+ * @return Стан запиту.
+ */
+EventRequestStatus eventbus_request_wait(EventBus *bus, EventRequest *request, uint32_t timeout_ms)
+{
+  EventRequestStatus status = eventbus_request_poll(request);
+  if (status != event_request_pending || timeout_ms == 0)
+    return status;
+  uint64_t deadline = UINT64_MAX;
+  if (timeout_ms != EVENTBUS_WAIT_FOREVER)
+    deadline = EVENTBUS_TIME_MS() + timeout_ms;
+
+  EVENTBUS_MUTEX_LOCK(&bus->request_mutex);
+  atomic_fetch_add_explicit(&bus->request_waiters, 1, memory_order_relaxed);
+  atomic_store(&request->waiting, true);
+  while ((status = (EventRequestStatus)(atomic_load(&request->state) & REQUEST_STATUS_MASK)) == event_request_pending)
+  {
+    if (deadline == UINT64_MAX)
+    {
+      EVENTBUS_COND_WAIT(&request->cond, &bus->request_mutex);
+      continue;
+    }
+    uint64_t now = EVENTBUS_TIME_MS();
+    if (now >= deadline)
+      break;
+    EVENTBUS_COND_TIMEDWAIT(&request->cond, &bus->request_mutex, (uint32_t)(deadline - now));
+  }
+  atomic_store_explicit(&request->waiting, false, memory_order_relaxed);
+  if (atomic_fetch_sub_explicit(&bus->request_waiters, 1, memory_order_relaxed) == 1)
+    EVENTBUS_COND_SIGNAL(&bus->stop_cond); // eventbus_stop чекає, поки останній викликач відпустить request_mutex
+  EVENTBUS_MUTEX_UNLOCK(&bus->request_mutex);
+  return status;
+}
+
+/**
+ * @brief Встановлює продовження запиту.
+ *
+ * Продовження записується до виставлення прапорця REQUEST_THEN, а стан запиту змінюється одним
+ * атомарним fetch_or, тож продовження викликає рівно один з двох: request_complete, якщо побачив
+ * прапорець, або ця функція, якщо побачила завершений стан.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param request Вказівник на запит.
+ * @param fn Продовження.
+ * @param context Контекст продовження.
+ * @return 0 при успіху, -1 якщо продовження вже встановлене.
+ */
+int eventbus_request_then(EventBus *bus, EventRequest *request, EventRequestContinuation fn, void *context)
+{
+  if (atomic_load_explicit(&request->state, memory_order_relaxed) & REQUEST_THEN)
+    return -1;
+  request->then_fn = fn;
+  request->then_context = context;
+  uint8_t old = atomic_fetch_or_explicit(&request->state, REQUEST_THEN, memory_order_acq_rel);
+  if (old & REQUEST_STATUS_MASK)
+    fn(bus, request, context);
+  return 0;
+}
+
+void eventbus_request_release(EventBus *bus, EventRequest *request)
+{
+  if (request)
+    request_unref(bus, request);
+}
+
+/**
+ * @brief Публікує пачку подій.
+ *
+ * Послідовні події, що потрапляють в один шард, додаються до його черги одним атомарним
+ * резервуванням позицій, а потік обробки будиться один раз на всю пачку.
+ *
+ * @param bus Вказівник на EventBus.
+ * @param events Масив подій.
+ * @param n Кількість подій.
+ * @return Кількість опублікованих подій (перші елементи масиву).
+ */
+size_t eventbus_publish_batch(EventBus *bus, Event *events, size_t n)
+{
+  size_t published = 0;
+  EVENTBUS_STAT(uint64_t now = EVENTBUS_TIME_NS());
+  while (published < n)
+  {
+    if (!event_input_valid(&events[published].input))
+      break;
+    EventTopic *topic = topic_find(bus, events[published].type);
+    if (topic && events[published].type.category != 0 && events[published].type.id != 0)
+    {
+      topic_publish(bus, topic, &events[published]);
+      published++;
+      continue;
+    }
+
+    // Знаходимо серію подій з одним шардом і однією смугою
+    EventShard *shard = queue_shard(bus, &events[published]);
+    EventQueue *queue = queue_lane(bus, shard, &events[published]);
+    size_t run = 0;
+    while (published + run < n)
+    {
+      const Event *evt = &events[published + run];
+      if (evt->type.category == 0 || evt->type.id == 0 || !event_input_valid(&evt->input))
+        break;
+      if (run > 0 && (queue_shard(bus, evt) != shard || queue_lane(bus, shard, evt) != queue || topic_find(bus, evt->type)))
+        break;
+      EVENTBUS_STAT(events[published + run].enqueue_ns = now);
+      run++;
+    }
+    if (run == 0)
+      break; // заборонений тип події або недійсні дані
+
+    size_t pushed = eventbus_queue_push_batch(queue, &events[published], run);
+    published += pushed;
+    EVENTBUS_STAT_ADD(bus->stats, published, pushed);
+    EVENTBUS_STAT(eventbus_stats_depth(bus->stats, (uint32_t)eventbus_queue_depth(queue)));
+    if (pushed < run)
+    {
+      EVENTBUS_STAT_ADD(bus->stats, rejected, n - published);
+      break; // черга переповнена
+    }
+  }
+  if (published > 0)
+    queue_wake(bus);
+  return published;
+}
+
+int eventbus_conflate(EventBus *bus, EventType type)
+{
+  if (type.category == 0 || type.id == 0)
+    return -1;
+  int ret = 0;
+  EVENTBUS_MUTEX_LOCK(&bus->topic_mutex);
+  uint16_t count = atomic_load_explicit(&bus->topic_count, memory_order_relaxed);
+  if (topic_find(bus, type) == NULL)
+  {
+    if (count < bus->config.topic_count)
+    {
+      EventTopic *topic = &bus->topics[count];
+      topic->key = event_key(type);
+      topic->pending = false;
+      topic->queued = false;
+      topic->ready_next = NULL;
+      atomic_store_explicit(&bus->topic_count, (uint16_t)(count + 1), memory_order_release);
+    }
+    else
+      ret = -1;
+  }
+  EVENTBUS_MUTEX_UNLOCK(&bus->topic_mutex);
+  return ret;
+}
+
+int eventbus_retain(EventBus *bus, EventType type, uint8_t depth)
+{
+  if (type.category == 0 || type.id == 0 || depth == 0)
+    return -1;
+  int ret = -1;
+  EVENTBUS_MUTEX_LOCK(&bus->retain_mutex);
+  uint16_t count = atomic_load_explicit(&bus->retained_count, memory_order_relaxed);
+  if (bus->retained && retain_find(bus, type) == NULL && count < bus->config.retain_type_count &&
+      depth <= bus->config.retain_block_count - bus->retain_entries_used)
+  {
+    EventRetained *retained = &bus->retained[count];
+    retained->entries = bus->retain_entries + bus->retain_entries_used;
+    memset(retained->entries, 0, sizeof(EventRetainedEntry) * depth);
+    uint8_t reserved = 0;
+    while (reserved < depth &&
+           (retained->entries[reserved].data = (uint8_t *)eventbus_pool_alloc(&bus->retain_pool)) != NULL)
+      reserved++;
+    if (reserved == depth)
+    {
+      retained->key = event_key(type);
+      retained->depth = depth;
+      retained->used = 0;
+      retained->head = 0;
+      bus->retain_entries_used += depth;
+      atomic_store_explicit(&bus->retained_count, (uint16_t)(count + 1), memory_order_release);
+      ret = 0;
+    }
+    else
+    {
+      while (reserved > 0)
+        eventbus_pool_release(&bus->retain_pool, retained->entries[--reserved].data);
+      retained->entries = NULL;
+    }
+  }
+  EVENTBUS_MUTEX_UNLOCK(&bus->retain_mutex);
+  return ret;
+}
+
+// ==================== Статистика ====================
+
+#if defined(EVENTBUS_STATS)
+
+/**
+ * @brief Повертає знімок статистики EventBus.
+ *
+ * Знімок виділяється одним блоком: масиви types та subscribers розміщені одразу за структурою.
+ * Список підписників читається під subs_mutex, лічильники – атомарно без блокувань.
+ *
+ * @param bus Вказівник на EventBus.
+ * @return Знімок або NULL при помилці виділення пам’яті.
+ */
+EventBusStats *eventbus_get_stats(EventBus *bus)
+{
+  EventStatsState *stats = bus->stats;
+  EVENTBUS_MUTEX_LOCK(&bus->subs_mutex);
+
+  // Типи можуть додаватись одночасно, тож знімок містить не більше записів, ніж порахованих тут
+  uint16_t type_count = 0, sub_count = 0;
+  for (size_t i = 0; i <= EVENTBUS_STATS_TYPES; i++)
+    if (i == EVENTBUS_STATS_TYPES ? atomic_load(&stats->types[i].callback.count) != 0 : atomic_load(&stats->types[i].key) != 0)
+      type_count++;
+  sub_count = bus->sub_count;
+
+  EventBusStats *out = (EventBusStats *)malloc(sizeof(EventBusStats) +
+                                               sizeof(EventBusTypeStats) * type_count +
+                                               sizeof(EventBusSubscriberStats) * sub_count);
+  if (!out)
+  {
+    EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
+    return NULL;
+  }
+  out->types = (EventBusTypeStats *)(out + 1);
+  out->subscribers = (EventBusSubscriberStats *)(out->types + type_count);
+
+  out->published = atomic_load_explicit(&stats->published, memory_order_relaxed);
+  out->rejected = atomic_load_explicit(&stats->rejected, memory_order_relaxed);
+  out->evicted = atomic_load_explicit(&stats->evicted, memory_order_relaxed);
+  out->coalesced = atomic_load_explicit(&stats->coalesced, memory_order_relaxed);
+  out->dispatched = atomic_load_explicit(&stats->dispatched, memory_order_relaxed);
+  out->queue_high_water = atomic_load_explicit(&stats->high_water, memory_order_relaxed);
+  out->queue_depth = 0;
+  for (size_t i = 0; i <= bus->shard_mask; i++)
+    for (uint8_t lane = 0; lane < bus->config.lane_count; lane++)
+      out->queue_depth += (uint32_t)eventbus_queue_depth(&bus->shards[i].lanes[lane]);
+  eventbus_stats_copy(&out->queue_latency, &stats->queue_latency);
+
+  out->type_count = 0;
+  for (size_t i = 0; i <= EVENTBUS_STATS_TYPES && out->type_count < type_count; i++)
+  {
+    uint16_t key = atomic_load(&stats->types[i].key);
+    if (i == EVENTBUS_STATS_TYPES ? atomic_load(&stats->types[i].callback.count) == 0 : key == 0)
+      continue;
+    EventBusTypeStats *t = &out->types[out->type_count++];
+    t->type = event_type((uint8_t)(key >> 8), (uint8_t)key);
+    eventbus_stats_copy(&t->callback, &stats->types[i].callback);
+  }
+
+  // Підписники перелічуються в порядку пріоритету
+  out->subscriber_count = sub_count;
+  for (uint16_t row = 0; row < sub_count; row++)
+  {
+    EventBusSubscriberStats *sub = &out->subscribers[row];
+    sub->subscriber = sub_handle(bus, bus->sub_slots[row]);
+    sub->type = event_type((uint8_t)(bus->sub_keys[row] >> 8), (uint8_t)bus->sub_keys[row]);
+    eventbus_stats_copy(&sub->callback, sub->subscriber->stats);
+  }
+
+  EVENTBUS_MUTEX_UNLOCK(&bus->subs_mutex);
+  return out;
 }
+
+#endif
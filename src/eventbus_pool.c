@@ -0,0 +1,116 @@
+/**
+ * @file eventbus_pool.c
+ * @brief Реалізація пулу блоків фіксованого розміру.
+ */
+
+#include "eventbus_pool.h"
+
+#define POOL_EMPTY 0xFFFFu
+
+static inline uint32_t pool_head(uint16_t tag, uint16_t index)
+{
+  return ((uint32_t)tag << 16) | index;
+}
+
+void *eventbus_arena_alloc(EventArena *arena, size_t size)
+{
+  if (!arena || !arena->base)
+    return malloc(size);
+  size = EVENTBUS_STATIC_ALIGN_UP(size);
+  if (size > arena->size - arena->used)
+    return NULL;
+  void *ptr = arena->base + arena->used;
+  arena->used += size;
+  return ptr;
+}
+
+void eventbus_arena_free(EventArena *arena, void *ptr)
+{
+  if (!arena || !arena->base)
+    free(ptr);
+}
+
+int eventbus_pool_init(EventPool *pool, size_t block_size, uint16_t block_count, EventArena *arena)
+{
+  if (block_count == POOL_EMPTY)
+    block_count--; // індекс 0xFFFF зарезервовано під порожній стек
+  block_size = (block_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+  pool->block_size = block_size;
+  pool->block_count = block_count;
+  pool->blocks = NULL;
+  pool->next = NULL;
+  pool->arena = arena;
+  atomic_init(&pool->head, pool_head(0, POOL_EMPTY));
+  if (block_count == 0 || block_size == 0)
+  {
+    pool->block_count = 0;
+    return 0;
+  }
+
+  pool->blocks = (uint8_t *)eventbus_arena_alloc(arena, block_size * block_count);
+  pool->next = (EVENTBUS_ATOMIC(uint16_t) *)eventbus_arena_alloc(arena, sizeof(*pool->next) * block_count);
+  if (!pool->blocks || !pool->next)
+  {
+    eventbus_pool_free(pool);
+    return -1;
+  }
+  for (uint16_t i = 0; i < block_count; i++)
+  {
+    uint16_t next = (uint16_t)(i + 1u);
+    atomic_init(&pool->next[i], next < block_count ? next : (uint16_t)POOL_EMPTY);
+  }
+  atomic_store(&pool->head, pool_head(0, 0));
+  return 0;
+}
+
+void eventbus_pool_free(EventPool *pool)
+{
+  eventbus_arena_free(pool->arena, pool->blocks);
+  eventbus_arena_free(pool->arena, (void *)pool->next);
+  pool->blocks = NULL;
+  pool->next = NULL;
+  pool->block_count = 0;
+  atomic_store(&pool->head, pool_head(0, POOL_EMPTY));
+}
+
+void *eventbus_pool_alloc(EventPool *pool)
+{
+  uint32_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+  while (true)
+  {
+    uint16_t index = (uint16_t)head;
+    if (index == POOL_EMPTY)
+      return NULL;
+    // next може виявитись застарілим, якщо блок встигли забрати інші потоки, але тоді зміниться тег і CAS не пройде
+    uint16_t next = atomic_load_explicit(&pool->next[index], memory_order_relaxed);
+    if (atomic_compare_exchange_weak_explicit(&pool->head, &head, pool_head((uint16_t)(head >> 16) + 1, next),
+                                              memory_order_acquire, memory_order_acquire))
+      return pool->blocks + (size_t)index * pool->block_size;
+  }
+}
+
+void eventbus_pool_release(EventPool *pool, void *block)
+{
+  uint16_t index = (uint16_t)(((uint8_t *)block - pool->blocks) / pool->block_size);
+  uint32_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+  while (true)
+  {
+    atomic_store_explicit(&pool->next[index], (uint16_t)head, memory_order_relaxed);
+    if (atomic_compare_exchange_weak_explicit(&pool->head, &head, pool_head((uint16_t)(head >> 16) + 1, index),
+                                              memory_order_release, memory_order_relaxed))
+      return;
+  }
+}
+
+bool eventbus_pool_owns(const EventPool *pool, const void *ptr)
+{
+  const uint8_t *p = (const uint8_t *)ptr;
+  if (pool->block_count == 0 || p < pool->blocks || p >= pool->blocks + pool->block_size * pool->block_count)
+    return false;
+  return (size_t)(p - pool->blocks) % pool->block_size == 0;
+}
+
+bool eventbus_pool_empty(EventPool *pool)
+{
+  return (uint16_t)atomic_load(&pool->head) == POOL_EMPTY;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file eventbus_pool.h
+ * @brief Внутрішній інтерфейс пулу блоків фіксованого розміру.
+ *
+ * Пул виділяє пам’ять один раз при ініціалізації. Вільні блоки утримуються в lock-free стеку,
+ * голова якого містить індекс блоку та лічильник змін (захист від ABA), тож брати і повертати
+ * блоки можна з будь-яких потоків без м’ютексів і без звернень до malloc/free.
+ */
+
+#ifndef EVENTBUS_POOL_H
+#define EVENTBUS_POOL_H
+
+#include "eventbus.h"
+
+/**
+ * @brief Ініціалізує пул.
+ *
+ * @param pool Вказівник на пул.
+ * @param block_size Розмір блоку (округлюється вгору до вирівнювання вказівника).
+ * @param block_count Кількість блоків; 0 – порожній пул без виділення пам’яті.
+ * @param arena Пам’ять для блоків або NULL, щоб виділити їх з купи.
+ * @return 0 при успіху, -1 при помилці виділення пам’яті.
+ */
+int eventbus_pool_init(EventPool *pool, size_t block_size, uint16_t block_count, EventArena *arena);
+
+/**
+ * @brief Звільняє пам’ять пулу.
+ *
+ * @param pool Вказівник на пул.
+ */
+void eventbus_pool_free(EventPool *pool);
+
+/**
+ * @brief Бере вільний блок з пулу.
+ *
+ * @param pool Вказівник на пул.
+ * @return Вказівник на блок або NULL, якщо вільних блоків немає.
+ */
+void *eventbus_pool_alloc(EventPool *pool);
+
+/**
+ * @brief Повертає блок у пул.
+ *
+ * @param pool Вказівник на пул.
+ * @param block Вказівник на блок, отриманий з eventbus_pool_alloc.
+ */
+void eventbus_pool_release(EventPool *pool, void *block);
+
+/**
+ * @brief Перевіряє, чи належить вказівник блоку пулу.
+ *
+ * @param pool Вказівник на пул.
+ * @param ptr Вказівник.
+ * @return true, якщо ptr вказує на початок блоку пулу.
+ */
+bool eventbus_pool_owns(const EventPool *pool, const void *ptr);
+
+/**
+ * @brief Перевіряє, чи закінчились вільні блоки. Безпечно для виклику з будь-якого потоку.
+ *
+ * @param pool Вказівник на пул.
+ * @return true, якщо вільних блоків немає.
+ */
+bool eventbus_pool_empty(EventPool *pool);
+
+/**
+ * @brief Виділяє пам’ять з arena або, якщо arena не задана, з купи.
+ *
+ * Пам’ять не обнуляється. З arena виділення лише послідовне, з вирівнюванням EVENTBUS_STATIC_ALIGN.
+ *
+ * @param arena Вказівник на arena; NULL або arena без пам’яті – купа.
+ * @param size Розмір, байт.
+ * @return Вказівник на пам’ять або NULL, якщо її не вистачило.
+ */
+void *eventbus_arena_alloc(EventArena *arena, size_t size);
+
+/**
+ * @brief Звільняє пам’ять з eventbus_arena_alloc. Пам’ять arena не звільняється, її повертає викликач.
+ *
+ * @param arena Та сама arena, що й при виділенні.
+ * @param ptr Вказівник на пам’ять або NULL.
+ */
+void eventbus_arena_free(EventArena *arena, void *ptr);
+
+#endif
@@ -0,0 +1,718 @@
+/**
+ * @file eventbus_queue.c
+ * @brief Реалізація lock-free черги подій EventBus.
+ */
+
+#include "eventbus_queue.h"
+#include "eventbus_pool.h"
+
+// Старший біт tail: сегмент закритий для запису
+#define QUEUE_CLOSED ((size_t)1 << (sizeof(size_t) * 8 - 1))
+
+// Поля EventDescriptor::flags
+#define DESC_PRIORITY_MASK 0x03u
+#define DESC_STORAGE_SHIFT 2
+#define DESC_STORAGE_MASK 0x1Cu
+#define DESC_EXT 0x80u
+
+// Скільки подій eventbus_queue_push_batch кодує в дескриптори за один прохід
+#define QUEUE_ENCODE_BATCH 16
+
+// ==================== Облік пам’яті ====================
+
+bool eventbus_budget_reserve(EventMemoryBudget *budget, size_t size)
+{
+  size_t used = atomic_load_explicit(&budget->used, memory_order_relaxed);
+  do
+  {
+    if (budget->limit != 0 && (size > budget->limit || used > budget->limit - size))
+      return false;
+  } while (!atomic_compare_exchange_weak_explicit(&budget->used, &used, used + size,
+                                                  memory_order_relaxed, memory_order_relaxed));
+  return true;
+}
+
+void eventbus_budget_release(EventMemoryBudget *budget, size_t size)
+{
+  atomic_fetch_sub_explicit(&budget->used, size, memory_order_relaxed);
+}
+
+static bool budget_fits(const EventMemoryBudget *budget, size_t size)
+{
+  size_t used = atomic_load_explicit(&budget->used, memory_order_relaxed);
+  return budget->limit == 0 || (size <= budget->limit && used <= budget->limit - size);
+}
+
+// ==================== Дескриптори ====================
+
+/**
+ * @brief Перевіряє, чи описується подія самим дескриптором, без запису бічної таблиці.
+ *
+ * Рішення залежить лише від storage та callback‑функцій: context без read_fn/size_fn нічого
+ * не означає, тож при відновленні з дескриптора він дорівнює NULL.
+ */
+static bool desc_plain(const Event *evt)
+{
+  if (evt->result.write_fn != eventbus_result_devnull || evt->result.done_fn || evt->result.context ||
+      evt->result.request)
+    return false;
+  switch (evt->input.storage)
+  {
+  case event_data_heap:
+  case event_data_pool:
+    return !evt->input.read_fn && !evt->input.size_fn && (uint64_t)evt->input.data_size <= UINT32_MAX;
+#if EVENTBUS_INLINE_SIZE > 0
+  case event_data_inline:
+    return evt->input.data_size <= sizeof(((EventDescriptor *)0)->payload.bytes);
+#endif
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Записує подію в дескриптор; подію, що в нього не вміщується, – в запис бічної таблиці.
+ *
+ * @param ext Запис бічної таблиці, який можна використати повторно; NULL – взяти новий.
+ * @return false, якщо подія потребує запису, а бічна таблиця заповнена.
+ */
+static bool desc_encode(EventQueue *q, const Event *evt, EventDescriptor *desc, Event *ext)
+{
+  desc->type = evt->type;
+  desc->reserved = 0;
+#if defined(EVENTBUS_STATS)
+  desc->enqueue_ns = evt->enqueue_ns;
+#endif
+  if (desc_plain(evt))
+  {
+    desc->flags = (uint8_t)(((unsigned)evt->priority & DESC_PRIORITY_MASK) |
+                            ((unsigned)evt->input.storage << DESC_STORAGE_SHIFT));
+    desc->size = (uint32_t)evt->input.data_size;
+#if EVENTBUS_INLINE_SIZE > 0
+    if (evt->input.storage == event_data_inline)
+    {
+      memcpy(desc->payload.bytes, evt->input.inline_data, evt->input.data_size);
+      return true;
+    }
+#endif
+    desc->payload.data = evt->input.direct_data;
+    return true;
+  }
+  if (!ext && !(ext = (Event *)eventbus_pool_alloc(&q->ext)))
+    return false;
+  *ext = *evt;
+  desc->flags = (uint8_t)(((unsigned)evt->priority & DESC_PRIORITY_MASK) | DESC_EXT);
+  desc->size = 0;
+  desc->payload.data = ext;
+  return true;
+}
+
+/**
+ * @brief Відновлює подію з дескриптора. Запис бічної таблиці залишається зайнятим.
+ */
+static void desc_decode(const EventDescriptor *desc, Event *evt)
+{
+  if (desc->flags & DESC_EXT)
+  {
+    *evt = *(const Event *)desc->payload.data;
+    return;
+  }
+  evt->type = desc->type;
+  evt->priority = (EventPriority)(desc->flags & DESC_PRIORITY_MASK);
+  evt->stream_failed = false;
+  evt->input.read_fn = NULL;
+  evt->input.size_fn = NULL;
+  evt->input.context = NULL;
+  evt->input.storage = (EventDataStorage)((desc->flags & DESC_STORAGE_MASK) >> DESC_STORAGE_SHIFT);
+  evt->input.data_size = desc->size;
+  evt->input.direct_data = desc->payload.data;
+#if EVENTBUS_INLINE_SIZE > 0
+  if (evt->input.storage == event_data_inline)
+  {
+    // direct_data спрямовується на inline_data копії події перед обробкою (event_input_bind)
+    memcpy(evt->input.inline_data, desc->payload.bytes, desc->size);
+    evt->input.direct_data = NULL;
+  }
+#endif
+  evt->result.write_fn = eventbus_result_devnull;
+  evt->result.done_fn = NULL;
+  evt->result.context = NULL;
+  evt->result.request = NULL;
+  evt->chunk = NULL;
+#if defined(EVENTBUS_STATS)
+  evt->enqueue_ns = desc->enqueue_ns;
+#endif
+}
+
+/**
+ * @brief Повертає в бічну таблицю запис дескриптора, якщо він є.
+ */
+static inline void desc_discard(EventQueue *q, const EventDescriptor *desc)
+{
+  if (desc->flags & DESC_EXT)
+    eventbus_pool_release(&q->ext, desc->payload.data);
+}
+
+// ==================== Сегменти ====================
+
+static size_t segment_bytes(size_t capacity)
+{
+  return sizeof(EventQueueSegment) + sizeof(EventQueueSlot) * capacity;
+}
+
+static void segment_init(EventQueueSegment *seg, EventQueueSlot *slots, size_t capacity)
+{
+  seg->slots = slots;
+  seg->mask = capacity - 1;
+  for (size_t i = 0; i < capacity; i++)
+  {
+    atomic_init(&seg->slots[i].seq, i);
+    seg->slots[i].desc.flags = 0;
+    seg->slots[i].desc.size = 0;
+  }
+  atomic_init(&seg->tail, 0);
+  atomic_init(&seg->head, 0);
+  atomic_init(&seg->next, NULL);
+  seg->retired_next = NULL;
+}
+
+/**
+ * @brief Створює сегмент черги, що росте; заголовок і слоти розміщуються одним блоком.
+ *
+ * @return Сегмент або NULL при помилці виділення пам’яті чи перевищенні межі.
+ */
+static EventQueueSegment *segment_create(EventQueue *q, size_t capacity)
+{
+  if (!eventbus_budget_reserve(q->budget, segment_bytes(capacity)))
+    return NULL;
+  EventQueueSegment *seg = (EventQueueSegment *)malloc(segment_bytes(capacity));
+  if (!seg)
+  {
+    eventbus_budget_release(q->budget, segment_bytes(capacity));
+    return NULL;
+  }
+  segment_init(seg, (EventQueueSlot *)(seg + 1), capacity);
+  return seg;
+}
+
+static void segment_destroy(EventQueue *q, EventQueueSegment *seg)
+{
+  size_t capacity = seg->mask + 1;
+  if (seg == &q->first)
+  {
+    eventbus_arena_free(q->arena, seg->slots);
+    seg->slots = NULL;
+    if (q->budget)
+      eventbus_budget_release(q->budget, sizeof(EventQueueSlot) * capacity);
+    return;
+  }
+  free(seg);
+  eventbus_budget_release(q->budget, segment_bytes(capacity));
+}
+
+/**
+ * @brief Додає дескриптор події до сегмента.
+ *
+ * @return 0 при успіху, -1 якщо сегмент заповнений, 1 якщо сегмент закритий.
+ */
+static int segment_push(EventQueueSegment *seg, const EventDescriptor *desc)
+{
+  EventQueueSlot *slot;
+  size_t pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+  while (true)
+  {
+    if (pos & QUEUE_CLOSED)
+      return 1;
+    slot = &seg->slots[pos & seg->mask];
+    size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0)
+    {
+      // Слот вільний: пробуємо зайняти позицію
+      if (atomic_compare_exchange_weak_explicit(&seg->tail, &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+      return -1; // сегмент заповнений: слот ще не звільнений споживачем
+    else
+      pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+  }
+  slot->desc = *desc;
+  atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+  return 0;
+}
+
+/**
+ * @brief Додає до сегмента стільки дескрипторів, скільки вміщується, одним резервуванням позицій.
+ *
+ * @return Кількість доданих дескрипторів; 0, якщо сегмент заповнений або закритий.
+ */
+static size_t segment_push_batch(EventQueueSegment *seg, const EventDescriptor *descs, size_t n)
+{
+  size_t capacity = seg->mask + 1;
+  size_t head = atomic_load_explicit(&seg->head, memory_order_relaxed);
+  size_t pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+  size_t count;
+  while (true)
+  {
+    if (pos & QUEUE_CLOSED)
+      return 0;
+    size_t used = pos - head;
+    if (used >= capacity)
+    {
+      // Або сегмент справді заповнений, або прочитаний head застарів
+      size_t fresh = atomic_load_explicit(&seg->head, memory_order_relaxed);
+      if (fresh == head)
+        return 0;
+      head = fresh;
+      continue;
+    }
+    count = n < capacity - used ? n : capacity - used;
+
+    // Споживач звільняє слоти по порядку, тож вільний останній слот означає, що вільні всі
+    size_t last = pos + count - 1;
+    size_t seq = atomic_load_explicit(&seg->slots[last & seg->mask].seq, memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)last;
+    if (diff == 0)
+    {
+      if (atomic_compare_exchange_weak_explicit(&seg->tail, &pos, pos + count,
+                                                memory_order_relaxed, memory_order_relaxed))
+        break;
+    }
+    else
+    {
+      // Прочитаний head застарів або позиції вже зайняли інші продюсери
+      head = atomic_load_explicit(&seg->head, memory_order_relaxed);
+      pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+    }
+  }
+
+  for (size_t i = 0; i < count; i++)
+  {
+    EventQueueSlot *slot = &seg->slots[(pos + i) & seg->mask];
+    slot->desc = descs[i];
+    atomic_store_explicit(&slot->seq, pos + i + 1, memory_order_release);
+  }
+  return count;
+}
+
+static bool segment_ready(EventQueueSegment *seg)
+{
+  size_t pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+  return atomic_load_explicit(&seg->slots[pos & seg->mask].seq, memory_order_acquire) == pos + 1;
+}
+
+/**
+ * @brief Перевіряє, чи закритий сегмент і чи прочитані всі зайняті в ньому позиції.
+ */
+static bool segment_drained(EventQueueSegment *seg)
+{
+  size_t tail = atomic_load_explicit(&seg->tail, memory_order_acquire);
+  return (tail & QUEUE_CLOSED) && atomic_load_explicit(&seg->head, memory_order_relaxed) == (tail & ~QUEUE_CLOSED);
+}
+
+static bool segment_full(EventQueueSegment *seg)
+{
+  size_t pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+  if (pos & QUEUE_CLOSED)
+    return false;
+  size_t seq = atomic_load_explicit(&seg->slots[pos & seg->mask].seq, memory_order_acquire);
+  return (intptr_t)seq - (intptr_t)pos < 0;
+}
+
+static size_t segment_depth(EventQueueSegment *seg)
+{
+  size_t head = atomic_load_explicit(&seg->head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&seg->tail, memory_order_relaxed) & ~QUEUE_CLOSED;
+  return tail - head <= seg->mask + 1 ? tail - head : 0;
+}
+
+// ==================== Черга ====================
+
+/**
+ * @brief Реєструє потік, що звертається до сегментів черги не як споживач.
+ *
+ * Як і rcu_read_lock: лічильник епохи збільшується до повторної перевірки епохи, тож споживач,
+ * що перемикає епоху, ніколи не пропустить відвідувача.
+ *
+ * @return Епоха, яку треба передати в queue_leave.
+ */
+static uint32_t queue_enter(EventQueue *q)
+{
+  while (true)
+  {
+    uint32_t epoch = atomic_load(&q->epoch);
+    atomic_fetch_add(&q->visitors[epoch & 1], 1);
+    if (atomic_load(&q->epoch) == epoch)
+      return epoch;
+    atomic_fetch_sub(&q->visitors[epoch & 1], 1);
+  }
+}
+
+static void queue_leave(EventQueue *q, uint32_t epoch)
+{
+  atomic_fetch_sub_explicit(&q->visitors[epoch & 1], 1, memory_order_release);
+}
+
+static void queue_free_list(EventQueue *q, EventQueueSegment *seg)
+{
+  while (seg)
+  {
+    EventQueueSegment *next = seg->retired_next;
+    segment_destroy(q, seg);
+    seg = next;
+  }
+}
+
+/**
+ * @brief Звільняє прочитані сегменти, з яких вийшли всі відвідувачі. Викликається лише споживачем.
+ *
+ * Та сама схема, що й rcu_reclaim: сегмент, відкладений в епосі e, можуть тримати відвідувачі
+ * епох e та e-1, тож список retired_waiting звільняється після перемикання на e+1, коли зникнуть
+ * відвідувачі епохи e. Функція ніколи не чекає.
+ */
+static void queue_reclaim(EventQueue *q)
+{
+  uint32_t epoch = atomic_load(&q->epoch);
+  if (q->retired_waiting && atomic_load(&q->visitors[(epoch - 1) & 1]) == 0)
+  {
+    queue_free_list(q, q->retired_waiting);
+    q->retired_waiting = NULL;
+  }
+  if (q->retired_waiting || !q->retired || atomic_load(&q->visitors[(epoch - 1) & 1]) != 0)
+    return;
+
+  atomic_store(&q->epoch, epoch + 1);
+  q->retired_waiting = q->retired;
+  q->retired = NULL;
+  if (atomic_load(&q->visitors[epoch & 1]) == 0)
+  {
+    queue_free_list(q, q->retired_waiting);
+    q->retired_waiting = NULL;
+  }
+}
+
+/**
+ * @brief Закриває заповнений сегмент запису seg і переводить продюсерів на наступний сегмент.
+ *
+ * Наступний сегмент удвічі більший за seg, а якщо він не вміщується в межу пам’яті –
+ * розміром з перший сегмент. Будь-який продюсер, що бачить заповнений або закритий сегмент,
+ * допомагає завершити перехід, тож черга не чекає на продюсера, який почав його першим.
+ *
+ * @return false, якщо новий сегмент не вдалось створити.
+ */
+static bool queue_grow(EventQueue *q, EventQueueSegment *seg)
+{
+  EventQueueSegment *next = atomic_load_explicit(&seg->next, memory_order_acquire);
+  if (!next)
+  {
+    next = segment_create(q, (seg->mask + 1) * 2);
+    if (!next)
+      next = segment_create(q, q->first.mask + 1);
+    if (!next)
+      return false;
+    EventQueueSegment *expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&seg->next, &expected, next,
+                                                 memory_order_acq_rel, memory_order_acquire))
+    {
+      // Сегмент уже додав інший продюсер
+      segment_destroy(q, next);
+      next = expected;
+    }
+  }
+  atomic_fetch_or_explicit(&seg->tail, QUEUE_CLOSED, memory_order_release);
+  atomic_compare_exchange_strong(&q->tail_seg, &seg, next);
+  return true;
+}
+
+/**
+ * @brief Повертає сегмент споживача, переходячи до наступного, коли поточний закритий і прочитаний.
+ *
+ * Прочитаний сегмент перестає бути сегментом запису ще до переходу, тож нові відвідувачі
+ * його вже не знайдуть, і він відкладається на звільнення.
+ */
+static EventQueueSegment *queue_head(EventQueue *q)
+{
+  if (!q->budget)
+    return &q->first;
+  EventQueueSegment *seg = atomic_load_explicit(&q->head_seg, memory_order_relaxed);
+  while (segment_drained(seg))
+  {
+    EventQueueSegment *next = atomic_load_explicit(&seg->next, memory_order_acquire);
+    EventQueueSegment *expected = seg;
+    atomic_compare_exchange_strong(&q->tail_seg, &expected, next);
+    atomic_store(&q->head_seg, next);
+    seg->retired_next = q->retired;
+    q->retired = seg;
+    seg = next;
+  }
+  if (q->retired || q->retired_waiting)
+    queue_reclaim(q);
+  return seg;
+}
+
+int eventbus_queue_init(EventQueue *q, size_t size, size_t ext_count, EventMemoryBudget *budget, EventArena *arena)
+{
+  size_t capacity = 2;
+  while (capacity < size)
+    capacity <<= 1;
+  if (ext_count == 0)
+    ext_count = capacity;
+  if (ext_count > UINT16_MAX - 1)
+    ext_count = UINT16_MAX - 1;
+
+  q->budget = budget;
+  q->arena = arena;
+  q->retired = NULL;
+  q->retired_waiting = NULL;
+  atomic_init(&q->epoch, 0);
+  atomic_init(&q->visitors[0], 0);
+  atomic_init(&q->visitors[1], 0);
+  atomic_init(&q->head_seg, NULL);
+  atomic_init(&q->tail_seg, NULL);
+  if (budget && !eventbus_budget_reserve(budget, sizeof(Event) * ext_count))
+    return -1;
+  if (eventbus_pool_init(&q->ext, sizeof(Event), (uint16_t)ext_count, arena) != 0)
+  {
+    if (budget)
+      eventbus_budget_release(budget, sizeof(Event) * ext_count);
+    return -1;
+  }
+  EventQueueSlot *slots = NULL;
+  if (!budget || eventbus_budget_reserve(budget, sizeof(EventQueueSlot) * capacity))
+  {
+    slots = (EventQueueSlot *)eventbus_arena_alloc(arena, sizeof(EventQueueSlot) * capacity);
+    if (!slots && budget)
+      eventbus_budget_release(budget, sizeof(EventQueueSlot) * capacity);
+  }
+  if (!slots)
+  {
+    if (budget)
+      eventbus_budget_release(budget, sizeof(Event) * q->ext.block_count);
+    eventbus_pool_free(&q->ext);
+    return -1;
+  }
+  segment_init(&q->first, slots, capacity);
+  atomic_init(&q->head_seg, &q->first);
+  atomic_init(&q->tail_seg, &q->first);
+  return 0;
+}
+
+void eventbus_queue_free(EventQueue *q)
+{
+  EventQueueSegment *seg = atomic_load(&q->head_seg);
+  while (seg)
+  {
+    EventQueueSegment *next = atomic_load(&seg->next);
+    segment_destroy(q, seg);
+    seg = next;
+  }
+  queue_free_list(q, q->retired);
+  queue_free_list(q, q->retired_waiting);
+  q->retired = q->retired_waiting = NULL;
+  atomic_store(&q->head_seg, NULL);
+  atomic_store(&q->tail_seg, NULL);
+  if (q->budget && q->ext.blocks)
+    eventbus_budget_release(q->budget, sizeof(Event) * q->ext.block_count);
+  eventbus_pool_free(&q->ext);
+}
+
+static int queue_push_desc(EventQueue *q, const EventDescriptor *desc)
+{
+  if (!q->budget)
+    return segment_push(&q->first, desc) == 0 ? 0 : -1;
+
+  int result = -1;
+  uint32_t epoch = queue_enter(q);
+  while (true)
+  {
+    EventQueueSegment *seg = atomic_load(&q->tail_seg);
+    if (segment_push(seg, desc) == 0)
+    {
+      result = 0;
+      break;
+    }
+    if (!queue_grow(q, seg))
+      break;
+  }
+  queue_leave(q, epoch);
+  return result;
+}
+
+static size_t queue_push_descs(EventQueue *q, const EventDescriptor *descs, size_t n)
+{
+  if (!q->budget)
+    return segment_push_batch(&q->first, descs, n);
+
+  size_t pushed = 0;
+  uint32_t epoch = queue_enter(q);
+  while (pushed < n)
+  {
+    EventQueueSegment *seg = atomic_load(&q->tail_seg);
+    size_t count = segment_push_batch(seg, descs + pushed, n - pushed);
+    pushed += count;
+    if (count == 0 && !queue_grow(q, seg))
+      break;
+  }
+  queue_leave(q, epoch);
+  return pushed;
+}
+
+int eventbus_queue_push(EventQueue *q, const Event *evt)
+{
+  // Подія кодується до резервування позиції, тож зайнята позиція завжди отримує дескриптор
+  EventDescriptor desc;
+  if (!desc_encode(q, evt, &desc, NULL))
+    return EVENTBUS_QUEUE_NO_EXT;
+  if (queue_push_desc(q, &desc) == 0)
+    return 0;
+  desc_discard(q, &desc);
+  return EVENTBUS_QUEUE_FULL;
+}
+
+size_t eventbus_queue_push_batch(EventQueue *q, const Event *evts, size_t n)
+{
+  size_t pushed = 0;
+  while (pushed < n)
+  {
+    EventDescriptor descs[QUEUE_ENCODE_BATCH];
+    size_t count = 0;
+    while (count < QUEUE_ENCODE_BATCH && pushed + count < n && desc_encode(q, &evts[pushed + count], &descs[count], NULL))
+      count++;
+    size_t added = count > 0 ? queue_push_descs(q, descs, count) : 0;
+    for (size_t i = added; i < count; i++)
+      desc_discard(q, &descs[i]);
+    pushed += added;
+    // Черга заповнилась або в бічній таблиці не вистачило записів
+    if (added < count || (count < QUEUE_ENCODE_BATCH && pushed < n))
+      break;
+  }
+  return pushed;
+}
+
+int eventbus_queue_pop(EventQueue *q, Event *evt)
+{
+  EventQueueSegment *seg = queue_head(q);
+  size_t pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+  EventQueueSlot *slot = &seg->slots[pos & seg->mask];
+  size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+  if (seq != pos + 1)
+    return -1; // черга порожня або подія в слоті ще записується
+  desc_decode(&slot->desc, evt);
+  desc_discard(q, &slot->desc);
+  // Звільняємо слот для продюсерів наступного кола
+  atomic_store_explicit(&slot->seq, pos + seg->mask + 1, memory_order_release);
+  atomic_store_explicit(&seg->head, pos + 1, memory_order_relaxed);
+  return 0;
+}
+
+size_t eventbus_queue_ready(EventQueue *q, size_t max)
+{
+  EventQueueSegment *seg = queue_head(q);
+  size_t pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+  size_t n = 0;
+  while (n < max && atomic_load_explicit(&seg->slots[(pos + n) & seg->mask].seq, memory_order_acquire) == pos + n + 1)
+    n++;
+  return n;
+}
+
+void eventbus_queue_peek(EventQueue *q, size_t i, Event *evt)
+{
+  EventQueueSegment *seg = q->budget ? atomic_load_explicit(&q->head_seg, memory_order_relaxed) : &q->first;
+  size_t pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+  desc_decode(&seg->slots[(pos + i) & seg->mask].desc, evt);
+}
+
+void eventbus_queue_consume(EventQueue *q, size_t n)
+{
+  EventQueueSegment *seg = q->budget ? atomic_load_explicit(&q->head_seg, memory_order_relaxed) : &q->first;
+  size_t pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+  for (size_t i = 0; i < n; i++)
+  {
+    EventQueueSlot *slot = &seg->slots[(pos + i) & seg->mask];
+    desc_discard(q, &slot->desc);
+    atomic_store_explicit(&slot->seq, pos + i + seg->mask + 1, memory_order_release);
+  }
+  atomic_store_explicit(&seg->head, pos + n, memory_order_relaxed);
+}
+
+int eventbus_queue_replace_newest(EventQueue *q, const Event *evt, Event *old)
+{
+  EventDescriptor *found = NULL;
+  for (EventQueueSegment *seg = queue_head(q); seg; seg = atomic_load_explicit(&seg->next, memory_order_acquire))
+  {
+    size_t pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+    for (; atomic_load_explicit(&seg->slots[pos & seg->mask].seq, memory_order_acquire) == pos + 1; pos++)
+    {
+      EventDescriptor *desc = &seg->slots[pos & seg->mask].desc;
+      if (desc->type.category == evt->type.category && desc->type.id == evt->type.id)
+        found = desc;
+    }
+  }
+  if (!found)
+    return 0;
+
+  // Замінена подія зберігає своє місце, клас пріоритету та момент постановки в чергу
+  Event *ext = (found->flags & DESC_EXT) ? (Event *)found->payload.data : NULL;
+  desc_decode(found, old);
+  Event merged = *old;
+  merged.input = evt->input;
+  merged.result = evt->result;
+  EventDescriptor desc;
+  if (!desc_encode(q, &merged, &desc, ext))
+    return -1;
+  if (ext && !(desc.flags & DESC_EXT))
+    eventbus_pool_release(&q->ext, ext);
+  *found = desc;
+  return 1;
+}
+
+bool eventbus_queue_empty(EventQueue *q)
+{
+  if (!q->budget)
+    return !segment_ready(&q->first);
+
+  uint32_t epoch = queue_enter(q);
+  EventQueueSegment *seg = atomic_load(&q->head_seg);
+  bool empty = !segment_ready(seg);
+  // Закритий і прочитаний сегмент споживач ще не покинув: дивимось у наступний
+  while (empty && segment_drained(seg))
+  {
+    seg = atomic_load_explicit(&seg->next, memory_order_acquire);
+    empty = !segment_ready(seg);
+  }
+  queue_leave(q, epoch);
+  return empty;
+}
+
+bool eventbus_queue_full(EventQueue *q)
+{
+  if (!q->budget)
+    return segment_full(&q->first);
+
+  uint32_t epoch = queue_enter(q);
+  bool full = segment_full(atomic_load(&q->tail_seg)) && !budget_fits(q->budget, segment_bytes(q->first.mask + 1));
+  queue_leave(q, epoch);
+  return full;
+}
+
+bool eventbus_queue_fits(EventQueue *q, const Event *evt)
+{
+  if (!desc_plain(evt) && eventbus_pool_empty(&q->ext))
+    return false;
+  return !eventbus_queue_full(q);
+}
+
+size_t eventbus_queue_depth(EventQueue *q)
+{
+  if (!q->budget)
+    return segment_depth(&q->first);
+
+  size_t depth = 0;
+  uint32_t epoch = queue_enter(q);
+  for (EventQueueSegment *seg = atomic_load(&q->head_seg); seg; seg = atomic_load_explicit(&seg->next, memory_order_acquire))
+    depth += segment_depth(seg);
+  queue_leave(q, epoch);
+  return depth;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file eventbus_queue.h
+ * @brief Внутрішній інтерфейс lock-free черги подій EventBus.
+ *
+ * Черга реалізує обмежений кільцевий буфер з номерами послідовності в кожному слоті:
+ * будь-яка кількість потоків може одночасно додавати події, забирає їх лише один споживач.
+ * Черга з обліком пам’яті не обмежена одним буфером: вона росте ланцюжком сегментів,
+ * поки дозволяє EventMemoryBudget.
+ *
+ * Слоти зберігають компактні дескриптори (EventDescriptor), а не цілі події: інтерфейс черги
+ * приймає та повертає Event, кодуючи його при записі та відновлюючи при читанні.
+ */
+
+#ifndef EVENTBUS_QUEUE_H
+#define EVENTBUS_QUEUE_H
+
+#include "eventbus.h"
+
+/**
+ * @brief Резервує пам’ять в обліку.
+ *
+ * @param budget Вказівник на облік пам’яті.
+ * @param size Розмір, байт.
+ * @return true, якщо резерв не перевищує межу.
+ */
+bool eventbus_budget_reserve(EventMemoryBudget *budget, size_t size);
+
+/**
+ * @brief Повертає раніше зарезервовану пам’ять в облік.
+ *
+ * @param budget Вказівник на облік пам’яті.
+ * @param size Розмір, байт.
+ */
+void eventbus_budget_release(EventMemoryBudget *budget, size_t size);
+
+/**
+ * @brief write_fn результату за замовчуванням (create_event_result), визначена в eventbus.c.
+ *
+ * Подія з таким результатом не потребує запису бічної таблиці черги.
+ */
+int eventbus_result_devnull(void *context, void *buffer, size_t size);
+
+/**
+ * @brief Ініціалізує чергу.
+ *
+ * @param q Вказівник на чергу.
+ * @param size Бажаний розмір (першого сегмента); округлюється вгору до степеня двійки.
+ * @param ext_count Кількість записів бічної таблиці; 0 – як розмір першого сегмента.
+ * @param budget Облік пам’яті черги, що росте; NULL – черга фіксованого розміру.
+ * @param arena Пам’ять для першого сегмента та бічної таблиці; NULL – купа.
+ *              Наступні сегменти черги, що росте, завжди виділяються з купи.
+ * @return 0 при успіху, -1 при помилці виділення пам’яті або перевищенні межі.
+ */
+int eventbus_queue_init(EventQueue *q, size_t size, size_t ext_count, EventMemoryBudget *budget, EventArena *arena);
+
+/**
+ * @brief Звільняє пам’ять черги. Дані подій, що залишились у черзі, не звільняються.
+ *
+ * Безпечно для черги, яка не була ініціалізована (обнуленої пам’яті).
+ *
+ * @param q Вказівник на чергу.
+ */
+void eventbus_queue_free(EventQueue *q);
+
+// Чому eventbus_queue_push не додав подію: слоти та записи бічної таблиці закінчуються незалежно
+#define EVENTBUS_QUEUE_FULL (-1)   /**< Немає вільної позиції */
+#define EVENTBUS_QUEUE_NO_EXT (-2) /**< Подія потребує запису бічної таблиці, а вільних записів немає */
+
+/**
+ * @brief Додає подію до черги. Безпечно для виклику з багатьох потоків.
+ *
+ * @param q Вказівник на чергу.
+ * @param evt Вказівник на подію.
+ * @return 0 при успіху, EVENTBUS_QUEUE_FULL якщо черга переповнена (а черга, що росте, – якщо новий
+ *         сегмент не вміщується в межу), EVENTBUS_QUEUE_NO_EXT якщо закінчились записи бічної таблиці.
+ */
+int eventbus_queue_push(EventQueue *q, const Event *evt);
+
+/**
+ * @brief Додає до черги кілька подій одним атомарним резервуванням позицій.
+ *
+ * Резервується стільки позицій, скільки вміщується (але не більше n), події записуються
+ * в порядку масиву; додавання зупиняється також на першій події, для якої не вистачило запису
+ * бічної таблиці. Безпечно для виклику з багатьох потоків.
+ *
+ * @param q Вказівник на чергу.
+ * @param evts Масив подій.
+ * @param n Кількість подій.
+ * @return Кількість доданих подій (перші елементи масиву), 0 якщо черга переповнена.
+ */
+size_t eventbus_queue_push_batch(EventQueue *q, const Event *evts, size_t n);
+
+/**
+ * @brief Забирає подію з черги. Викликається лише споживачем.
+ *
+ * @param q Вказівник на чергу.
+ * @param evt Вказівник, куди буде скопійована подія.
+ * @return 0 при успіху, -1 якщо черга порожня.
+ */
+int eventbus_queue_pop(EventQueue *q, Event *evt);
+
+/**
+ * @brief Рахує готові до читання події на початку черги. Викликається лише споживачем.
+ *
+ * Готові події можна прочитати через eventbus_queue_peek, після чого звільнити
+ * їх слоти одним викликом eventbus_queue_consume. Рахуються лише події поточного сегмента.
+ *
+ * @param q Вказівник на чергу.
+ * @param max Максимальна кількість подій.
+ * @return Кількість готових подій, не більше max.
+ */
+size_t eventbus_queue_ready(EventQueue *q, size_t max);
+
+/**
+ * @brief Відновлює i-ту готову подію від початку черги. Викликається лише споживачем.
+ *
+ * Слот залишається зайнятим до eventbus_queue_consume.
+ *
+ * @param q Вказівник на чергу.
+ * @param i Номер події, менший за результат eventbus_queue_ready.
+ * @param evt Вказівник, куди буде скопійована подія.
+ */
+void eventbus_queue_peek(EventQueue *q, size_t i, Event *evt);
+
+/**
+ * @brief Звільняє слоти перших n готових подій. Викликається лише споживачем.
+ *
+ * @param q Вказівник на чергу.
+ * @param n Кількість подій, не більша за результат eventbus_queue_ready.
+ */
+void eventbus_queue_consume(EventQueue *q, size_t n);
+
+/**
+ * @brief Замінює вхідні дані та результат найновішої готової до читання події типу evt->type.
+ *
+ * Викликається лише споживачем (або потоком, що захопив шард). Замінена подія залишається
+ * на своєму місці в черзі й зберігає клас пріоритету.
+ *
+ * @param q Вказівник на чергу.
+ * @param evt Подія з новими даними.
+ * @param old Вказівник, куди буде скопійована замінена подія; її дані звільняє викликач.
+ * @return 1, якщо подію замінено; 0, якщо такої події немає; -1, якщо нова подія потребує
+ *         запису бічної таблиці, а вільних записів немає.
+ */
+int eventbus_queue_replace_newest(EventQueue *q, const Event *evt, Event *old);
+
+/**
+ * @brief Перевіряє, чи є в черзі готова до читання подія. Безпечно для виклику з будь-якого потоку.
+ *
+ * @param q Вказівник на чергу.
+ * @return true, якщо черга порожня.
+ */
+bool eventbus_queue_empty(EventQueue *q);
+
+/**
+ * @brief Перевіряє, чи зайнятий слот наступної позиції запису. Безпечно для виклику з будь-якого потоку.
+ *
+ * Черга, що росте, переповнена, лише коли заповнений її останній сегмент, а новий не вміщується в межу пам’яті.
+ * Записи бічної таблиці не враховуються (див. eventbus_queue_fits).
+ *
+ * @param q Вказівник на чергу.
+ * @return true, якщо черга переповнена.
+ */
+bool eventbus_queue_full(EventQueue *q);
+
+/**
+ * @brief Перевіряє, чи вистачає черзі ресурсів саме для цієї події. Безпечно для виклику з будь-якого потоку.
+ *
+ * Подія, що описується самим дескриптором, потребує лише вільної позиції, інша – ще й запису бічної таблиці.
+ *
+ * @param q Вказівник на чергу.
+ * @param evt Вказівник на подію.
+ * @return true, якщо eventbus_queue_push зараз не відмовив би через брак місця.
+ */
+bool eventbus_queue_fits(EventQueue *q, const Event *evt);
+
+/**
+ * @brief Повертає кількість зайнятих позицій черги (в тому числі тих, що ще записуються).
+ *
+ * Значення наближене, якщо черга змінюється одночасно з викликом.
+ *
+ * @param q Вказівник на чергу.
+ * @return Кількість подій у черзі.
+ */
+size_t eventbus_queue_depth(EventQueue *q);
+
+#endif
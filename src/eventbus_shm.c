@@ -0,0 +1,596 @@
+/**
+ * @file eventbus_shm.c
+ * @brief Транспорт подій між процесами через спільну пам’ять.
+ *
+ * Продюсер під м’ютексом сегмента резервує номер події та місце в кільці даних, уже без м’ютекса
+ * копіює дані й публікує дескриптор, записуючи в нього номер події. Кожен процес‑читач має
+ * в заголовку свій курсор – найстаршу подію, дані якої ще використовуються в його EventBus;
+ * продюсер не перезаписує дескрипторів і даних, яких не звільнив найповільніший читач.
+ * Очікування даних і місця – futex на словах у сегменті, тож сплячий процес будить той,
+ * хто змінив слово, без жодного системного виклику, поки ніхто не спить.
+ *
+ * Реалізація є лише для Linux; на інших платформах eventbus_shm_open повертає NULL.
+ */
+
+#include "eventbus_shm.h"
+
+#if defined(__linux__) && !defined(CONFIG_IDF_TARGET)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#define EVENTBUS_SHM_MAGIC 0x48534245u // "EBSH"
+#define EVENTBUS_SHM_VERSION 1u
+#define EVENTBUS_SHM_FREE UINT64_MAX
+
+#ifndef EVENTBUS_SHM_READERS
+// Скільки процесів можуть одночасно читати сегмент.
+#define EVENTBUS_SHM_READERS 16
+#endif
+
+#ifndef EVENTBUS_SHM_OPEN_MS
+// Скільки процес, що під’єднується, чекає, поки інший процес закінчить створення сегмента.
+#define EVENTBUS_SHM_OPEN_MS 1000
+#endif
+
+// Дані кожної події починаються з вирівняної позиції.
+#define EVENTBUS_SHM_ALIGN 8u
+
+/**
+ * @brief Дескриптор події в сегменті.
+ */
+typedef struct
+{
+  EVENTBUS_ATOMIC(uint64_t) seq; /**< Номер події + 1, коли дескриптор опубліковано */
+  uint64_t offset;               /**< Позиція даних у кільці даних; зростає монотонно, зсув – offset % payload_size */
+  uint32_t size;                 /**< Розмір даних */
+  EventType type;                /**< Тип події */
+  uint8_t priority;              /**< Клас пріоритету події */
+  uint8_t reserved;
+} EventShmDescriptor;
+
+/**
+ * @brief Процес‑читач сегмента.
+ */
+typedef struct
+{
+  EVENTBUS_ATOMIC(uint64_t) cursor; /**< Найстаріша подія, дані якої читач ще використовує; EVENTBUS_SHM_FREE – запис вільний */
+  EVENTBUS_ATOMIC(int32_t) pid;     /**< Процес читача */
+} EventShmReader;
+
+/**
+ * @brief Заголовок сегмента.
+ *
+ * Слова futex, які змінюють продюсери та читачі, рознесені по різних кеш-лініях.
+ */
+typedef struct
+{
+  EVENTBUS_ATOMIC(uint32_t) magic; /**< EVENTBUS_SHM_MAGIC; записується останнім, коли сегмент створено */
+  uint32_t version;                /**< EVENTBUS_SHM_VERSION */
+  uint32_t slot_count;             /**< Кількість дескрипторів, степінь двійки */
+  uint64_t payload_size;           /**< Розмір кільця даних */
+  pthread_mutex_t mutex;           /**< Резервування місця продюсерами та реєстрація читачів */
+  uint64_t head;                   /**< Наступний номер події; під mutex */
+  uint64_t payload_head;           /**< Наступна позиція в кільці даних; під mutex */
+  uint8_t pad1[EVENTBUS_CACHE_LINE];
+  EVENTBUS_ATOMIC(uint32_t) data_seq;     /**< Слово futex: змінюється з кожною опублікованою подією */
+  EVENTBUS_ATOMIC(uint32_t) data_waiters; /**< Кількість читачів, що сплять на data_seq */
+  uint8_t pad2[EVENTBUS_CACHE_LINE];
+  EVENTBUS_ATOMIC(uint32_t) space_seq;     /**< Слово futex: змінюється, коли читач звільняє місце */
+  EVENTBUS_ATOMIC(uint32_t) space_waiters; /**< Кількість продюсерів, що сплять на space_seq */
+  EventShmReader readers[EVENTBUS_SHM_READERS];
+} EventShmHeader;
+
+/**
+ * @brief Подія, яку читач передав у EventBus.
+ */
+typedef struct
+{
+  struct EventShm *shm;          /**< Сегмент, якому належать дані */
+  EVENTBUS_ATOMIC(bool) released; /**< Дані події звільнено */
+} EventShmInflight;
+
+struct EventShm
+{
+  EventShmHeader *header;       /**< Відображений сегмент */
+  EventShmDescriptor *slots;    /**< Кільце дескрипторів */
+  uint8_t *payload;             /**< Кільце даних */
+  size_t map_size;              /**< Розмір відображення */
+  uint64_t mask;                /**< slot_count - 1 */
+  EventBus *bus;                /**< EventBus, у який читач публікує події; NULL – не читач */
+  int reader;                   /**< Запис читача в заголовку */
+  eventbus_thread_t thread;     /**< Потік читача */
+  EVENTBUS_ATOMIC(bool) running; /**< Потік читача працює */
+  uint64_t next;                /**< Наступна подія для читання; лише потік читача */
+  uint64_t released;            /**< Найстаріша не звільнена подія; під release_mutex */
+  EventShmInflight *inflight;   /**< Події, передані в EventBus, за номером & mask */
+  eventbus_mutex_t release_mutex;
+  eventbus_cond_t release_cond; /**< Сигналізується eventbus_shm_close, коли звільнено всі події */
+  bool closing;                 /**< eventbus_shm_close чекає на звільнення подій; під release_mutex */
+};
+
+// ==================== Futex ====================
+
+/**
+ * @brief Засинає, поки слово дорівнює value, не довше timeout_ms (EVENTBUS_WAIT_FOREVER – без обмеження).
+ */
+static void shm_futex_wait(EVENTBUS_ATOMIC(uint32_t) *word, uint32_t value, uint32_t timeout_ms)
+{
+  struct timespec ts = {timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L};
+  // Сегмент спільний між процесами, тож без FUTEX_PRIVATE_FLAG
+  syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, value, timeout_ms == EVENTBUS_WAIT_FOREVER ? NULL : &ts, NULL, 0);
+}
+
+/**
+ * @brief Змінює слово і будить усіх, хто на ньому спить.
+ *
+ * Пара до shm_futex_wait за схемою Деккера: очікувач збільшує waiters, ставить бар’єр і ще раз
+ * перевіряє умову, а той, хто її змінив, збільшує слово, ставить бар’єр і читає waiters.
+ */
+static void shm_futex_wake(EVENTBUS_ATOMIC(uint32_t) *word, EVENTBUS_ATOMIC(uint32_t) *waiters)
+{
+  atomic_fetch_add_explicit(word, 1, memory_order_release);
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(waiters, memory_order_relaxed) != 0)
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+// ==================== Сегмент ====================
+
+/**
+ * @brief Бере м’ютекс сегмента, відновлюючи його, якщо власник завершився, не відпустивши м’ютекс.
+ *
+ * Під м’ютексом стан змінюється лише після всіх перевірок, тож залишений стан узгоджений.
+ */
+static void shm_lock(EventShmHeader *header)
+{
+  if (pthread_mutex_lock(&header->mutex) == EOWNERDEAD)
+    pthread_mutex_consistent(&header->mutex);
+}
+
+static size_t shm_header_size(void)
+{
+  return (sizeof(EventShmHeader) + EVENTBUS_CACHE_LINE - 1) & ~(size_t)(EVENTBUS_CACHE_LINE - 1);
+}
+
+static size_t shm_map_size(uint32_t slot_count, uint64_t payload_size)
+{
+  size_t slots = ((size_t)slot_count * sizeof(EventShmDescriptor) + EVENTBUS_CACHE_LINE - 1) &
+                 ~(size_t)(EVENTBUS_CACHE_LINE - 1);
+  return shm_header_size() + slots + (size_t)payload_size;
+}
+
+/**
+ * @brief Заповнює заголовок і дескриптори нового сегмента.
+ */
+static int shm_format(EventShmHeader *header, uint32_t slot_count, uint64_t payload_size)
+{
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+  int rc = pthread_mutex_init(&header->mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+  if (rc != 0)
+    return -1;
+
+  header->version = EVENTBUS_SHM_VERSION;
+  header->slot_count = slot_count;
+  header->payload_size = payload_size;
+  header->head = 0;
+  header->payload_head = 0;
+  for (int i = 0; i < EVENTBUS_SHM_READERS; i++)
+    atomic_store_explicit(&header->readers[i].cursor, EVENTBUS_SHM_FREE, memory_order_relaxed);
+  // Дескриптор i вільний для події i: його seq не дорівнює i + 1
+  EventShmDescriptor *slots = (EventShmDescriptor *)((uint8_t *)header + shm_header_size());
+  for (uint32_t i = 0; i < slot_count; i++)
+    atomic_store_explicit(&slots[i].seq, 0, memory_order_relaxed);
+  atomic_store_explicit(&header->magic, EVENTBUS_SHM_MAGIC, memory_order_release);
+  return 0;
+}
+
+/**
+ * @brief Чекає, поки процес, що створює сегмент, задасть його розмір і заповнить заголовок.
+ *
+ * @return Розмір сегмента або 0 після таймауту.
+ */
+static size_t shm_wait_created(int fd)
+{
+  uint64_t deadline = EVENTBUS_TIME_MS() + EVENTBUS_SHM_OPEN_MS;
+  struct stat st;
+  for (;;)
+  {
+    if (fstat(fd, &st) != 0)
+      return 0;
+    if (st.st_size >= (off_t)sizeof(EventShmHeader))
+      return (size_t)st.st_size;
+    if (EVENTBUS_TIME_MS() >= deadline)
+      return 0;
+    TASK_DELAY(1);
+  }
+}
+
+EventShm *eventbus_shm_open(const char *name, uint32_t slot_count, size_t payload_size)
+{
+  uint32_t slots = 1;
+  while (slots < slot_count)
+    slots <<= 1;
+  payload_size = (payload_size + EVENTBUS_SHM_ALIGN - 1) & ~(size_t)(EVENTBUS_SHM_ALIGN - 1);
+
+  bool created = true;
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0 && errno == EEXIST)
+  {
+    created = false;
+    fd = shm_open(name, O_RDWR, 0);
+  }
+  if (fd < 0)
+    return NULL;
+
+  size_t map_size;
+  if (created)
+  {
+    map_size = shm_map_size(slots, payload_size);
+    if (payload_size == 0 || ftruncate(fd, (off_t)map_size) != 0)
+      goto fail_created;
+  }
+  else if ((map_size = shm_wait_created(fd)) == 0)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  EventShmHeader *header = (EventShmHeader *)mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (header == MAP_FAILED)
+  {
+    if (created)
+      goto fail_created;
+    close(fd);
+    return NULL;
+  }
+  close(fd);
+
+  if (created)
+  {
+    if (shm_format(header, slots, payload_size) != 0)
+    {
+      munmap(header, map_size);
+      shm_unlink(name);
+      return NULL;
+    }
+  }
+  else
+  {
+    uint64_t deadline = EVENTBUS_TIME_MS() + EVENTBUS_SHM_OPEN_MS;
+    while (atomic_load_explicit(&header->magic, memory_order_acquire) != EVENTBUS_SHM_MAGIC)
+    {
+      if (EVENTBUS_TIME_MS() >= deadline)
+        break;
+      TASK_DELAY(1);
+    }
+    // Розміри задає той, хто створив сегмент
+    if (atomic_load_explicit(&header->magic, memory_order_acquire) != EVENTBUS_SHM_MAGIC ||
+        header->version != EVENTBUS_SHM_VERSION ||
+        shm_map_size(header->slot_count, header->payload_size) != map_size)
+    {
+      munmap(header, map_size);
+      return NULL;
+    }
+  }
+
+  EventShm *shm = (EventShm *)calloc(1, sizeof(EventShm));
+  if (!shm)
+  {
+    munmap(header, map_size);
+    return NULL;
+  }
+  shm->header = header;
+  shm->slots = (EventShmDescriptor *)((uint8_t *)header + shm_header_size());
+  shm->payload = (uint8_t *)header + map_size - header->payload_size;
+  shm->map_size = map_size;
+  shm->mask = header->slot_count - 1;
+  shm->reader = -1;
+  return shm;
+
+fail_created:
+  close(fd);
+  shm_unlink(name);
+  return NULL;
+}
+
+int eventbus_shm_unlink(const char *name)
+{
+  return shm_unlink(name) == 0 ? 0 : -1;
+}
+
+// ==================== Публікація ====================
+
+/**
+ * @brief Найстаріша подія, яку ще використовує хоч один читач; head, якщо читачів немає.
+ *
+ * Викликається під м’ютексом сегмента. Записи читачів, чиї процеси завершились без
+ * eventbus_shm_close, звільняються, щоб вони не тримали місце в кільці назавжди.
+ */
+static uint64_t shm_min_cursor(EventShmHeader *header, bool reap)
+{
+  uint64_t min = header->head;
+  for (int i = 0; i < EVENTBUS_SHM_READERS; i++)
+  {
+    EventShmReader *reader = &header->readers[i];
+    uint64_t cursor = atomic_load_explicit(&reader->cursor, memory_order_acquire);
+    if (cursor == EVENTBUS_SHM_FREE)
+      continue;
+    if (reap && kill(atomic_load_explicit(&reader->pid, memory_order_relaxed), 0) != 0 && errno == ESRCH)
+    {
+      atomic_store_explicit(&reader->cursor, EVENTBUS_SHM_FREE, memory_order_relaxed);
+      continue;
+    }
+    if (cursor < min)
+      min = cursor;
+  }
+  return min;
+}
+
+/**
+ * @brief Резервує дескриптор і місце для size байтів даних.
+ *
+ * @param[out] seq Номер події.
+ * @param[out] offset Позиція даних.
+ * @return true, якщо місце зарезервовано; false, якщо кільце заповнене.
+ */
+static bool shm_reserve(EventShm *shm, uint32_t size, bool reap, uint64_t *seq, uint64_t *offset)
+{
+  EventShmHeader *header = shm->header;
+  uint64_t capacity = header->payload_size;
+  uint64_t pos = header->payload_head;
+  // Дані не розриваються на кінці кільця: решта до кінця пропускається
+  if (pos % capacity + size > capacity)
+    pos += capacity - pos % capacity;
+
+  uint64_t min = shm_min_cursor(header, reap);
+  uint64_t tail = min < header->head ? shm->slots[min & shm->mask].offset : pos;
+  if (header->head - min > shm->mask || pos + size - tail > capacity)
+    return false;
+
+  *seq = header->head;
+  *offset = pos;
+  header->head++;
+  header->payload_head = (pos + size + EVENTBUS_SHM_ALIGN - 1) & ~(uint64_t)(EVENTBUS_SHM_ALIGN - 1);
+  return true;
+}
+
+int eventbus_shm_publish(EventShm *shm, EventType type, EventPriority priority, const void *data, size_t size, uint32_t timeout_ms)
+{
+  EventShmHeader *header = shm->header;
+  if (type.category == 0 || type.id == 0 || size > header->payload_size)
+    return -1;
+
+  uint64_t deadline = UINT64_MAX;
+  if (timeout_ms != EVENTBUS_WAIT_FOREVER)
+    deadline = EVENTBUS_TIME_MS() + timeout_ms;
+  uint64_t seq, offset;
+  bool reap = false;
+  for (;;)
+  {
+    uint32_t space = atomic_load_explicit(&header->space_seq, memory_order_acquire);
+    shm_lock(header);
+    bool reserved = shm_reserve(shm, (uint32_t)size, reap, &seq, &offset);
+    if (reserved)
+    {
+      EventShmDescriptor *slot = &shm->slots[seq & shm->mask];
+      slot->offset = offset;
+      slot->size = (uint32_t)size;
+      slot->type = type;
+      slot->priority = priority;
+    }
+    pthread_mutex_unlock(&header->mutex);
+    if (reserved)
+      break;
+
+    uint64_t now = EVENTBUS_TIME_MS();
+    if (now >= deadline)
+      return -1;
+    // Наступна спроба перевіряє, чи не завершився процес повільного читача
+    reap = true;
+    atomic_fetch_add_explicit(&header->space_waiters, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&header->space_seq, memory_order_relaxed) == space)
+      shm_futex_wait(&header->space_seq, space, deadline == UINT64_MAX ? EVENTBUS_WAIT_FOREVER : (uint32_t)(deadline - now));
+    atomic_fetch_sub_explicit(&header->space_waiters, 1, memory_order_relaxed);
+  }
+
+  if (size)
+    memcpy(shm->payload + offset % header->payload_size, data, size);
+  atomic_store_explicit(&shm->slots[seq & shm->mask].seq, seq + 1, memory_order_release);
+  shm_futex_wake(&header->data_seq, &header->data_waiters);
+  return 0;
+}
+
+// ==================== Читач ====================
+
+/**
+ * @brief Просуває курсор читача через звільнені події і будить продюсерів, що чекають на місце.
+ */
+static void shm_advance(EventShm *shm)
+{
+  bool moved = false;
+  EVENTBUS_MUTEX_LOCK(&shm->release_mutex);
+  EventShmInflight *item;
+  while (shm->released != shm->next &&
+         atomic_load_explicit(&(item = &shm->inflight[shm->released & shm->mask])->released, memory_order_acquire))
+  {
+    atomic_store_explicit(&item->released, false, memory_order_relaxed);
+    shm->released++;
+    moved = true;
+  }
+  if (moved)
+  {
+    atomic_store_explicit(&shm->header->readers[shm->reader].cursor, shm->released, memory_order_release);
+    // Ще під м’ютексом: після останнього звільнення eventbus_shm_close може одразу звільнити shm
+    shm_futex_wake(&shm->header->space_seq, &shm->header->space_waiters);
+    if (shm->closing && shm->released == shm->next)
+      EVENTBUS_COND_SIGNAL(&shm->release_cond);
+  }
+  EVENTBUS_MUTEX_UNLOCK(&shm->release_mutex);
+}
+
+void eventbus_shm_input_release(EventInputData *input)
+{
+  EventShmInflight *item = (EventShmInflight *)input->context;
+  // Сегмент читається до позначки: позначену подію інший потік може звільнити разом з масивом inflight
+  EventShm *shm = item->shm;
+  atomic_store_explicit(&item->released, true, memory_order_release);
+  input->direct_data = NULL;
+  input->data_size = 0;
+  shm_advance(shm);
+}
+
+/**
+ * @brief Потік читача: передає події сегмента в EventBus у порядку публікації.
+ *
+ * Дані не копіюються: direct_data події вказує в кільце даних, а місце повертається
+ * продюсерам, коли EventBus звільнить дані (event_data_shm).
+ */
+static THREAD_RETURN_TYPE shm_reader_func(THREAD_ARG_TYPE arg)
+{
+  EventShm *shm = (EventShm *)arg;
+  EventShmHeader *header = shm->header;
+  while (atomic_load_explicit(&shm->running, memory_order_acquire))
+  {
+    EventShmDescriptor *slot = &shm->slots[shm->next & shm->mask];
+    uint32_t data = atomic_load_explicit(&header->data_seq, memory_order_acquire);
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != shm->next + 1)
+    {
+      atomic_fetch_add_explicit(&header->data_waiters, 1, memory_order_relaxed);
+      atomic_thread_fence(memory_order_seq_cst);
+      if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != shm->next + 1 &&
+          atomic_load_explicit(&shm->running, memory_order_relaxed))
+        shm_futex_wait(&header->data_seq, data, EVENTBUS_WAIT_FOREVER);
+      atomic_fetch_sub_explicit(&header->data_waiters, 1, memory_order_relaxed);
+      continue;
+    }
+
+    EventShmInflight *item = &shm->inflight[shm->next & shm->mask];
+    EventInputData input = create_event_input_data(shm->payload + slot->offset % header->payload_size, slot->size);
+    input.context = item;
+    input.storage = event_data_shm;
+    EventType type = slot->type;
+    EventPriority priority = (EventPriority)slot->priority;
+    EVENTBUS_MUTEX_LOCK(&shm->release_mutex);
+    shm->next++;
+    EVENTBUS_MUTEX_UNLOCK(&shm->release_mutex);
+    if (eventbus_publish_priority(shm->bus, type, priority, input, create_event_result()) != 0)
+      eventbus_shm_input_release(&input);
+  }
+  return THREAD_RETURN;
+}
+
+int eventbus_shm_subscribe(EventShm *shm, EventBus *bus)
+{
+  if (shm->bus)
+    return -1;
+  shm->inflight = (EventShmInflight *)calloc(shm->mask + 1, sizeof(EventShmInflight));
+  if (!shm->inflight)
+    return -1;
+  for (uint64_t i = 0; i <= shm->mask; i++)
+    shm->inflight[i].shm = shm;
+
+  // Читач отримує події, опубліковані після реєстрації
+  EventShmHeader *header = shm->header;
+  shm_lock(header);
+  for (int i = 0; i < EVENTBUS_SHM_READERS && shm->reader < 0; i++)
+  {
+    if (atomic_load_explicit(&header->readers[i].cursor, memory_order_relaxed) != EVENTBUS_SHM_FREE)
+      continue;
+    atomic_store_explicit(&header->readers[i].pid, (int32_t)getpid(), memory_order_relaxed);
+    atomic_store_explicit(&header->readers[i].cursor, header->head, memory_order_release);
+    shm->reader = i;
+    shm->next = header->head;
+    shm->released = header->head;
+  }
+  pthread_mutex_unlock(&header->mutex);
+  if (shm->reader < 0)
+    goto fail;
+
+  EVENTBUS_MUTEX_INIT(&shm->release_mutex);
+  EVENTBUS_COND_INIT(&shm->release_cond);
+  shm->bus = bus;
+  atomic_store_explicit(&shm->running, true, memory_order_relaxed);
+  if (pthread_create(&shm->thread, NULL, shm_reader_func, shm) != 0)
+  {
+    EVENTBUS_COND_DESTROY(&shm->release_cond);
+    EVENTBUS_MUTEX_DESTROY(&shm->release_mutex);
+    shm->bus = NULL;
+    atomic_store_explicit(&header->readers[shm->reader].cursor, EVENTBUS_SHM_FREE, memory_order_release);
+    shm->reader = -1;
+    goto fail;
+  }
+  return 0;
+
+fail:
+  free(shm->inflight);
+  shm->inflight = NULL;
+  return -1;
+}
+
+void eventbus_shm_close(EventShm *shm)
+{
+  if (shm->bus)
+  {
+    atomic_store_explicit(&shm->running, false, memory_order_release);
+    shm_futex_wake(&shm->header->data_seq, &shm->header->data_waiters);
+    pthread_join(shm->thread, NULL);
+
+    // Дані подій, які ще в EventBus, лежать у сегменті: чекаємо, поки їх оброблять або викинуть
+    EVENTBUS_MUTEX_LOCK(&shm->release_mutex);
+    shm->closing = true;
+    while (shm->released != shm->next)
+      EVENTBUS_COND_WAIT(&shm->release_cond, &shm->release_mutex);
+    EVENTBUS_MUTEX_UNLOCK(&shm->release_mutex);
+
+    atomic_store_explicit(&shm->header->readers[shm->reader].cursor, EVENTBUS_SHM_FREE, memory_order_release);
+    shm_futex_wake(&shm->header->space_seq, &shm->header->space_waiters);
+    EVENTBUS_COND_DESTROY(&shm->release_cond);
+    EVENTBUS_MUTEX_DESTROY(&shm->release_mutex);
+    free(shm->inflight);
+  }
+  munmap(shm->header, shm->map_size);
+  free(shm);
+}
+
+#else
+
+EventShm *eventbus_shm_open(const char *name, uint32_t slot_count, size_t payload_size)
+{
+  return NULL;
+}
+
+int eventbus_shm_unlink(const char *name)
+{
+  return -1;
+}
+
+int eventbus_shm_publish(EventShm *shm, EventType type, EventPriority priority, const void *data, size_t size, uint32_t timeout_ms)
+{
+  return -1;
+}
+
+int eventbus_shm_subscribe(EventShm *shm, EventBus *bus)
+{
+  return -1;
+}
+
+void eventbus_shm_close(EventShm *shm)
+{
+}
+
+void eventbus_shm_input_release(EventInputData *input)
+{
+}
+
+#endif
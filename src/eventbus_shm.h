@@ -0,0 +1,25 @@
+/**
+ * @file eventbus_shm.h
+ * @brief Внутрішній інтерфейс транспорту подій через спільну пам’ять.
+ *
+ * Сегмент спільної пам’яті складається із заголовка, кільця дескрипторів фіксованого розміру
+ * та кільця даних. Дескриптор не містить вказівників: дані події задаються зсувом в області даних,
+ * тож сегмент однаково читається з будь-якого процесу, незалежно від адреси відображення.
+ */
+
+#ifndef EVENTBUS_SHM_H
+#define EVENTBUS_SHM_H
+
+#include "eventbus.h"
+
+/**
+ * @brief Повертає дані події з event_data_shm у сегмент.
+ *
+ * Дані звільняються не обов’язково в порядку публікації: місце в кільці повертається продюсерам,
+ * коли звільнено всі старіші події.
+ *
+ * @param input Вхідні дані події.
+ */
+void eventbus_shm_input_release(EventInputData *input);
+
+#endif
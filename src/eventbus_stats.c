@@ -0,0 +1,155 @@
+/**
+ * @file eventbus_stats.c
+ * @brief Реалізація статистики EventBus.
+ */
+
+#include "eventbus_stats.h"
+
+#if defined(EVENTBUS_STATS)
+
+// Кожен степінь двійки ділиться на 1 << EVENTBUS_HIST_SUB_BITS кошиків
+#define EVENTBUS_HIST_SUB_BITS 2
+#define EVENTBUS_HIST_SUB (1u << EVENTBUS_HIST_SUB_BITS)
+
+static unsigned hist_msb(uint64_t v)
+{
+#if defined(__GNUC__)
+  return 63u - (unsigned)__builtin_clzll(v);
+#else
+  unsigned msb = 0;
+  while (v >>= 1)
+    msb++;
+  return msb;
+#endif
+}
+
+/**
+ * @brief Номер кошика для значення.
+ *
+ * Значення менші за 2 * EVENTBUS_HIST_SUB мають власні кошики, далі кожен степінь двійки
+ * займає EVENTBUS_HIST_SUB кошиків, номер всередині – наступні біти після старшого.
+ */
+static unsigned hist_bucket(uint64_t v)
+{
+  if (v < 2 * EVENTBUS_HIST_SUB)
+    return (unsigned)v;
+  unsigned msb = hist_msb(v);
+  unsigned idx = (msb - EVENTBUS_HIST_SUB_BITS + 1) * EVENTBUS_HIST_SUB +
+                 (unsigned)((v >> (msb - EVENTBUS_HIST_SUB_BITS)) & (EVENTBUS_HIST_SUB - 1));
+  return idx < EVENTBUS_HIST_BUCKETS ? idx : EVENTBUS_HIST_BUCKETS - 1;
+}
+
+/**
+ * @brief Найбільше значення, що потрапляє в кошик.
+ */
+static uint64_t hist_bucket_upper(unsigned idx)
+{
+  if (idx < 2 * EVENTBUS_HIST_SUB)
+    return idx;
+  unsigned msb = idx / EVENTBUS_HIST_SUB + EVENTBUS_HIST_SUB_BITS - 1;
+  uint64_t lower = (uint64_t)(EVENTBUS_HIST_SUB + idx % EVENTBUS_HIST_SUB) << (msb - EVENTBUS_HIST_SUB_BITS);
+  return lower + ((uint64_t)1 << (msb - EVENTBUS_HIST_SUB_BITS)) - 1;
+}
+
+EventStatsState *eventbus_stats_create(void)
+{
+  return (EventStatsState *)calloc(1, sizeof(EventStatsState));
+}
+
+EventStatsHistogram *eventbus_stats_grow(EventStatsState *stats, uint16_t count)
+{
+  if (stats->sub_chunk_count == EVENTBUS_SUB_CHUNKS)
+    return NULL;
+  EventStatsHistogram *chunk = (EventStatsHistogram *)calloc(count ? count : 1, sizeof(EventStatsHistogram));
+  if (chunk)
+    stats->subs[stats->sub_chunk_count++] = chunk;
+  return chunk;
+}
+
+void eventbus_stats_destroy(EventStatsState *stats)
+{
+  if (!stats)
+    return;
+  for (uint8_t i = 0; i < stats->sub_chunk_count; i++)
+    free(stats->subs[i]);
+  free(stats);
+}
+
+void eventbus_stats_record(EventStatsHistogram *h, uint64_t ns)
+{
+  atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&h->total_ns, ns, memory_order_relaxed);
+  atomic_fetch_add_explicit(&h->buckets[hist_bucket(ns)], 1, memory_order_relaxed);
+  uint64_t max = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+  while (ns > max && !atomic_compare_exchange_weak_explicit(&h->max_ns, &max, ns,
+                                                            memory_order_relaxed, memory_order_relaxed))
+    ;
+}
+
+void eventbus_stats_reset(EventStatsHistogram *h)
+{
+  atomic_store_explicit(&h->count, 0, memory_order_relaxed);
+  atomic_store_explicit(&h->total_ns, 0, memory_order_relaxed);
+  atomic_store_explicit(&h->max_ns, 0, memory_order_relaxed);
+  for (size_t i = 0; i < EVENTBUS_HIST_BUCKETS; i++)
+    atomic_store_explicit(&h->buckets[i], 0, memory_order_relaxed);
+}
+
+EventStatsHistogram *eventbus_stats_type(EventStatsState *stats, EventType type)
+{
+  uint16_t key = (uint16_t)((type.category << 8) | type.id);
+  size_t start = (size_t)(key * 40503u) >> 10; // мультиплікативне хешування 16-бітного ключа
+  for (size_t i = 0; i < EVENTBUS_STATS_TYPES; i++)
+  {
+    EventStatsType *slot = &stats->types[(start + i) & (EVENTBUS_STATS_TYPES - 1)];
+    uint16_t current = atomic_load_explicit(&slot->key, memory_order_relaxed);
+    if (current == 0 && atomic_compare_exchange_strong_explicit(&slot->key, &current, key,
+                                                                memory_order_relaxed, memory_order_relaxed))
+      return &slot->callback;
+    if (current == key)
+      return &slot->callback;
+  }
+  return &stats->types[EVENTBUS_STATS_TYPES].callback;
+}
+
+void eventbus_stats_depth(EventStatsState *stats, uint32_t depth)
+{
+  uint32_t max = atomic_load_explicit(&stats->high_water, memory_order_relaxed);
+  while (depth > max && !atomic_compare_exchange_weak_explicit(&stats->high_water, &max, depth,
+                                                               memory_order_relaxed, memory_order_relaxed))
+    ;
+}
+
+void eventbus_stats_copy(EventBusHistogram *dst, EventStatsHistogram *src)
+{
+  dst->count = atomic_load_explicit(&src->count, memory_order_relaxed);
+  dst->total_ns = atomic_load_explicit(&src->total_ns, memory_order_relaxed);
+  dst->max_ns = atomic_load_explicit(&src->max_ns, memory_order_relaxed);
+  for (size_t i = 0; i < EVENTBUS_HIST_BUCKETS; i++)
+    dst->buckets[i] = atomic_load_explicit(&src->buckets[i], memory_order_relaxed);
+}
+
+uint64_t eventbus_histogram_percentile(const EventBusHistogram *h, double percentile)
+{
+  uint64_t total = 0;
+  for (size_t i = 0; i < EVENTBUS_HIST_BUCKETS; i++)
+    total += h->buckets[i];
+  if (total == 0)
+    return 0;
+  uint64_t rank = (uint64_t)(percentile / 100.0 * (double)total + 0.5);
+  if (rank == 0)
+    rank = 1;
+  uint64_t seen = 0;
+  for (unsigned i = 0; i < EVENTBUS_HIST_BUCKETS; i++)
+  {
+    seen += h->buckets[i];
+    if (seen >= rank)
+    {
+      uint64_t upper = hist_bucket_upper(i);
+      return upper < h->max_ns ? upper : h->max_ns;
+    }
+  }
+  return h->max_ns;
+}
+
+#endif
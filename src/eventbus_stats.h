@@ -0,0 +1,117 @@
+/**
+ * @file eventbus_stats.h
+ * @brief Внутрішній інтерфейс статистики EventBus.
+ *
+ * Статистика збирається лише при зборці з EVENTBUS_STATS. Без нього EVENTBUS_STAT(...)
+ * розгортається в порожнечу, тож код публікації та обробки не містить жодних вимірів.
+ * Усі лічильники атомарні та оновлюються з memory_order_relaxed.
+ */
+
+#ifndef EVENTBUS_STATS_H
+#define EVENTBUS_STATS_H
+
+#include "eventbus.h"
+
+#if defined(EVENTBUS_STATS)
+
+#ifndef EVENTBUS_STATS_TYPES
+// Розмір таблиці статистики за типами подій (степінь двійки). Типи, яким не вистачило місця,
+// рахуються в одному спільному записі.
+#define EVENTBUS_STATS_TYPES 64
+#endif
+
+/**
+ * @brief Гістограма, яку можна оновлювати з багатьох потоків.
+ */
+typedef struct EventStatsHistogram
+{
+  EVENTBUS_ATOMIC(uint64_t) count;
+  EVENTBUS_ATOMIC(uint64_t) total_ns;
+  EVENTBUS_ATOMIC(uint64_t) max_ns;
+  EVENTBUS_ATOMIC(uint32_t) buckets[EVENTBUS_HIST_BUCKETS];
+} EventStatsHistogram;
+
+/**
+ * @brief Запис таблиці статистики за типами подій.
+ */
+typedef struct
+{
+  EVENTBUS_ATOMIC(uint16_t) key; /**< Ключ типу події: (category << 8) | id; 0 – вільний запис */
+  EventStatsHistogram callback;  /**< Тривалість обробки події всіма підписниками */
+} EventStatsType;
+
+/**
+ * @brief Стан статистики EventBus.
+ */
+typedef struct EventStatsState
+{
+  EVENTBUS_ATOMIC(uint64_t) published;
+  EVENTBUS_ATOMIC(uint64_t) rejected;
+  EVENTBUS_ATOMIC(uint64_t) evicted;
+  EVENTBUS_ATOMIC(uint64_t) coalesced;
+  EVENTBUS_ATOMIC(uint64_t) dispatched;
+  EVENTBUS_ATOMIC(uint32_t) high_water;
+  EventStatsHistogram queue_latency;
+  EventStatsType types[EVENTBUS_STATS_TYPES + 1]; /**< Відкрита адресація; останній запис – решта типів */
+  uint8_t sub_chunk_count;                        /**< Кількість блоків гістограм підписників */
+  EventStatsHistogram *subs[EVENTBUS_SUB_CHUNKS]; /**< Гістограми підписників, блоками як дескриптори */
+} EventStatsState;
+
+/**
+ * @brief Виділяє стан статистики.
+ *
+ * @return Вказівник на стан або NULL при помилці виділення пам’яті.
+ */
+EventStatsState *eventbus_stats_create(void);
+
+/**
+ * @brief Виділяє гістограми для нового блоку дескрипторів підписників.
+ *
+ * @param stats Вказівник на стан статистики.
+ * @param count Кількість дескрипторів у блоці.
+ * @return Масив гістограм або NULL при помилці виділення пам’яті.
+ */
+EventStatsHistogram *eventbus_stats_grow(EventStatsState *stats, uint16_t count);
+
+/**
+ * @brief Звільняє стан статистики.
+ */
+void eventbus_stats_destroy(EventStatsState *stats);
+
+/**
+ * @brief Додає вимір до гістограми.
+ */
+void eventbus_stats_record(EventStatsHistogram *h, uint64_t ns);
+
+/**
+ * @brief Обнуляє гістограму. Не атомарно відносно одночасних вимірів.
+ */
+void eventbus_stats_reset(EventStatsHistogram *h);
+
+/**
+ * @brief Повертає гістограму типу події, за потреби займаючи для нього запис таблиці.
+ */
+EventStatsHistogram *eventbus_stats_type(EventStatsState *stats, EventType type);
+
+/**
+ * @brief Оновлює найбільшу кількість подій у черзі.
+ */
+void eventbus_stats_depth(EventStatsState *stats, uint32_t depth);
+
+/**
+ * @brief Копіює гістограму в знімок.
+ */
+void eventbus_stats_copy(EventBusHistogram *dst, EventStatsHistogram *src);
+
+#define EVENTBUS_STAT(x) x
+#define EVENTBUS_STAT_ADD(stats, counter, n) \
+  atomic_fetch_add_explicit(&(stats)->counter, (n), memory_order_relaxed)
+
+#else
+
+#define EVENTBUS_STAT(x)
+#define EVENTBUS_STAT_ADD(stats, counter, n)
+
+#endif
+
+#endif
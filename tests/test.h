@@ -0,0 +1,54 @@
+/**
+ * @file test.h
+ * @brief Мінімальні засоби перевірок для тестів EventBus.
+ *
+ * Кожен тест – окремий виконуваний файл: CHECK рахує невиконані умови, RUN_TEST друкує
+ * результат сценарію, а main повертає test_result(), тож ctest бачить помилку за кодом виходу.
+ */
+
+#ifndef EVENTBUS_TEST_H
+#define EVENTBUS_TEST_H
+
+#include "eventbus.h"
+#include <sched.h>
+#include <stdio.h>
+
+// Скільки WAIT_UNTIL чекає на умову, мс
+#define TEST_TIMEOUT_MS 5000
+
+static int test_failures;
+
+#define CHECK(cond)                                                             \
+  do                                                                            \
+  {                                                                             \
+    if (!(cond))                                                                \
+    {                                                                           \
+      fprintf(stderr, "%s:%d: не виконано: %s\n", __FILE__, __LINE__, #cond);   \
+      test_failures++;                                                          \
+    }                                                                           \
+  } while (0)
+
+// Чекає, поки умова, яку змінює потік обробки, стане істинною; після таймауту – невиконана перевірка
+#define WAIT_UNTIL(cond)                                                \
+  do                                                                    \
+  {                                                                     \
+    uint64_t test_deadline = EVENTBUS_TIME_MS() + TEST_TIMEOUT_MS;      \
+    while (!(cond) && EVENTBUS_TIME_MS() < test_deadline)               \
+      sched_yield();                                                    \
+    CHECK(cond);                                                        \
+  } while (0)
+
+#define RUN_TEST(fn)                                                    \
+  do                                                                    \
+  {                                                                     \
+    int test_before = test_failures;                                    \
+    fn();                                                               \
+    printf("%s %s\n", test_failures == test_before ? "ok  " : "FAIL", #fn); \
+  } while (0)
+
+static inline int test_result(void)
+{
+  return test_failures == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * @file test_async.c
+ * @brief Тести асинхронних підписників: призупинення, відновлення з іншого потоку, потокові події
+ *        та скасування при зупинці.
+ *
+ * Підписник призупиняється один раз і записує свою задачу, а тест відновлює задачі з головного
+ * потоку, як це робив би callback завершення вводу-виводу.
+ */
+
+#include "test.h"
+
+#define TEST_TASKS 16
+#define TEST_CHUNK 16
+
+static EventAsyncTask *pending[TEST_TASKS];
+static EVENTBUS_ATOMIC(int) pending_count;
+static EVENTBUS_ATOMIC(int) finished;
+static EVENTBUS_ATOMIC(int) cancelled;
+static EVENTBUS_ATOMIC(int) sync_calls;
+static EVENTBUS_ATOMIC(size_t) bytes;
+
+static EventAsyncStatus await_once(Event *evt, EventAsyncTask *task, void *ctx)
+{
+  (void)ctx;
+  EVENTBUS_ASYNC_BEGIN(task);
+  {
+    int n = atomic_fetch_add(&pending_count, 1);
+    if (n < TEST_TASKS)
+      pending[n] = task;
+  }
+  EVENTBUS_ASYNC_AWAIT(task);
+  if (task->cancelled)
+  {
+    atomic_fetch_add(&cancelled, 1);
+    return event_async_done;
+  }
+  // Шматок потокової події утримується, доки задача не завершиться
+  if (evt->chunk)
+  {
+    for (size_t i = 0; i < evt->input.data_size; i++)
+      CHECK(((uint8_t *)evt->input.direct_data)[i] == (uint8_t)(evt->chunk->offset + i));
+    atomic_fetch_add(&bytes, evt->input.data_size);
+  }
+  atomic_fetch_add(&finished, 1);
+  EVENTBUS_ASYNC_END(task);
+}
+
+static void sync_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add(&sync_calls, 1);
+}
+
+static EventBus *bus_create(uint8_t stream_chunks)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.async_task_count = TEST_TASKS;
+  cfg.stream_chunk_size = TEST_CHUNK;
+  cfg.stream_chunk_count = stream_chunks;
+  EventBus *bus = eventbus_create(cfg);
+  CHECK(bus != NULL);
+  CHECK(eventbus_subscribe_async(bus, event_type(1, 1), 0, NULL, await_once) != NULL);
+  eventbus_subscribe(bus, event_type(1, 1), 1, NULL, sync_callback);
+  atomic_store(&pending_count, 0);
+  atomic_store(&finished, 0);
+  atomic_store(&cancelled, 0);
+  atomic_store(&sync_calls, 0);
+  atomic_store(&bytes, 0);
+  return bus;
+}
+
+// Відновлює задачі в порядку призупинення, доки expected з них не завершаться
+static void resume_until(EventBus *bus, int expected)
+{
+  int resumed = 0;
+  uint64_t deadline = EVENTBUS_TIME_MS() + TEST_TIMEOUT_MS;
+  while (atomic_load(&finished) < expected && EVENTBUS_TIME_MS() < deadline)
+  {
+    if (resumed < atomic_load(&pending_count) && resumed < TEST_TASKS)
+      eventbus_async_resume(bus, pending[resumed++]);
+    else
+      sched_yield();
+  }
+  CHECK(atomic_load(&finished) == expected);
+}
+
+static void test_resume(void)
+{
+  EventBus *bus = bus_create(0);
+  EventRequest *req = eventbus_request(bus, event_type(1, 1), create_event_input_str("async"), create_event_result());
+  CHECK(req != NULL);
+
+  // Призупинений підписник не затримує наступних, але подія ще не завершена
+  WAIT_UNTIL(atomic_load(&pending_count) == 1 && atomic_load(&sync_calls) == 1);
+  if (req)
+    CHECK(eventbus_request_wait(bus, req, 20) == event_request_pending);
+
+  resume_until(bus, 1);
+  if (req)
+  {
+    CHECK(eventbus_request_wait(bus, req, EVENTBUS_WAIT_FOREVER) == event_request_done);
+    eventbus_request_release(bus, req);
+  }
+  eventbus_stop(bus);
+  free(bus);
+}
+
+typedef struct
+{
+  size_t offset;
+  size_t size;
+} Source;
+
+static int source_read(void *context, void *buffer, size_t size)
+{
+  Source *src = (Source *)context;
+  size_t n = src->size - src->offset < size ? src->size - src->offset : size;
+  for (size_t i = 0; i < n; i++)
+    ((uint8_t *)buffer)[i] = (uint8_t)(src->offset + i);
+  src->offset += n;
+  return (int)n;
+}
+
+static void test_stream(void)
+{
+  // Кожна призупинена задача утримує свій шматок, тож пул на 2 шматки вичерпується одразу:
+  // обробник потоку має виконувати відновлені задачі, поки чекає на вільний шматок
+  EventBus *bus = bus_create(2);
+  static Source src;
+  src.offset = 0;
+  src.size = 5 * TEST_CHUNK + 3;
+  CHECK(eventbus_publish(bus, event_type(1, 1), create_event_input_stream(source_read, &src), create_event_result()) == 0);
+
+  // 6 шматків з даними та порожній останній
+  resume_until(bus, 7);
+  CHECK(atomic_load(&bytes) == src.size);
+  CHECK(src.offset == src.size);
+  WAIT_UNTIL(atomic_load(&sync_calls) == 7);
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static void test_cancel(void)
+{
+  EventBus *bus = bus_create(0);
+  EventRequest *req = eventbus_request(bus, event_type(1, 1), create_event_input_str("stop"), create_event_result());
+  CHECK(req != NULL);
+  WAIT_UNTIL(atomic_load(&pending_count) == 1);
+  if (req)
+    eventbus_request_release(bus, req);
+
+  // Зупинка востаннє викликає призупиненого підписника з task->cancelled
+  eventbus_stop(bus);
+  CHECK(atomic_load(&cancelled) == 1 && atomic_load(&finished) == 0);
+  free(bus);
+}
+
+int main(void)
+{
+  RUN_TEST(test_resume);
+  RUN_TEST(test_stream);
+  RUN_TEST(test_cancel);
+  return test_result();
+}
@@ -0,0 +1,102 @@
+/**
+ * @file test_conflate.c
+ * @brief Тести тем з останнім значенням (eventbus_conflate).
+ *
+ * Подія категорії 2 затримує єдиний потік обробки в підписнику, доки тест не відкриє його,
+ * тож значення теми тим часом накопичуються необробленими.
+ */
+
+#include "test.h"
+
+static EVENTBUS_ATOMIC(bool) gate_open;
+static EVENTBUS_ATOMIC(int) gate_entered;
+static EVENTBUS_ATOMIC(int) received;
+static EVENTBUS_ATOMIC(uint32_t) last_value;
+
+static void gate_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add(&gate_entered, 1);
+  while (!atomic_load(&gate_open))
+    sched_yield();
+}
+
+static void record_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  uint32_t value;
+  memcpy(&value, evt->input.direct_data, sizeof(value));
+  atomic_store(&last_value, value);
+  atomic_fetch_add(&received, 1);
+}
+
+static void gate_close(EventBus *bus)
+{
+  atomic_store(&gate_open, false);
+  atomic_store(&gate_entered, 0);
+  CHECK(eventbus_publish(bus, event_type(2, 1), create_event_input_data(NULL, 0), create_event_result()) == 0);
+  WAIT_UNTIL(atomic_load(&gate_entered) == 1);
+}
+
+static EventInputData value_input(uint32_t value)
+{
+  return create_event_input_copy(&value, sizeof(value));
+}
+
+static void test_latest(void)
+{
+  EventBus *bus = eventbus_create(eventbus_default_config());
+  CHECK(bus != NULL);
+  CHECK(eventbus_conflate(bus, event_type(1, 1)) == 0);
+  CHECK(eventbus_conflate(bus, event_type(1, 1)) == 0); // повторне ввімкнення не помилка
+  CHECK(eventbus_conflate(bus, event_type(0, 1)) == -1);
+  eventbus_subscribe(bus, event_type(2, 1), 0, NULL, gate_callback);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, record_callback);
+
+  gate_close(bus);
+  // Теми не займають слотів черги: публікацій набагато більше, ніж queue_size
+  EventRequest *replaced = eventbus_request(bus, event_type(1, 1), value_input(0), create_event_result());
+  CHECK(replaced != NULL);
+  for (uint32_t i = 1; i <= 1000; i++)
+    CHECK(eventbus_publish(bus, event_type(1, 1), value_input(i), create_event_result()) == 0);
+  // Запит заміненого значення завершується як викинутий
+  if (replaced)
+  {
+    CHECK(eventbus_request_poll(replaced) == event_request_dropped);
+    eventbus_request_release(bus, replaced);
+  }
+
+  // Повільний підписник отримує одразу найсвіжіше значення, а проміжні пропускаються
+  atomic_store(&gate_open, true);
+  WAIT_UNTIL(atomic_load(&received) == 1);
+  CHECK(atomic_load(&last_value) == 1000);
+
+  // Наступне значення надходить звичайним шляхом
+  CHECK(eventbus_publish(bus, event_type(1, 1), value_input(1001), create_event_result()) == 0);
+  WAIT_UNTIL(atomic_load(&received) == 2);
+  CHECK(atomic_load(&last_value) == 1001);
+
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static void test_topic_limit(void)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.topic_count = 2;
+  EventBus *bus = eventbus_create(cfg);
+  CHECK(bus != NULL);
+  CHECK(eventbus_conflate(bus, event_type(1, 1)) == 0);
+  CHECK(eventbus_conflate(bus, event_type(1, 2)) == 0);
+  CHECK(eventbus_conflate(bus, event_type(1, 3)) == -1);
+  eventbus_stop(bus);
+  free(bus);
+}
+
+int main(void)
+{
+  RUN_TEST(test_latest);
+  RUN_TEST(test_topic_limit);
+  return test_result();
+}
@@ -0,0 +1,119 @@
+/**
+ * @file test_dispatch.c
+ * @brief Тести злиття статичних (EVENTBUS_STATIC_SUBSCRIBER) і динамічних підписників.
+ *
+ * Кожен підписник записує свій номер у журнал викликів; номери 1x – статичні, 2x – динамічні.
+ * Серед підписників одного пріоритету статичні викликаються першими.
+ */
+
+#include "test.h"
+
+#define TEST_LOG 32
+
+static int log_ids[TEST_LOG];
+static EVENTBUS_ATOMIC(int) log_count;
+
+static void log_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  int n = atomic_load(&log_count);
+  if (n < TEST_LOG)
+    log_ids[n] = *(const int *)ctx;
+  atomic_store(&log_count, n + 1);
+}
+
+#if defined(EVENTBUS_STATIC_SUBS_SECTION)
+
+static const int ids[] = {10, 11, 12, 13, 14, 15, 20, 21, 22, 23};
+
+EVENTBUS_STATIC_SUBSCRIBER(1, 1, 1, log_callback, &ids[0]);
+EVENTBUS_STATIC_SUBSCRIBER(1, 1, 0, log_callback, &ids[1]);
+EVENTBUS_STATIC_SUBSCRIBER(1, 0, 1, log_callback, &ids[2]);
+EVENTBUS_STATIC_SUBSCRIBER(0, 0, 2, log_callback, &ids[3]);
+EVENTBUS_STATIC_SUBSCRIBER(1, 2, 0, log_callback, &ids[4]);
+EVENTBUS_STATIC_SUBSCRIBER(1, 1, 1, log_callback, &ids[5]);
+
+static EventBus *bus_create(bool statics)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.static_subscribers = statics;
+  EventBus *bus = eventbus_create(cfg);
+  CHECK(bus != NULL);
+  eventbus_subscribe(bus, event_type(1, 1), 1, (void *)&ids[6], log_callback);
+  eventbus_subscribe(bus, event_type(1, 0), 0, (void *)&ids[7], log_callback);
+  eventbus_subscribe(bus, event_type(0, 0), 1, (void *)&ids[8], log_callback);
+  eventbus_subscribe(bus, event_type(1, 1), 3, (void *)&ids[9], log_callback);
+  return bus;
+}
+
+// Публікує подію і повертає кількість викликів; журнал – у log_ids
+static int dispatch(EventBus *bus, EventType type, int expected)
+{
+  atomic_store(&log_count, 0);
+  CHECK(eventbus_publish(bus, type, create_event_input_data(NULL, 0), create_event_result()) == 0);
+  WAIT_UNTIL(atomic_load(&log_count) >= expected);
+  // Зайвий виклик, якщо він є, надійшов би одразу за очікуваними
+  uint64_t until = EVENTBUS_TIME_MS() + 10;
+  while (EVENTBUS_TIME_MS() < until)
+    sched_yield();
+  return atomic_load(&log_count);
+}
+
+static void check_log(const int *expected, int count)
+{
+  for (int i = 0; i < count; i++)
+    CHECK(log_ids[i] == expected[i]);
+}
+
+// Порядок статичних підписників одного ключа й пріоритету задає секція, тож перевіряється лише набір
+static bool log_has(int from, int to, int id)
+{
+  for (int i = from; i < to; i++)
+    if (log_ids[i] == id)
+      return true;
+  return false;
+}
+
+static void test_merge(void)
+{
+  EventBus *bus = bus_create(true);
+
+  // Точний тип: три записи статичних і три динамічних зливаються за пріоритетом
+  CHECK(dispatch(bus, event_type(1, 1), 9) == 9);
+  check_log((const int[]){11, 21}, 2);
+  CHECK(log_has(2, 5, 10) && log_has(2, 5, 12) && log_has(2, 5, 15));
+  CHECK(log_ids[5] == 20 && log_ids[6] == 22 && log_ids[7] == 13 && log_ids[8] == 23);
+
+  // Інший тип категорії: підписники на 1.1 не викликаються, а підписники на категорію і на всі
+  // події – по одному разу
+  CHECK(dispatch(bus, event_type(1, 2), 5) == 5);
+  check_log((const int[]){14, 21, 12, 22, 13}, 5);
+
+  // Інша категорія: лише підписники на всі події
+  CHECK(dispatch(bus, event_type(2, 1), 2) == 2);
+  check_log((const int[]){22, 13}, 2);
+
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static void test_disabled(void)
+{
+  // Без static_subscribers викликаються лише динамічні підписники
+  EventBus *bus = bus_create(false);
+  CHECK(dispatch(bus, event_type(1, 1), 4) == 4);
+  check_log((const int[]){21, 20, 22, 23}, 4);
+  eventbus_stop(bus);
+  free(bus);
+}
+
+#endif
+
+int main(void)
+{
+#if defined(EVENTBUS_STATIC_SUBS_SECTION)
+  RUN_TEST(test_merge);
+  RUN_TEST(test_disabled);
+#endif
+  return test_result();
+}
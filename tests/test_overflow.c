@@ -0,0 +1,274 @@
+/**
+ * @file test_overflow.c
+ * @brief Тести політик переповнення черги шарда.
+ *
+ * Два шарди й один потік обробки: подія категорії 2 (шард 0) затримує потік у підписнику,
+ * доки тест не відкриє його, а події категорії 1 (шард 1) тим часом заповнюють чергу на
+ * 4 слоти. Шард 1 потоком не захоплений, тож drop_oldest та coalesce діють одразу.
+ * Окремо перевіряються вичерпання бічної таблиці при вільних слотах і підписник, що публікує
+ * у власний захоплений шард.
+ */
+
+#include "test.h"
+#include <pthread.h>
+
+#define TEST_CAPACITY 4
+
+static EVENTBUS_ATOMIC(bool) gate_open;
+static EVENTBUS_ATOMIC(int) gate_entered;
+static EVENTBUS_ATOMIC(int) received;
+static uint32_t values[32];
+
+static void gate_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add(&gate_entered, 1);
+  while (!atomic_load(&gate_open))
+    sched_yield();
+}
+
+static void record_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  int n = atomic_load(&received);
+  if (n < (int)(sizeof(values) / sizeof(values[0])))
+    memcpy(&values[n], evt->input.direct_data, sizeof(values[n]));
+  atomic_store(&received, n + 1);
+}
+
+static EventBusConfig bus_config(EventOverflowPolicy policy)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.queue_size = TEST_CAPACITY;
+  cfg.shard_count = 2;
+  cfg.worker_count = 1;
+  cfg.overflow_policy = policy;
+  cfg.overflow_timeout_ms = 50;
+  cfg.payload_block_size = sizeof(uint32_t);
+  cfg.payload_block_count = TEST_CAPACITY + 1;
+  return cfg;
+}
+
+static EventBus *bus_start(EventBusConfig cfg)
+{
+  EventBus *bus = eventbus_create(cfg);
+  CHECK(bus != NULL);
+  eventbus_subscribe(bus, event_type(2, 1), 0, NULL, gate_callback);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, record_callback);
+  atomic_store(&received, 0);
+  return bus;
+}
+
+static EventBus *bus_create(EventOverflowPolicy policy)
+{
+  return bus_start(bus_config(policy));
+}
+
+// Затримує потік обробки в підписнику події шарда 0
+static void gate_close(EventBus *bus)
+{
+  atomic_store(&gate_open, false);
+  atomic_store(&gate_entered, 0);
+  CHECK(eventbus_publish(bus, event_type(2, 1), create_event_input_data(NULL, 0), create_event_result()) == 0);
+  WAIT_UNTIL(atomic_load(&gate_entered) == 1);
+}
+
+static void bus_destroy(EventBus *bus)
+{
+  atomic_store(&gate_open, true);
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static int publish_value(EventBus *bus, uint16_t id, uint32_t value)
+{
+  return eventbus_publish(bus, event_type(1, id), create_event_input_copy(&value, sizeof(value)), create_event_result());
+}
+
+static void check_values(const uint32_t *expected, int count)
+{
+  atomic_store(&gate_open, true);
+  WAIT_UNTIL(atomic_load(&received) == count);
+  for (int i = 0; i < count; i++)
+    CHECK(values[i] == expected[i]);
+}
+
+static void test_reject(void)
+{
+  EventBus *bus = bus_create(event_overflow_reject);
+  gate_close(bus);
+  for (uint32_t i = 1; i <= TEST_CAPACITY; i++)
+    CHECK(publish_value(bus, 1, i) == 0);
+  CHECK(publish_value(bus, 1, 99) == -1);
+  check_values((const uint32_t[]){1, 2, 3, 4}, 4);
+  bus_destroy(bus);
+}
+
+static void test_timeout(void)
+{
+  EventBus *bus = bus_create(event_overflow_timeout);
+  gate_close(bus);
+  for (uint32_t i = 1; i <= TEST_CAPACITY; i++)
+    CHECK(publish_value(bus, 1, i) == 0);
+  uint64_t start = EVENTBUS_TIME_MS();
+  CHECK(publish_value(bus, 1, 99) == -1);
+  CHECK(EVENTBUS_TIME_MS() - start >= 45);
+  check_values((const uint32_t[]){1, 2, 3, 4}, 4);
+  bus_destroy(bus);
+}
+
+static EVENTBUS_ATOMIC(int) blocked_result = -2;
+
+static void *blocked_publisher(void *arg)
+{
+  atomic_store(&blocked_result, publish_value((EventBus *)arg, 1, 5));
+  return NULL;
+}
+
+static void test_block(void)
+{
+  EventBus *bus = bus_create(event_overflow_block);
+  gate_close(bus);
+  for (uint32_t i = 1; i <= TEST_CAPACITY; i++)
+    CHECK(publish_value(bus, 1, i) == 0);
+
+  // Продюсер чекає, доки потік обробки не звільнить місце
+  pthread_t thread;
+  pthread_create(&thread, NULL, blocked_publisher, bus);
+  uint64_t until = EVENTBUS_TIME_MS() + 50;
+  while (EVENTBUS_TIME_MS() < until)
+    sched_yield();
+  CHECK(atomic_load(&blocked_result) == -2);
+  check_values((const uint32_t[]){1, 2, 3, 4, 5}, 5);
+  pthread_join(thread, NULL);
+  CHECK(atomic_load(&blocked_result) == 0);
+  bus_destroy(bus);
+}
+
+static int publish_payload(EventBus *bus, uint32_t value)
+{
+  uint32_t *payload = (uint32_t *)eventbus_payload_reserve(bus, sizeof(value));
+  if (!payload)
+    return -2;
+  *payload = value;
+  return eventbus_publish(bus, event_type(1, 1), create_event_input_payload(payload, sizeof(value)), create_event_result());
+}
+
+static void test_drop_oldest(void)
+{
+  EventBus *bus = bus_create(event_overflow_drop_oldest);
+  gate_close(bus);
+  // Блоків пулу на один більше, ніж слотів: блок викинутої події має повернутися в пул
+  for (uint32_t i = 1; i <= TEST_CAPACITY + 1; i++)
+    CHECK(publish_payload(bus, i) == 0);
+  CHECK(publish_payload(bus, 6) == 0);
+  CHECK(publish_payload(bus, 7) == 0);
+  check_values((const uint32_t[]){4, 5, 6, 7}, 4);
+  bus_destroy(bus);
+}
+
+static void test_coalesce(void)
+{
+  EventBus *bus = bus_create(event_overflow_coalesce);
+  gate_close(bus);
+  for (uint32_t i = 1; i <= TEST_CAPACITY; i++)
+    CHECK(publish_value(bus, 1, i) == 0);
+  // Найновіша подія того ж типу отримує нові дані й залишається на своєму місці
+  CHECK(publish_value(bus, 1, 5) == 0);
+  CHECK(publish_value(bus, 1, 6) == 0);
+  // Подій іншого типу в черзі немає – публікація відхиляється
+  CHECK(publish_value(bus, 2, 7) == -1);
+  check_values((const uint32_t[]){1, 2, 3, 6}, 4);
+  bus_destroy(bus);
+}
+
+static int done_callback(void *context)
+{
+  (void)context;
+  return 0;
+}
+
+static int publish_ext(EventBus *bus, uint32_t value)
+{
+  EventResultData result = create_event_result();
+  result.done_fn = done_callback; // подія з callback‑функцією займає запис бічної таблиці
+  return eventbus_publish(bus, event_type(1, 1), create_event_input_copy(&value, sizeof(value)), result);
+}
+
+static void ext_exhausted(EventOverflowPolicy policy)
+{
+  EventBusConfig cfg = bus_config(policy);
+  cfg.queue_size = 8;
+  cfg.queue_ext_size = 2;
+  EventBus *bus = bus_start(cfg);
+  gate_close(bus);
+
+  for (uint32_t i = 1; i <= 3; i++)
+    CHECK(publish_value(bus, 1, i) == 0);
+  CHECK(publish_ext(bus, 4) == 0);
+  CHECK(publish_ext(bus, 5) == 0);
+  // Записи бічної таблиці закінчились, а слоти ні: прості події не викидаються й не чекають
+  uint64_t start = EVENTBUS_TIME_MS();
+  CHECK(publish_ext(bus, 6) == -1);
+  if (policy == event_overflow_drop_oldest)
+    CHECK(EVENTBUS_TIME_MS() - start < 45);
+  CHECK(publish_value(bus, 1, 7) == 0);
+  check_values((const uint32_t[]){1, 2, 3, 4, 5, 7}, 6);
+  bus_destroy(bus);
+}
+
+static void test_ext_exhausted(void)
+{
+  ext_exhausted(event_overflow_drop_oldest);
+  ext_exhausted(event_overflow_timeout);
+}
+
+static EVENTBUS_ATOMIC(int) reentrant_published;
+
+// Підписник публікує у власний шард більше подій, ніж уміщує черга
+static void reentrant_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  int published = 0;
+  for (uint32_t i = 0; i < 64; i++)
+    if (eventbus_publish((EventBus *)ctx, event_type(3, 2), create_event_input_copy(&i, sizeof(i)), create_event_result()) == 0)
+      published++;
+  atomic_store(&reentrant_published, published);
+}
+
+static void reentrant_publish(EventOverflowPolicy policy)
+{
+  EventBus *bus = bus_create(policy);
+  atomic_store(&gate_open, true);
+  atomic_store(&reentrant_published, -1);
+  eventbus_subscribe(bus, event_type(3, 1), 0, bus, reentrant_callback);
+  eventbus_subscribe(bus, event_type(3, 2), 0, NULL, record_callback);
+  CHECK(eventbus_publish(bus, event_type(3, 1), create_event_input_data(NULL, 0), create_event_result()) == 0);
+
+  // Шард захоплений самим підписником: публікації не чекають, а вміщуються лише 3 події
+  // (четвертий слот займає подія, яку обробляє підписник)
+  WAIT_UNTIL(atomic_load(&reentrant_published) >= 0);
+  CHECK(atomic_load(&reentrant_published) == (policy == event_overflow_drop_oldest ? 64 : 3));
+  check_values((const uint32_t[]){0, 1, 2}, 3);
+  bus_destroy(bus);
+}
+
+static void test_reentrant(void)
+{
+  // drop_oldest викидає нові події, coalesce їх відхиляє
+  reentrant_publish(event_overflow_drop_oldest);
+  reentrant_publish(event_overflow_coalesce);
+}
+
+int main(void)
+{
+  RUN_TEST(test_reject);
+  RUN_TEST(test_timeout);
+  RUN_TEST(test_block);
+  RUN_TEST(test_drop_oldest);
+  RUN_TEST(test_coalesce);
+  RUN_TEST(test_ext_exhausted);
+  RUN_TEST(test_reentrant);
+  return test_result();
+}
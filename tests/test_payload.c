@@ -0,0 +1,123 @@
+/**
+ * @file test_payload.c
+ * @brief Тести доставки даних подій: у самій події, в блоці malloc і в пулі даних.
+ */
+
+#include "test.h"
+
+static EVENTBUS_ATOMIC(int) received;
+static EventDataStorage last_storage;
+static bool last_callbacks;
+static size_t last_size;
+static char last_data[256];
+
+static void record_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  // Підписник з README: callback‑функції перевіряються до direct_data
+  last_callbacks = evt->input.read_fn != NULL || evt->input.size_fn != NULL;
+  last_storage = evt->input.storage;
+  last_size = evt->input.data_size;
+  if (evt->input.direct_data && evt->input.data_size <= sizeof(last_data))
+    memcpy(last_data, evt->input.direct_data, evt->input.data_size);
+  atomic_fetch_add(&received, 1);
+}
+
+static EventBus *bus_create(void)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.payload_block_size = 128;
+  cfg.payload_block_count = 2;
+  EventBus *bus = eventbus_create(cfg);
+  CHECK(bus != NULL);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, record_callback);
+  return bus;
+}
+
+static void bus_destroy(EventBus *bus)
+{
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static void publish_and_wait(EventBus *bus, EventInputData input)
+{
+  int before = atomic_load(&received);
+  CHECK(eventbus_publish(bus, event_type(1, 1), input, create_event_result()) == 0);
+  WAIT_UNTIL(atomic_load(&received) == before + 1);
+}
+
+static void test_inline(void)
+{
+  EventBus *bus = bus_create();
+
+  // До 8 байтів – у дескрипторі слоту черги
+  publish_and_wait(bus, create_event_input_str("short"));
+  CHECK(last_storage == event_data_inline);
+  CHECK(!last_callbacks);
+  CHECK(last_size == 6 && strcmp(last_data, "short") == 0);
+
+  // До EVENTBUS_INLINE_SIZE – у записі бічної таблиці
+  char text[EVENTBUS_INLINE_SIZE];
+  memset(text, 'x', sizeof(text) - 1);
+  text[sizeof(text) - 1] = '\0';
+  publish_and_wait(bus, create_event_input_copy(text, sizeof(text)));
+  CHECK(last_storage == event_data_inline);
+  CHECK(!last_callbacks);
+  CHECK(last_size == sizeof(text) && strcmp(last_data, text) == 0);
+
+  // Синхронна обробка отримує ті самі дані
+  int before = atomic_load(&received);
+  CHECK(eventbus_publish_sync(bus, event_type(1, 1), create_event_input_str("sync"), create_event_result()) == 0);
+  CHECK(atomic_load(&received) == before + 1);
+  CHECK(last_storage == event_data_inline && strcmp(last_data, "sync") == 0);
+
+  bus_destroy(bus);
+}
+
+static void test_heap(void)
+{
+  EventBus *bus = bus_create();
+  char text[EVENTBUS_INLINE_SIZE * 4];
+  memset(text, 'y', sizeof(text) - 1);
+  text[sizeof(text) - 1] = '\0';
+  publish_and_wait(bus, create_event_input_copy(text, sizeof(text)));
+  CHECK(last_storage == event_data_heap);
+  CHECK(!last_callbacks);
+  CHECK(last_size == sizeof(text) && strcmp(last_data, text) == 0);
+
+  // Копія без даних з ненульовим розміром – помилка виділення пам’яті, її публікація відхиляється
+  CHECK(eventbus_publish(bus, event_type(1, 1), create_event_input_data(NULL, 16), create_event_result()) == -1);
+  CHECK(eventbus_request(bus, event_type(1, 1), create_event_input_data(NULL, 16), create_event_result()) == NULL);
+  bus_destroy(bus);
+}
+
+static void test_pool(void)
+{
+  EventBus *bus = bus_create();
+  CHECK(eventbus_payload_reserve(bus, 129) == NULL);
+  for (int round = 0; round < 4; round++)
+  {
+    // Обидва блоки пулу: після обробки кожен повертається в пул
+    for (int i = 0; i < 2; i++)
+    {
+      char *payload = (char *)eventbus_payload_reserve(bus, 100);
+      CHECK(payload != NULL);
+      if (!payload)
+        break;
+      snprintf(payload, 100, "pool %d %d", round, i);
+      publish_and_wait(bus, create_event_input_payload(payload, strlen(payload) + 1));
+      CHECK(last_storage == event_data_pool);
+      CHECK(strncmp(last_data, "pool ", 5) == 0);
+    }
+  }
+  bus_destroy(bus);
+}
+
+int main(void)
+{
+  RUN_TEST(test_inline);
+  RUN_TEST(test_heap);
+  RUN_TEST(test_pool);
+  return test_result();
+}
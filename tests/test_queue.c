@@ -0,0 +1,261 @@
+/**
+ * @file test_queue.c
+ * @brief Тести lock-free черги: перехід позицій через межу буфера, переповнення, пачки та кілька продюсерів.
+ *
+ * Черга перевіряється напряму через внутрішній інтерфейс eventbus_queue.h. Номер події
+ * передається вказівником direct_data, тож подія вміщується в дескриптор слоту.
+ */
+
+#include "eventbus_queue.h"
+#include "test.h"
+#include <pthread.h>
+
+#define TEST_PRODUCERS 4
+#define TEST_PRODUCER_EVENTS 20000
+
+static Event make_event(uintptr_t seq)
+{
+  Event evt;
+  memset(&evt, 0, sizeof(evt));
+  evt.type = event_type(1, 1);
+  evt.priority = event_priority_normal;
+  evt.input = create_event_input_data((void *)seq, 0);
+  evt.result = create_event_result();
+  return evt;
+}
+
+static uintptr_t pop_seq(EventQueue *q)
+{
+  Event evt;
+  if (eventbus_queue_pop(q, &evt) != 0)
+    return 0;
+  return (uintptr_t)evt.input.direct_data;
+}
+
+static void test_wrap(void)
+{
+  EventQueue q;
+  CHECK(eventbus_queue_init(&q, 4, 0, NULL, NULL) == 0);
+  uintptr_t pushed = 0, popped = 0;
+  // 3 події за раз при місткості 4: позиції проходять межу буфера в різних місцях
+  for (int round = 0; round < 1000; round++)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      Event evt = make_event(++pushed);
+      CHECK(eventbus_queue_push(&q, &evt) == 0);
+    }
+    for (int i = 0; i < 3; i++)
+      CHECK(pop_seq(&q) == ++popped);
+    CHECK(eventbus_queue_empty(&q));
+  }
+  CHECK(pop_seq(&q) == 0);
+  eventbus_queue_free(&q);
+}
+
+static void test_full(void)
+{
+  EventQueue q;
+  CHECK(eventbus_queue_init(&q, 3, 0, NULL, NULL) == 0); // округлюється до 4
+  for (uintptr_t i = 1; i <= 4; i++)
+  {
+    Event evt = make_event(i);
+    CHECK(eventbus_queue_push(&q, &evt) == 0);
+  }
+  Event extra = make_event(5);
+  CHECK(eventbus_queue_full(&q));
+  CHECK(eventbus_queue_depth(&q) == 4);
+  CHECK(eventbus_queue_push(&q, &extra) == EVENTBUS_QUEUE_FULL);
+
+  CHECK(pop_seq(&q) == 1);
+  CHECK(!eventbus_queue_full(&q));
+  CHECK(eventbus_queue_push(&q, &extra) == 0);
+  for (uintptr_t i = 2; i <= 5; i++)
+    CHECK(pop_seq(&q) == i);
+  CHECK(eventbus_queue_empty(&q));
+  eventbus_queue_free(&q);
+}
+
+static void test_batch(void)
+{
+  EventQueue q;
+  CHECK(eventbus_queue_init(&q, 4, 0, NULL, NULL) == 0);
+  Event evts[6];
+  for (uintptr_t i = 0; i < 6; i++)
+    evts[i] = make_event(i + 1);
+  CHECK(eventbus_queue_push_batch(&q, evts, 6) == 4);
+  CHECK(eventbus_queue_push_batch(&q, evts + 4, 2) == 0);
+
+  // Пачка читається без звільнення слотів, доки не викликано consume
+  CHECK(eventbus_queue_ready(&q, 16) == 4);
+  Event evt;
+  eventbus_queue_peek(&q, 2, &evt);
+  CHECK((uintptr_t)evt.input.direct_data == 3);
+  eventbus_queue_consume(&q, 2);
+  CHECK(eventbus_queue_push_batch(&q, evts + 4, 2) == 2);
+  for (uintptr_t i = 3; i <= 6; i++)
+    CHECK(pop_seq(&q) == i);
+  eventbus_queue_free(&q);
+}
+
+static int test_read(void *context, void *buffer, size_t size)
+{
+  (void)context;
+  (void)buffer;
+  (void)size;
+  return 0;
+}
+
+static void test_descriptors(void)
+{
+  EventQueue q;
+  CHECK(eventbus_queue_init(&q, 8, 1, NULL, NULL) == 0); // один запис бічної таблиці
+
+  // Звичайні події описуються самим дескриптором: context без callback‑функцій не займає запис
+  for (uintptr_t i = 1; i <= 3; i++)
+  {
+    Event evt = make_event(i);
+    evt.input.context = &q;
+    CHECK(eventbus_queue_push(&q, &evt) == 0);
+  }
+  Event small = make_event(0);
+  small.input = create_event_input_copy("abc", 4);
+  CHECK(eventbus_queue_push(&q, &small) == 0);
+
+  // Подія з callback‑функцією займає єдиний запис, наступна такої ж не вміщується
+  Event callback = make_event(0);
+  callback.input = create_event_input_callback(test_read, NULL);
+  CHECK(eventbus_queue_push(&q, &callback) == 0);
+  CHECK(eventbus_queue_push(&q, &callback) == EVENTBUS_QUEUE_NO_EXT);
+  // Записи бічної таблиці закінчились, але кільце не переповнене: проста подія вміщується
+  Event plain = make_event(4);
+  CHECK(!eventbus_queue_full(&q));
+  CHECK(!eventbus_queue_fits(&q, &callback) && eventbus_queue_fits(&q, &plain));
+  CHECK(eventbus_queue_push(&q, &plain) == 0);
+
+  Event evt;
+  for (uintptr_t i = 1; i <= 3; i++)
+  {
+    CHECK(eventbus_queue_pop(&q, &evt) == 0);
+    CHECK((uintptr_t)evt.input.direct_data == i && evt.input.context == NULL && evt.input.read_fn == NULL);
+  }
+  CHECK(eventbus_queue_pop(&q, &evt) == 0);
+  CHECK(evt.input.storage == event_data_inline && evt.input.data_size == 4 && memcmp(evt.input.inline_data, "abc", 4) == 0);
+  CHECK(eventbus_queue_pop(&q, &evt) == 0);
+  CHECK(evt.input.read_fn == test_read);
+  CHECK(eventbus_queue_fits(&q, &callback)); // запис повернувся в бічну таблицю
+  CHECK(pop_seq(&q) == 4);
+  eventbus_queue_free(&q);
+}
+
+static void test_growable(void)
+{
+  EventQueue q;
+  EventMemoryBudget budget;
+  budget.limit = 0;
+  atomic_init(&budget.used, 0);
+  CHECK(eventbus_queue_init(&q, 4, 4, &budget, NULL) == 0);
+  size_t initial = atomic_load(&budget.used);
+
+  // Заповнений сегмент закривається, і черга продовжується новим, удвічі більшим
+  for (uintptr_t i = 1; i <= 100; i++)
+  {
+    Event evt = make_event(i);
+    CHECK(eventbus_queue_push(&q, &evt) == 0);
+  }
+  CHECK(eventbus_queue_depth(&q) == 100);
+  size_t grown = atomic_load(&budget.used);
+  CHECK(grown > initial);
+  for (uintptr_t i = 1; i <= 100; i++)
+    CHECK(pop_seq(&q) == i);
+
+  // Прочитані сегменти звільняються, і їх пам’ять повертається в облік
+  CHECK(pop_seq(&q) == 0);
+  CHECK(atomic_load(&budget.used) < grown);
+  eventbus_queue_free(&q);
+  CHECK(atomic_load(&budget.used) == 0);
+}
+
+static void test_growable_limit(void)
+{
+  EventQueue q;
+  EventMemoryBudget budget;
+  budget.limit = 0;
+  atomic_init(&budget.used, 0);
+  CHECK(eventbus_queue_init(&q, 4, 4, &budget, NULL) == 0);
+  // Місця лише на перший сегмент: черга не росте і поводиться як фіксована
+  budget.limit = atomic_load(&budget.used);
+  uintptr_t pushed = 0;
+  Event evt = make_event(pushed + 1);
+  while (eventbus_queue_push(&q, &evt) == 0)
+    evt = make_event(++pushed + 1);
+  CHECK(pushed == 4);
+  CHECK(eventbus_queue_full(&q));
+
+  // Після читання черга знову приймає події, хоча сегмент уже закритий
+  for (uintptr_t i = 1; i <= pushed; i++)
+    CHECK(pop_seq(&q) == i);
+  for (int round = 0; round < 100; round++)
+  {
+    evt = make_event(++pushed);
+    CHECK(eventbus_queue_push(&q, &evt) == 0);
+    CHECK(pop_seq(&q) == pushed);
+  }
+  CHECK(atomic_load(&budget.used) <= budget.limit);
+  eventbus_queue_free(&q);
+}
+
+static EventQueue shared_queue;
+
+static void *producer(void *arg)
+{
+  uintptr_t id = (uintptr_t)arg;
+  for (uintptr_t i = 1; i <= TEST_PRODUCER_EVENTS; i++)
+  {
+    Event evt = make_event(id << 24 | i);
+    while (eventbus_queue_push(&shared_queue, &evt) != 0)
+      sched_yield();
+  }
+  return NULL;
+}
+
+static void test_producers(void)
+{
+  CHECK(eventbus_queue_init(&shared_queue, 8, 0, NULL, NULL) == 0);
+  pthread_t threads[TEST_PRODUCERS];
+  for (uintptr_t i = 0; i < TEST_PRODUCERS; i++)
+    pthread_create(&threads[i], NULL, producer, (void *)i);
+
+  // Події кожного продюсера приходять у порядку публікації, без пропусків
+  uintptr_t last[TEST_PRODUCERS] = {0};
+  for (size_t n = 0; n < (size_t)TEST_PRODUCERS * TEST_PRODUCER_EVENTS;)
+  {
+    uintptr_t seq = pop_seq(&shared_queue);
+    if (seq == 0)
+    {
+      sched_yield();
+      continue;
+    }
+    uintptr_t id = seq >> 24;
+    CHECK(id < TEST_PRODUCERS && (seq & 0xFFFFFF) == last[id] + 1);
+    if (id < TEST_PRODUCERS)
+      last[id] = seq & 0xFFFFFF;
+    n++;
+  }
+  for (size_t i = 0; i < TEST_PRODUCERS; i++)
+    pthread_join(threads[i], NULL);
+  CHECK(eventbus_queue_empty(&shared_queue));
+  eventbus_queue_free(&shared_queue);
+}
+
+int main(void)
+{
+  RUN_TEST(test_wrap);
+  RUN_TEST(test_full);
+  RUN_TEST(test_batch);
+  RUN_TEST(test_descriptors);
+  RUN_TEST(test_growable);
+  RUN_TEST(test_growable_limit);
+  RUN_TEST(test_producers);
+  return test_result();
+}
@@ -0,0 +1,190 @@
+/**
+ * @file test_request.c
+ * @brief Тести запитів eventbus_request: завершення, порядок продовження та викидання при зупинці.
+ *
+ * Один шард і один потік обробки: подія категорії 2 затримує потік у підписнику, доки тест
+ * не відкриє його, тож запит, опублікований після неї, гарантовано чекає в черзі.
+ */
+
+#include "test.h"
+#include <pthread.h>
+
+static EVENTBUS_ATOMIC(bool) gate_open;
+static EVENTBUS_ATOMIC(int) gate_entered;
+
+// Порядок викликів: s – підписник, d – done_fn, t – продовження
+static char trace[16];
+static EVENTBUS_ATOMIC(int) trace_len;
+static EVENTBUS_ATOMIC(int) then_status;
+
+static void trace_add(char c)
+{
+  int n = atomic_load(&trace_len);
+  if (n < (int)sizeof(trace) - 1)
+    trace[n] = c;
+  atomic_store(&trace_len, n + 1);
+}
+
+static void gate_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add(&gate_entered, 1);
+  while (!atomic_load(&gate_open))
+    sched_yield();
+}
+
+static void record_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  trace_add('s');
+}
+
+static int record_done(void *context)
+{
+  (void)context;
+  trace_add('d');
+  return 0;
+}
+
+static void record_then(EventBus *bus, EventRequest *request, void *context)
+{
+  (void)bus;
+  (void)context;
+  trace_add('t');
+  atomic_store(&then_status, (int)eventbus_request_poll(request));
+}
+
+static EventBus *bus_create(void)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.request_count = 2;
+  EventBus *bus = eventbus_create(cfg);
+  CHECK(bus != NULL);
+  eventbus_subscribe(bus, event_type(2, 1), 0, NULL, gate_callback);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, record_callback);
+  eventbus_subscribe(bus, event_type(1, 1), 1, NULL, record_callback);
+  atomic_store(&trace_len, 0);
+  atomic_store(&then_status, -1);
+  return bus;
+}
+
+static void bus_destroy(EventBus *bus)
+{
+  atomic_store(&gate_open, true);
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static void gate_close(EventBus *bus)
+{
+  atomic_store(&gate_open, false);
+  atomic_store(&gate_entered, 0);
+  CHECK(eventbus_publish(bus, event_type(2, 1), create_event_input_data(NULL, 0), create_event_result()) == 0);
+  WAIT_UNTIL(atomic_load(&gate_entered) == 1);
+}
+
+static EventRequest *request(EventBus *bus)
+{
+  EventResultData result = create_event_result();
+  result.done_fn = record_done;
+  return eventbus_request(bus, event_type(1, 1), create_event_input_str("request"), result);
+}
+
+static void test_wait(void)
+{
+  EventBus *bus = bus_create();
+  EventRequest *req = request(bus);
+  CHECK(req != NULL);
+  CHECK(eventbus_request_wait(bus, req, EVENTBUS_WAIT_FOREVER) == event_request_done);
+  CHECK(eventbus_request_poll(req) == event_request_done);
+  // done_fn викликається після всіх підписників і до завершення запиту
+  CHECK(atomic_load(&trace_len) == 3 && memcmp(trace, "ssd", 3) == 0);
+
+  // Продовження завершеного запиту викликається одразу в потоці викликача
+  CHECK(eventbus_request_then(bus, req, record_then, NULL) == 0);
+  CHECK(atomic_load(&trace_len) == 4 && trace[3] == 't');
+  CHECK(atomic_load(&then_status) == event_request_done);
+  CHECK(eventbus_request_then(bus, req, record_then, NULL) == -1);
+  eventbus_request_release(bus, req);
+  bus_destroy(bus);
+}
+
+static void test_then(void)
+{
+  EventBus *bus = bus_create();
+  gate_close(bus);
+  EventRequest *req = request(bus);
+  CHECK(req != NULL);
+  CHECK(eventbus_request_wait(bus, req, 0) == event_request_pending);
+  CHECK(eventbus_request_then(bus, req, record_then, NULL) == 0);
+  // Відпущений до завершення запит усе одно викликає продовження
+  eventbus_request_release(bus, req);
+  CHECK(atomic_load(&trace_len) == 0);
+
+  atomic_store(&gate_open, true);
+  WAIT_UNTIL(atomic_load(&trace_len) == 4);
+  CHECK(memcmp(trace, "ssdt", 4) == 0);
+  CHECK(atomic_load(&then_status) == event_request_done);
+  bus_destroy(bus);
+}
+
+static void test_pool(void)
+{
+  EventBus *bus = bus_create();
+  gate_close(bus);
+  EventRequest *first = request(bus);
+  EventRequest *second = request(bus);
+  CHECK(first != NULL && second != NULL);
+  CHECK(request(bus) == NULL); // пул на request_count об’єктів вичерпано
+  atomic_store(&gate_open, true);
+  CHECK(eventbus_request_wait(bus, first, EVENTBUS_WAIT_FOREVER) == event_request_done);
+  CHECK(eventbus_request_wait(bus, second, EVENTBUS_WAIT_FOREVER) == event_request_done);
+  eventbus_request_release(bus, first);
+  // Об’єкт повертається в пул, коли його відпустили і викликач, і подія
+  EventRequest *third = request(bus);
+  CHECK(third != NULL);
+  if (third)
+  {
+    CHECK(eventbus_request_wait(bus, third, EVENTBUS_WAIT_FOREVER) == event_request_done);
+    eventbus_request_release(bus, third);
+  }
+  eventbus_request_release(bus, second);
+  bus_destroy(bus);
+}
+
+static void *stop_thread(void *arg)
+{
+  eventbus_stop((EventBus *)arg);
+  return NULL;
+}
+
+static void test_stop(void)
+{
+  EventBus *bus = bus_create();
+  gate_close(bus);
+  EventRequest *req = request(bus);
+  CHECK(req != NULL);
+  CHECK(eventbus_request_then(bus, req, record_then, NULL) == 0);
+  eventbus_request_release(bus, req);
+
+  // Потік обробки завершує поточну подію й виходить, а запит, що лишився в черзі, викидається
+  pthread_t thread;
+  pthread_create(&thread, NULL, stop_thread, bus);
+  WAIT_UNTIL(atomic_load(&bus->status) != bus_thread_working);
+  atomic_store(&gate_open, true);
+  pthread_join(thread, NULL);
+  CHECK(atomic_load(&then_status) == event_request_dropped);
+  CHECK(memchr(trace, 's', (size_t)atomic_load(&trace_len)) == NULL);
+  free(bus);
+}
+
+int main(void)
+{
+  RUN_TEST(test_wait);
+  RUN_TEST(test_then);
+  RUN_TEST(test_pool);
+  RUN_TEST(test_stop);
+  return test_result();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file test_retain.c
+ * @brief Тести утримання останніх подій типу та їх повтору новим підписникам (eventbus_retain).
+ */
+
+#include "test.h"
+
+#define TEST_DEPTH 3
+
+typedef struct
+{
+  EVENTBUS_ATOMIC(int) count;
+  uint32_t values[16];
+} Recorder;
+
+static void record_callback(Event *evt, void *ctx)
+{
+  Recorder *rec = (Recorder *)ctx;
+  int n = atomic_load(&rec->count);
+  uint32_t value = 0;
+  if (evt->input.direct_data && evt->input.data_size == sizeof(value))
+    memcpy(&value, evt->input.direct_data, sizeof(value));
+  if (n < (int)(sizeof(rec->values) / sizeof(rec->values[0])))
+    rec->values[n] = value;
+  atomic_store(&rec->count, n + 1);
+}
+
+static void publish_value(EventBus *bus, EventType type, uint32_t value)
+{
+  CHECK(eventbus_publish(bus, type, create_event_input_copy(&value, sizeof(value)), create_event_result()) == 0);
+}
+
+static void check_values(Recorder *rec, const uint32_t *expected, int count)
+{
+  CHECK(atomic_load(&rec->count) == count);
+  for (int i = 0; i < count && i < atomic_load(&rec->count); i++)
+    CHECK(rec->values[i] == expected[i]);
+}
+
+static EventBus *bus_create(void)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.retain_block_size = sizeof(uint32_t);
+  cfg.retain_block_count = TEST_DEPTH + 1;
+  EventBus *bus = eventbus_create(cfg);
+  CHECK(bus != NULL);
+  return bus;
+}
+
+static void test_replay(void)
+{
+  EventBus *bus = bus_create();
+  CHECK(eventbus_retain(bus, event_type(1, 1), TEST_DEPTH) == 0);
+  CHECK(eventbus_retain(bus, event_type(1, 1), TEST_DEPTH) == -1);
+
+  static Recorder early, late, wildcard, other;
+  eventbus_subscribe(bus, event_type(1, 1), 0, &early, record_callback);
+  publish_value(bus, event_type(1, 2), 100); // тип без утримання не повторюється
+  for (uint32_t i = 1; i <= 5; i++)
+    publish_value(bus, event_type(1, 1), i);
+  WAIT_UNTIL(atomic_load(&early.count) == 5); // обидва типи в одному шарді, тож подія 100 вже оброблена
+
+  // Повтор виконується в eventbus_subscribe: після повернення підписник уже отримав
+  // останні TEST_DEPTH подій від найстарішої до найновішої
+  eventbus_subscribe(bus, event_type(1, 1), 0, &late, record_callback);
+  check_values(&late, (const uint32_t[]){3, 4, 5}, 3);
+  eventbus_subscribe(bus, event_type(1, 0), 0, &wildcard, record_callback);
+  check_values(&wildcard, (const uint32_t[]){3, 4, 5}, 3);
+  eventbus_subscribe(bus, event_type(1, 2), 0, &other, record_callback);
+  CHECK(atomic_load(&other.count) == 0);
+
+  // Наступні події надходять звичайним шляхом і вже після повтору
+  publish_value(bus, event_type(1, 1), 6);
+  WAIT_UNTIL(atomic_load(&early.count) == 6 && atomic_load(&late.count) == 4 && atomic_load(&wildcard.count) == 4);
+  check_values(&late, (const uint32_t[]){3, 4, 5, 6}, 4);
+  check_values(&wildcard, (const uint32_t[]){3, 4, 5, 6}, 4);
+  check_values(&early, (const uint32_t[]){1, 2, 3, 4, 5, 6}, 6);
+
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static void test_partial(void)
+{
+  EventBus *bus = bus_create();
+  CHECK(eventbus_retain(bus, event_type(1, 1), TEST_DEPTH) == 0);
+  // У пулі лишився один блок: другий тип на TEST_DEPTH подій не вміщується
+  CHECK(eventbus_retain(bus, event_type(1, 2), TEST_DEPTH) == -1);
+  CHECK(eventbus_retain(bus, event_type(1, 3), 0) == -1);
+
+  static Recorder counter, late;
+  eventbus_subscribe(bus, event_type(1, 1), 0, &counter, record_callback);
+  // Утримується менше подій, ніж depth: повторюються всі
+  publish_value(bus, event_type(1, 1), 7);
+  // Дані, більші за retain_block_size, не утримуються
+  uint64_t large = 8;
+  CHECK(eventbus_publish(bus, event_type(1, 1), create_event_input_copy(&large, sizeof(large)), create_event_result()) == 0);
+  WAIT_UNTIL(atomic_load(&counter.count) == 2);
+  eventbus_subscribe(bus, event_type(1, 1), 0, &late, record_callback);
+  check_values(&late, (const uint32_t[]){7}, 1);
+
+  eventbus_stop(bus);
+  free(bus);
+}
+
+int main(void)
+{
+  RUN_TEST(test_replay);
+  RUN_TEST(test_partial);
+  return test_result();
+}
@@ -0,0 +1,124 @@
+/**
+ * @file test_shm.c
+ * @brief Тести транспорту подій через спільну пам’ять (eventbus_shm_*).
+ *
+ * Один процес відкриває сегмент двічі: перше відображення створює сегмент і публікує,
+ * друге під’єднується до нього й читає в EventBus, як це робив би інший процес.
+ */
+
+#include "test.h"
+#include <unistd.h>
+
+#define TEST_SLOTS 8
+#define TEST_PAYLOAD 256
+#define TEST_EVENT 100
+
+static EVENTBUS_ATOMIC(bool) gate_open;
+static EVENTBUS_ATOMIC(int) received;
+static EVENTBUS_ATOMIC(int) corrupted;
+
+// Байт i події з номером n
+static uint8_t pattern(uint8_t n, size_t i)
+{
+  return (uint8_t)(n * 7u + i);
+}
+
+static void record_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  while (!atomic_load(&gate_open))
+    sched_yield();
+  const uint8_t *data = (const uint8_t *)evt->input.direct_data;
+  if (evt->input.storage != event_data_shm || evt->input.data_size == 0)
+    atomic_fetch_add(&corrupted, 1);
+  else
+    for (size_t i = 1; i < evt->input.data_size; i++)
+      if (data[i] != pattern(data[0], i))
+      {
+        atomic_fetch_add(&corrupted, 1);
+        break;
+      }
+  atomic_fetch_add(&received, 1);
+}
+
+static int publish(EventShm *shm, uint8_t n, size_t size, uint32_t timeout_ms)
+{
+  uint8_t data[TEST_PAYLOAD + 1];
+  data[0] = n;
+  for (size_t i = 1; i < size; i++)
+    data[i] = pattern(n, i);
+  return eventbus_shm_publish(shm, event_type(1, 1), event_priority_normal, data, size, timeout_ms);
+}
+
+static void test_shm(void)
+{
+  char name[64];
+  snprintf(name, sizeof(name), "/eventbus_test_%d", (int)getpid());
+  eventbus_shm_unlink(name);
+
+  EventShm *producer = eventbus_shm_open(name, TEST_SLOTS, TEST_PAYLOAD);
+  CHECK(producer != NULL);
+  // Розміри задає той, хто створив сегмент
+  EventShm *reader = eventbus_shm_open(name, 1, 1);
+  CHECK(reader != NULL);
+  if (!producer || !reader)
+    return;
+
+  EventBus *bus = eventbus_create(eventbus_default_config());
+  CHECK(bus != NULL);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, record_callback);
+  atomic_store(&gate_open, true);
+  CHECK(eventbus_shm_subscribe(reader, bus) == 0);
+  CHECK(eventbus_shm_subscribe(reader, bus) == -1);
+
+  // Дані передаються з одного відображення в інше
+  CHECK(publish(producer, 1, 16, 0) == 0);
+  CHECK(publish(producer, 2, 1, 0) == 0);
+  WAIT_UNTIL(atomic_load(&received) == 2);
+  CHECK(publish(producer, 3, TEST_PAYLOAD + 1, 0) == -1);
+
+  // Дані не розриваються на кінці кільця: подія, що перетнула б його межу, починається з нуля.
+  // Зсуви зростають на 104–112 байтів, тож межу кільця перетинають події з різних позицій
+  int expected = atomic_load(&received);
+  for (uint8_t n = 10; n < 40; n++)
+  {
+    CHECK(publish(producer, n, TEST_EVENT + n % 5, EVENTBUS_WAIT_FOREVER) == 0);
+    expected++;
+    WAIT_UNTIL(atomic_load(&received) == expected);
+  }
+  // Подія на все кільце вміщується, коли читач звільнив попередні
+  CHECK(publish(producer, 50, TEST_PAYLOAD, EVENTBUS_WAIT_FOREVER) == 0);
+  expected++;
+  WAIT_UNTIL(atomic_load(&received) == expected);
+
+  // Повільний підписник тримає дані в сегменті: продюсер не отримує місця, поки їх не звільнено
+  atomic_store(&gate_open, false);
+  int published = 0;
+  for (uint8_t n = 60; n < 60 + TEST_SLOTS && publish(producer, n, TEST_EVENT, 0) == 0; n++)
+    published++;
+  CHECK(published == TEST_PAYLOAD / TEST_EVENT);
+  uint64_t start = EVENTBUS_TIME_MS();
+  CHECK(publish(producer, 70, TEST_EVENT, 30) == -1);
+  CHECK(EVENTBUS_TIME_MS() - start >= 25);
+  atomic_store(&gate_open, true);
+  expected += published;
+  CHECK(publish(producer, 71, TEST_EVENT, EVENTBUS_WAIT_FOREVER) == 0);
+  expected++;
+  WAIT_UNTIL(atomic_load(&received) == expected);
+  CHECK(atomic_load(&corrupted) == 0);
+
+  // Закриття читача чекає, поки EventBus звільнить дані; сегмент живе до unlink
+  eventbus_shm_close(reader);
+  CHECK(publish(producer, 80, TEST_EVENT, 0) == 0);
+  eventbus_stop(bus);
+  free(bus);
+  eventbus_shm_close(producer);
+  CHECK(eventbus_shm_unlink(name) == 0);
+  CHECK(eventbus_shm_unlink(name) == -1);
+}
+
+int main(void)
+{
+  RUN_TEST(test_shm);
+  return test_result();
+}
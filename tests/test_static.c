@@ -0,0 +1,95 @@
+/**
+ * @file test_static.c
+ * @brief Тести розміщення EventBus у пам’яті викликача (eventbus_init_static).
+ *
+ * Буфер розміром EVENTBUS_STATIC_SIZE для конфігурації за замовчуванням; у програмі один
+ * статичний підписник, тож його індекс теж має вміститися в буфер.
+ */
+
+#include "test.h"
+
+#define TEST_QUEUE 10
+#define TEST_SUBS 20
+#define TEST_STATIC_SUBS 1
+
+static EVENTBUS_ATOMIC(int) dynamic_calls;
+static EVENTBUS_ATOMIC(int) static_calls;
+
+static void dynamic_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add(&dynamic_calls, 1);
+}
+
+#if defined(EVENTBUS_STATIC_SUBS_SECTION)
+static void static_callback(Event *evt, void *ctx)
+{
+  (void)evt;
+  (void)ctx;
+  atomic_fetch_add(&static_calls, 1);
+}
+
+EVENTBUS_STATIC_SUBSCRIBER(1, 1, 0, static_callback, NULL);
+#define TEST_STATIC_CALLS 1
+#else
+#define TEST_STATIC_CALLS 0
+#endif
+
+static uint8_t storage[EVENTBUS_STATIC_SIZE(TEST_QUEUE, 0, 1, 1, 1, TEST_SUBS, TEST_STATIC_SUBS, 0)];
+
+static EventBusConfig static_config(void)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  CHECK(cfg.queue_size == TEST_QUEUE && cfg.subs_array_size == TEST_SUBS);
+  CHECK(cfg.topic_count == EVENTBUS_DEFAULT_TOPICS && cfg.request_count == EVENTBUS_DEFAULT_REQUESTS);
+  return cfg;
+}
+
+static void test_size(void)
+{
+  EventBusConfig cfg = static_config();
+  // Розмір на етапі компіляції збігається з розміром для конфігурації за замовчуванням
+  if (TEST_STATIC_CALLS)
+    CHECK(eventbus_static_size(&cfg) == sizeof(storage));
+  else
+    CHECK(eventbus_static_size(&cfg) <= sizeof(storage));
+
+  cfg.static_subscribers = false;
+  CHECK(eventbus_static_size(&cfg) == EVENTBUS_STATIC_SIZE(TEST_QUEUE, 0, 1, 1, 1, TEST_SUBS, 0, 0));
+}
+
+static void test_init(void)
+{
+  EventBusConfig cfg = static_config();
+  static EventBus bus;
+  // Половини пам’яті не вистачає: ініціалізація відмовляє, а не пише за межі storage
+  CHECK(eventbus_init_static(&bus, &cfg, storage + 1, sizeof(storage) / 2) == -1);
+  CHECK(eventbus_init_static(&bus, &cfg, storage, sizeof(storage)) == 0);
+
+  atomic_store(&dynamic_calls, 0);
+  atomic_store(&static_calls, 0);
+  CHECK(eventbus_subscribe(&bus, event_type(1, 1), 1, NULL, dynamic_callback) != NULL);
+  CHECK(eventbus_publish(&bus, event_type(1, 1), create_event_input_str("static"), create_event_result()) == 0);
+  EventRequest *req = eventbus_request(&bus, event_type(1, 1), create_event_input_data(NULL, 0), create_event_result());
+  CHECK(req != NULL);
+  if (req)
+  {
+    CHECK(eventbus_request_wait(&bus, req, EVENTBUS_WAIT_FOREVER) == event_request_done);
+    eventbus_request_release(&bus, req);
+  }
+  WAIT_UNTIL(atomic_load(&dynamic_calls) == 2);
+  CHECK(atomic_load(&static_calls) == 2 * TEST_STATIC_CALLS);
+  eventbus_stop(&bus);
+
+  // growable у пам’яті викликача не підтримується
+  cfg.growable = true;
+  CHECK(eventbus_init_static(&bus, &cfg, storage, sizeof(storage)) == -1);
+}
+
+int main(void)
+{
+  RUN_TEST(test_size);
+  RUN_TEST(test_init);
+  return test_result();
+}
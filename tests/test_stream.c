@@ -0,0 +1,279 @@
+/**
+ * @file test_stream.c
+ * @brief Тести потокових подій: передача шматків кільком підписникам, утримання шматків,
+ *        помилки запису результату та читання джерела.
+ *
+ * Два підписники з різними пріоритетами; перший записує отримані дані в результат події
+ * через eventbus_stream_write.
+ */
+
+#include "test.h"
+
+#define TEST_CHUNK 16
+#define TEST_LOG 16
+
+typedef struct
+{
+  EVENTBUS_ATOMIC(size_t) offset;
+  size_t size;
+  size_t fail_at; /**< Зсув, на якому read_fn повертає помилку; SIZE_MAX – не повертає */
+} Source;
+
+static int source_read(void *context, void *buffer, size_t size)
+{
+  Source *src = (Source *)context;
+  size_t offset = atomic_load(&src->offset);
+  if (offset >= src->fail_at)
+    return -1;
+  size_t n = src->size - offset < size ? src->size - offset : size;
+  for (size_t i = 0; i < n; i++)
+    ((uint8_t *)buffer)[i] = (uint8_t)(offset + i);
+  atomic_store(&src->offset, offset + n);
+  return (int)n;
+}
+
+static void source_init(Source *src, size_t size)
+{
+  atomic_store(&src->offset, 0);
+  src->size = size;
+  src->fail_at = SIZE_MAX;
+}
+
+// Шматок, як його побачив підписник
+typedef struct
+{
+  size_t offset;
+  size_t size;
+  bool last;
+  bool failed;
+} ChunkInfo;
+
+typedef struct
+{
+  EVENTBUS_ATOMIC(int) count;
+  ChunkInfo chunks[TEST_LOG];
+  int corrupted;
+} Recorder;
+
+static Recorder first, second;
+// Порядок викликів: 1 – перший підписник, 2 – другий
+static int order[2 * TEST_LOG];
+static EVENTBUS_ATOMIC(int) order_count;
+
+static void record(Recorder *rec, int id, Event *evt)
+{
+  int n = atomic_load(&rec->count);
+  if (n < TEST_LOG)
+  {
+    ChunkInfo *info = &rec->chunks[n];
+    info->offset = evt->chunk->offset;
+    info->size = evt->chunk->size;
+    info->last = evt->chunk->last;
+    info->failed = evt->chunk->failed;
+  }
+  for (size_t i = 0; i < evt->input.data_size; i++)
+    if (((const uint8_t *)evt->input.direct_data)[i] != (uint8_t)(evt->chunk->offset + i))
+      rec->corrupted++;
+  int o = atomic_load(&order_count);
+  if (o < 2 * TEST_LOG)
+    order[o] = id;
+  atomic_store(&order_count, o + 1);
+  atomic_store(&rec->count, n + 1);
+}
+
+static void first_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  record(&first, 1, evt);
+  if (evt->input.data_size)
+    eventbus_stream_write(evt, evt->input.direct_data, evt->input.data_size);
+}
+
+static void second_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  record(&second, 2, evt);
+}
+
+typedef struct
+{
+  uint8_t data[256];
+  size_t size;
+  size_t fail_at; /**< Після скількох байтів write_fn повертає помилку; SIZE_MAX – не повертає */
+} Output;
+
+static int output_write(void *context, void *buffer, size_t size)
+{
+  Output *out = (Output *)context;
+  if (out->size + size > out->fail_at || out->size + size > sizeof(out->data))
+    return -1;
+  memcpy(out->data + out->size, buffer, size);
+  out->size += size;
+  return (int)size;
+}
+
+static EventBus *bus_create(uint8_t chunks)
+{
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.stream_chunk_size = TEST_CHUNK;
+  cfg.stream_chunk_count = chunks;
+  EventBus *bus = eventbus_create(cfg);
+  CHECK(bus != NULL);
+  eventbus_subscribe(bus, event_type(1, 1), 1, NULL, second_callback);
+  eventbus_subscribe(bus, event_type(1, 1), 0, NULL, first_callback);
+  memset(&first, 0, sizeof(first));
+  memset(&second, 0, sizeof(second));
+  atomic_store(&order_count, 0);
+  return bus;
+}
+
+// Публікує потік із записом результату в out і повертає стан запиту
+static EventRequestStatus stream_request(EventBus *bus, Source *src, Output *out)
+{
+  EventResultData result = create_event_result();
+  result.write_fn = output_write;
+  result.context = out;
+  EventRequest *req = eventbus_request(bus, event_type(1, 1), create_event_input_stream(source_read, src), result);
+  CHECK(req != NULL);
+  if (!req)
+    return event_request_dropped;
+  EventRequestStatus status = eventbus_request_wait(bus, req, TEST_TIMEOUT_MS);
+  eventbus_request_release(bus, req);
+  return status;
+}
+
+// Обидва підписники бачили count шматків з даними по TEST_CHUNK байтів (останній – tail) і завершальний
+static void check_chunks(Recorder *rec, int count, size_t tail, bool failed)
+{
+  CHECK(atomic_load(&rec->count) == count + 1);
+  CHECK(rec->corrupted == 0);
+  for (int i = 0; i < count && i < TEST_LOG; i++)
+  {
+    size_t size = i == count - 1 && tail ? tail : TEST_CHUNK;
+    CHECK(rec->chunks[i].offset == (size_t)i * TEST_CHUNK && rec->chunks[i].size == size);
+    CHECK(!rec->chunks[i].last && !rec->chunks[i].failed);
+  }
+  if (count < TEST_LOG)
+  {
+    ChunkInfo *end = &rec->chunks[count];
+    CHECK(end->last && end->size == 0 && end->failed == failed);
+    CHECK(end->offset == (size_t)(count - 1) * TEST_CHUNK + (tail ? tail : TEST_CHUNK));
+  }
+}
+
+static void test_fanout(void)
+{
+  // Пул на 2 шматки, а шматків 5: пам’ять повертається після кожного
+  EventBus *bus = bus_create(2);
+  static Source src;
+  static Output out;
+  source_init(&src, 4 * TEST_CHUNK + 5);
+  memset(&out, 0, sizeof(out));
+  out.fail_at = SIZE_MAX;
+  CHECK(stream_request(bus, &src, &out) == event_request_done);
+
+  check_chunks(&first, 5, 5, false);
+  check_chunks(&second, 5, 5, false);
+  // Наступний шматок читається лише після того, як його отримали всі підписники, за пріоритетом
+  CHECK(atomic_load(&order_count) == 12);
+  for (int i = 0; i < 12; i++)
+    CHECK(order[i] == 1 + i % 2);
+
+  // Результат, записаний першим підписником, – усі дані потоку
+  CHECK(out.size == src.size);
+  for (size_t i = 0; i < out.size; i++)
+    CHECK(out.data[i] == (uint8_t)i);
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static EventStreamChunk *held[TEST_LOG];
+static EVENTBUS_ATOMIC(int) held_count;
+
+static void retain_callback(Event *evt, void *ctx)
+{
+  (void)ctx;
+  EventStreamChunk *chunk = eventbus_stream_retain(evt);
+  if (!chunk)
+    return;
+  int n = atomic_load(&held_count);
+  if (n < TEST_LOG)
+    held[n] = chunk;
+  atomic_store(&held_count, n + 1);
+}
+
+static void test_retain(void)
+{
+  EventBus *bus = bus_create(3);
+  atomic_store(&held_count, 0);
+  eventbus_subscribe(bus, event_type(1, 1), 2, NULL, retain_callback);
+  static Source src;
+  source_init(&src, 6 * TEST_CHUNK);
+  CHECK(eventbus_publish(bus, event_type(1, 1), create_event_input_stream(source_read, &src), create_event_result()) == 0);
+
+  // Усі шматки пулу утримуються: джерело не читається далі, поки споживач не відпустить шматок
+  WAIT_UNTIL(atomic_load(&held_count) == 3);
+  uint64_t until = EVENTBUS_TIME_MS() + 30;
+  while (EVENTBUS_TIME_MS() < until)
+    sched_yield();
+  CHECK(atomic_load(&src.offset) == 3 * TEST_CHUNK);
+  CHECK(atomic_load(&second.count) == 3);
+
+  // Утримані шматки не змінюються, поки обробка йде далі
+  for (int i = 0; i < 6; i++)
+  {
+    WAIT_UNTIL(atomic_load(&held_count) > i);
+    if (atomic_load(&held_count) <= i)
+      break;
+    EventStreamChunk *chunk = held[i];
+    CHECK(chunk->offset == (size_t)i * TEST_CHUNK && chunk->size == TEST_CHUNK);
+    for (size_t j = 0; j < chunk->size; j++)
+      CHECK(chunk->data[j] == (uint8_t)(chunk->offset + j));
+    eventbus_stream_release(bus, chunk);
+  }
+  WAIT_UNTIL(atomic_load(&second.count) == 7);
+  check_chunks(&second, 6, 0, false);
+  eventbus_stop(bus);
+  free(bus);
+}
+
+static void test_errors(void)
+{
+  static Source src;
+  static Output out;
+
+  // write_fn повертає помилку на другому шматку: джерело більше не читається, але шматок
+  // отримують усі підписники, а потім завершальний з failed
+  EventBus *bus = bus_create(2);
+  source_init(&src, 5 * TEST_CHUNK);
+  memset(&out, 0, sizeof(out));
+  out.fail_at = TEST_CHUNK + 1;
+  CHECK(stream_request(bus, &src, &out) == event_request_dropped);
+  check_chunks(&first, 2, 0, true);
+  check_chunks(&second, 2, 0, true);
+  CHECK(atomic_load(&src.offset) == 2 * TEST_CHUNK);
+  CHECK(out.size == TEST_CHUNK);
+  eventbus_stop(bus);
+  free(bus);
+
+  // read_fn повертає помилку після третього шматка
+  bus = bus_create(2);
+  source_init(&src, 5 * TEST_CHUNK);
+  src.fail_at = 3 * TEST_CHUNK;
+  memset(&out, 0, sizeof(out));
+  out.fail_at = SIZE_MAX;
+  CHECK(stream_request(bus, &src, &out) == event_request_dropped);
+  check_chunks(&first, 3, 0, true);
+  check_chunks(&second, 3, 0, true);
+  CHECK(out.size == 3 * TEST_CHUNK);
+  eventbus_stop(bus);
+  free(bus);
+}
+
+int main(void)
+{
+  RUN_TEST(test_fanout);
+  RUN_TEST(test_retain);
+  RUN_TEST(test_errors);
+  return test_result();
+}
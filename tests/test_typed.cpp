@@ -0,0 +1,119 @@
+/**
+ * @file test_typed.cpp
+ * @brief Тести типізованої обгортки eventbus.hpp: вибір місця даних і види підписників.
+ */
+
+#include "eventbus.hpp"
+#include "test.h"
+
+#include <atomic>
+#include <cstring>
+
+struct Small
+{
+  uint32_t value;
+};
+
+struct Large
+{
+  uint32_t value;
+  char text[120];
+};
+
+EVENTBUS_EVENT(Small, 1, 1);
+EVENTBUS_EVENT(Large, 1, 2);
+
+static std::atomic<int> small_count{0};
+static std::atomic<uint32_t> small_sum{0};
+static std::atomic<int> large_count{0};
+static std::atomic<int> raw_count{0};
+static std::atomic<EventDataStorage> large_storage{event_data_inline};
+
+static void on_small(const Small &evt)
+{
+  small_count++;
+  small_sum += evt.value;
+}
+
+// Підписник на сирі події: місце даних обгортка обирає сама
+static void on_large_raw(Event *evt, void *)
+{
+  large_storage = evt->input.storage;
+  raw_count++;
+}
+
+static void test_subscribers()
+{
+  EventBusConfig cfg = eventbus_default_config();
+  EventBus *raw = eventbus_create(cfg);
+  CHECK(raw != nullptr);
+  eventbus::Bus bus(raw);
+
+  std::atomic<int> captured{0};
+  {
+    auto stateless = bus.subscribe<Small>([](const Small &evt) { small_sum += evt.value * 100; });
+    auto function = bus.subscribe<Small>(on_small);
+    auto stateful = bus.subscribe<Small>([&captured](const Small &evt) { captured += (int)evt.value; });
+    CHECK(stateless && function && stateful);
+
+    CHECK(bus.publish(Small{3}) == 0);
+    WAIT_UNTIL(small_count.load() == 1 && captured == 3 && small_sum.load() == 303);
+  }
+
+  // Знищені Subscription відписалися: після зупинки жоден callback уже не викликається
+  CHECK(bus.publish(Small{5}) == 0);
+  eventbus_stop(raw);
+  CHECK(small_count.load() == 1 && captured == 3 && small_sum.load() == 303);
+  free(raw);
+}
+
+static void test_storage()
+{
+  static_assert(eventbus::detail::fits_inline<Small>, "Small вміщується в подію");
+  static_assert(!eventbus::detail::fits_inline<Large>, "Large не вміщується в подію");
+
+  EventBusConfig cfg = eventbus_default_config();
+  cfg.payload_block_size = sizeof(Large);
+  cfg.payload_block_count = 1;
+  EventBus *raw = eventbus_create(cfg);
+  CHECK(raw != nullptr);
+  eventbus::Bus bus(raw);
+
+  auto typed = bus.subscribe<Large>([](const Large &evt) {
+    if (evt.value == std::strlen(evt.text))
+      large_count++;
+  });
+  eventbus_subscribe(raw, eventbus::event_traits<Large>::type, 1, nullptr, on_large_raw);
+
+  Large evt = {};
+  std::strcpy(evt.text, "pool");
+  evt.value = 4;
+  CHECK(bus.publish(evt) == 0);
+  WAIT_UNTIL(large_count.load() == 1 && raw_count.load() == 1);
+  CHECK(large_storage.load() == event_data_pool);
+
+  // Єдиний блок пулу зайнятий: дані переміщуються в блок malloc
+  // Блок повертається в пул після останнього підписника
+  void *held = nullptr;
+  uint64_t deadline = EVENTBUS_TIME_MS() + TEST_TIMEOUT_MS;
+  while (!(held = eventbus_payload_reserve(raw, sizeof(Large))) && EVENTBUS_TIME_MS() < deadline)
+    sched_yield();
+  CHECK(held != nullptr);
+  std::strcpy(evt.text, "heap!");
+  evt.value = 5;
+  CHECK(bus.publish(evt) == 0);
+  WAIT_UNTIL(large_count.load() == 2 && raw_count.load() == 2);
+  CHECK(large_storage.load() == event_data_heap);
+  eventbus_payload_release(raw, held);
+
+  typed.reset();
+  eventbus_stop(raw);
+  free(raw);
+}
+
+int main()
+{
+  RUN_TEST(test_subscribers);
+  RUN_TEST(test_storage);
+  return test_result();
+}